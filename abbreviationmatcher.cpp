@@ -0,0 +1,218 @@
+#include "abbreviationmatcher.h"
+
+#include <QVarLengthArray>
+#include <QtAlgorithms>
+#include <cstring>
+
+namespace {
+
+inline bool isWordStart(const QString& text, int pos)
+{
+    return pos == 0 || text.at(pos - 1) == QLatin1Char('_') || text.at(pos - 1) == QLatin1Char(' ');
+}
+
+inline bool isCamelStart(const QString& text, int pos)
+{
+    return pos > 0 && text.at(pos - 1).isLower() && text.at(pos).isUpper();
+}
+
+inline ushort foldAscii(ushort c)
+{
+    return (c >= 'A' && c <= 'Z') ? ushort(c + ('a' - 'A')) : c;
+}
+
+} // namespace
+
+// 字母 0-25、数字 26-35、其余 ASCII 散列到 36-62、非 ASCII 共用 63；只用于排除，冲突只会少排除
+quint64 AbbreviationMatcher::letterBit(ushort c)
+{
+    if (c >= 'a' && c <= 'z') {
+        return quint64(1) << (c - 'a');
+    }
+    if (c >= '0' && c <= '9') {
+        return quint64(1) << (26 + c - '0');
+    }
+    if (c < 0x80) {
+        return quint64(1) << (36 + c % 27);
+    }
+    return quint64(1) << 63;
+}
+
+AbbreviationMatcher::Signature AbbreviationMatcher::signatureOf(const QString& text)
+{
+    Signature signature;
+    signature.length = text.size();
+    signature.folded.resize(text.size());
+
+    const QChar* chars = text.constData();
+    char* folded = signature.folded.data();
+    for (int i = 0; i < text.size(); ++i) {
+        const ushort c = chars[i].unicode();
+        if (c >= 0x80) {
+            signature.ascii = false;
+        }
+
+        const ushort lower = c < 0x80 ? foldAscii(c) : chars[i].toLower().unicode();
+        folded[i] = char(lower);
+        signature.letters |= letterBit(lower);
+
+        if (i < 64) {
+            if (isWordStart(text, i)) {
+                signature.wordStarts |= quint64(1) << i;
+            }
+            if (isCamelStart(text, i)) {
+                signature.camelStarts |= quint64(1) << i;
+            }
+        }
+    }
+
+    if (!signature.ascii) {
+        signature.folded.clear();
+    }
+    return signature;
+}
+
+AbbreviationMatcher::Query AbbreviationMatcher::queryOf(const QString& abbreviation)
+{
+    Query query;
+    query.length = abbreviation.size();
+    query.lowered = abbreviation.toLower();
+    query.folded.resize(abbreviation.size());
+
+    for (int i = 0; i < query.lowered.size(); ++i) {
+        const ushort c = query.lowered.at(i).unicode();
+        if (c >= 0x80) {
+            query.ascii = false;
+        }
+        query.folded[i] = char(c);
+        query.letters |= letterBit(c);
+    }
+
+    if (!query.ascii) {
+        query.folded.clear();
+    }
+    return query;
+}
+
+// 贪心地为每个缩写字符找最左的位置；ASCII 路径用 memchr(库实现为向量化)跳到下一次出现
+int AbbreviationMatcher::greedyPositions(const QString& text, const Signature& signature, const Query& query,
+                                         int* positions)
+{
+    if (signature.ascii && query.ascii) {
+        const char* haystack = signature.folded.constData();
+        const char* needles = query.folded.constData();
+        int from = 0;
+        for (int i = 0; i < query.length; ++i) {
+            const void* hit = std::memchr(haystack + from, needles[i], size_t(signature.length - from));
+            if (!hit) {
+                return 0;
+            }
+            positions[i] = int(static_cast<const char*>(hit) - haystack);
+            from = positions[i] + 1;
+        }
+        return query.length;
+    }
+
+    const QString lowered = text.toLower();
+    int from = 0;
+    for (int i = 0; i < query.length; ++i) {
+        while (from < lowered.size() && lowered.at(from) != query.lowered.at(i)) {
+            ++from;
+        }
+        if (from == lowered.size()) {
+            return 0;
+        }
+        positions[i] = from++;
+    }
+    return query.length;
+}
+
+bool AbbreviationMatcher::matches(const QString& text, const Signature& signature, const Query& query)
+{
+    // 前缀必然也是子序列，只需一次贪心定位
+    if (!mayMatch(signature, query)) {
+        return false;
+    }
+    QVarLengthArray<int, 64> found(query.length);
+    return greedyPositions(text, signature, query, found.data()) == query.length;
+}
+
+int AbbreviationMatcher::score(const QString& text, const Signature& signature, const Query& query)
+{
+    // 缺字符或比候选长时，精确/前缀/包含/缩写都不可能成立
+    if (!mayMatch(signature, query)) {
+        return 0;
+    }
+
+    const int length = signature.length;
+    if (signature.ascii && query.ascii) {
+        if (std::memcmp(signature.folded.constData(), query.folded.constData(), size_t(query.length)) == 0) {
+            return query.length == length ? 1000 : 800 + (100 - query.length);
+        }
+        if (signature.folded.indexOf(query.folded) >= 0) {
+            return 400 + (100 - length);
+        }
+    } else {
+        const QString lowered = text.toLower();
+        if (lowered.startsWith(query.lowered)) {
+            return query.length == length ? 1000 : 800 + (100 - query.length);
+        }
+        if (lowered.contains(query.lowered)) {
+            return 400 + (100 - length);
+        }
+    }
+
+    QVarLengthArray<int, 64> found(query.length);
+    if (greedyPositions(text, signature, query, found.data()) != query.length) {
+        return 0;
+    }
+
+    // 前64个字符：命中位图与边界位图求交计数，相邻命中即 matched & (matched << 1)
+    quint64 matched = 0;
+    int boundaries = 0;
+    int consecutive = 0;
+    for (int i = 0; i < query.length; ++i) {
+        const int pos = found[i];
+        if (pos < 64) {
+            matched |= quint64(1) << pos;
+            continue;
+        }
+        boundaries += int(isWordStart(text, pos)) + int(isCamelStart(text, pos));
+        if (i > 0 && found[i - 1] == pos - 1) {
+            ++consecutive;
+        }
+    }
+    boundaries += int(qPopulationCount(matched & signature.wordStarts)) +
+                  int(qPopulationCount(matched & signature.camelStarts));
+    consecutive += int(qPopulationCount(matched & (matched << 1)));
+
+    // 单词边界奖励、较短文本奖励、连续字符奖励
+    return 500 + boundaries * 50 - length + consecutive * 10;
+}
+
+QList<int> AbbreviationMatcher::positions(const QString& text, const Signature& signature, const Query& query)
+{
+    QList<int> result;
+    if (!mayMatch(signature, query)) {
+        return result;
+    }
+
+    QVarLengthArray<int, 64> found(query.length);
+    if (greedyPositions(text, signature, query, found.data()) == query.length) {
+        result.reserve(query.length);
+        for (int pos : found) {
+            result.append(pos);
+        }
+    }
+    return result;
+}
+
+bool AbbreviationMatcher::matches(const QString& text, const QString& abbreviation)
+{
+    return matches(text, signatureOf(text), queryOf(abbreviation));
+}
+
+int AbbreviationMatcher::score(const QString& text, const QString& abbreviation)
+{
+    return score(text, signatureOf(text), queryOf(abbreviation));
+}
@@ -0,0 +1,229 @@
+#include "atomtable.h"
+
+#include <cstring>
+
+const AtomTable::Atom AtomTable::EmptyAtom;
+const AtomTable::Atom AtomTable::NoAtom;
+
+// 线程池中的解析任务可能最先调用，局部静态变量由编译器保证只初始化一次(C++11)
+AtomTable* AtomTable::getInstance()
+{
+    static AtomTable table;
+    return &table;
+}
+
+AtomTable::AtomTable()
+{
+    rehash(1024);
+
+    // 原子 0 = 空串
+    QByteArray unused;
+    append(makeKey(QString(), unused));
+}
+
+AtomTable::Key AtomTable::makeKey(const QString& text, QByteArray& utf8Buffer)
+{
+    Key key;
+    const QChar* data = text.constData();
+    const int size = text.size();
+
+    bool latin1 = true;
+    for (int i = 0; i < size; ++i) {
+        if (data[i].unicode() > 0xFF) {
+            latin1 = false;
+            break;
+        }
+    }
+
+    // FNV-1a，Latin-1 与 UTF-8 两种键都按字节计算
+    quint32 hash = 2166136261u;
+    if (latin1) {
+        key.chars = data;
+        key.size = size;
+        for (int i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<quint8>(data[i].unicode())) * 16777619u;
+        }
+    } else {
+        utf8Buffer = text.toUtf8();
+        key.bytes = utf8Buffer.constData();
+        key.size = utf8Buffer.size();
+        key.utf8 = true;
+        for (int i = 0; i < key.size; ++i) {
+            hash = (hash ^ static_cast<quint8>(key.bytes[i])) * 16777619u;
+        }
+    }
+    key.hash = hash;
+    return key;
+}
+
+bool AtomTable::matches(const Entry& entry, const Key& key) const
+{
+    if (entry.hash != key.hash || entry.utf8 != key.utf8 || int(entry.size) != key.size) {
+        return false;
+    }
+
+    const char* stored = arena.constData() + entry.offset;
+    if (key.utf8) {
+        return std::memcmp(stored, key.bytes, key.size) == 0;
+    }
+    for (int i = 0; i < key.size; ++i) {
+        if (static_cast<quint8>(stored[i]) != key.chars[i].unicode()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AtomTable::findBucket(const Key& key) const
+{
+    const int mask = buckets.size() - 1;
+    int index = static_cast<int>(key.hash) & mask;
+    while (true) {
+        const quint32 slot = buckets.at(index);
+        if (slot == 0 || matches(entries.at(slot - 1), key)) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+AtomTable::Atom AtomTable::append(const Key& key)
+{
+    Entry entry;
+    entry.offset = static_cast<quint32>(arena.size());
+    entry.size = static_cast<quint32>(key.size);
+    entry.hash = key.hash;
+    entry.utf8 = key.utf8;
+
+    if (key.utf8) {
+        arena.append(key.bytes, key.size);
+    } else {
+        arena.resize(arena.size() + key.size);
+        char* out = arena.data() + entry.offset;
+        for (int i = 0; i < key.size; ++i) {
+            out[i] = static_cast<char>(key.chars[i].unicode());
+        }
+    }
+
+    const Atom atom = static_cast<Atom>(entries.size());
+    entries.append(entry);
+
+    // 负载因子保持在 1/2 以下
+    if (entries.size() * 2 > buckets.size()) {
+        rehash(buckets.size() * 2);
+    } else {
+        buckets[findBucket(key)] = atom + 1;
+    }
+    return atom;
+}
+
+void AtomTable::rehash(int bucketCount)
+{
+    buckets.fill(0, bucketCount);
+
+    const int mask = bucketCount - 1;
+    for (int i = 0; i < entries.size(); ++i) {
+        int index = static_cast<int>(entries.at(i).hash) & mask;
+        while (buckets.at(index) != 0) {
+            index = (index + 1) & mask;
+        }
+        buckets[index] = static_cast<quint32>(i + 1);
+    }
+}
+
+AtomTable::Atom AtomTable::intern(const QString& text)
+{
+    if (text.isEmpty()) {
+        return EmptyAtom;
+    }
+
+    QByteArray utf8Buffer;
+    const Key key = makeKey(text, utf8Buffer);
+
+    {
+        QReadLocker locker(&lock);
+        const quint32 slot = buckets.at(findBucket(key));
+        if (slot != 0) {
+            return slot - 1;
+        }
+    }
+
+    QWriteLocker locker(&lock);
+    // 释放读锁到拿到写锁之间可能已被其他线程插入
+    const quint32 slot = buckets.at(findBucket(key));
+    if (slot != 0) {
+        return slot - 1;
+    }
+    return append(key);
+}
+
+AtomTable::Atom AtomTable::lookup(const QString& text) const
+{
+    if (text.isEmpty()) {
+        return EmptyAtom;
+    }
+
+    QByteArray utf8Buffer;
+    const Key key = makeKey(text, utf8Buffer);
+
+    QReadLocker locker(&lock);
+    const quint32 slot = buckets.at(findBucket(key));
+    return slot != 0 ? slot - 1 : NoAtom;
+}
+
+QString AtomTable::string(Atom atom) const
+{
+    QReadLocker locker(&lock);
+    if (atom >= static_cast<Atom>(entries.size())) {
+        return QString();
+    }
+
+    const Entry& entry = entries.at(atom);
+    const char* data = arena.constData() + entry.offset;
+    return entry.utf8 ? QString::fromUtf8(data, entry.size)
+                      : QString::fromLatin1(data, entry.size);
+}
+
+bool AtomTable::startsWith(Atom atom, const QString& prefix, Qt::CaseSensitivity cs) const
+{
+    QReadLocker locker(&lock);
+    if (atom >= static_cast<Atom>(entries.size())) {
+        return prefix.isEmpty();
+    }
+
+    const Entry& entry = entries.at(atom);
+    const char* data = arena.constData() + entry.offset;
+
+    // UTF-8 条目很少见，物化后比较
+    if (entry.utf8) {
+        return QString::fromUtf8(data, entry.size).startsWith(prefix, cs);
+    }
+
+    const int length = prefix.size();
+    if (length > int(entry.size)) {
+        return false;
+    }
+    for (int i = 0; i < length; ++i) {
+        const uint stored = static_cast<quint8>(data[i]);
+        const uint wanted = prefix.at(i).unicode();
+        if (stored == wanted) {
+            continue;
+        }
+        if (cs == Qt::CaseSensitive || QChar::toCaseFolded(stored) != QChar::toCaseFolded(wanted)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AtomTable::atomCount() const
+{
+    QReadLocker locker(&lock);
+    return entries.size();
+}
+
+int AtomTable::storageBytes() const
+{
+    QReadLocker locker(&lock);
+    return arena.size() + entries.size() * int(sizeof(Entry)) + buckets.size() * int(sizeof(quint32));
+}
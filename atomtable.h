@@ -0,0 +1,68 @@
+#ifndef ATOMTABLE_H
+#define ATOMTABLE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QReadWriteLock>
+
+// 🚀 全局标识符原子表
+// 把标识符/文件路径/模块名映射为32位原子，同一字符串在整个进程中只存一份。
+// 纯 Latin-1 文本按单字节存放，其余文本存 UTF-8；查找时直接与字节区比较，不构造临时 QString。
+// 原子一旦分配就不会回收，原子 0 固定为空串。各子系统的哈希键改用原子后，比较只是整数比较。
+class AtomTable
+{
+public:
+    typedef quint32 Atom;
+    static const Atom EmptyAtom = 0;
+    static const Atom NoAtom = 0xFFFFFFFFu;
+
+    static AtomTable* getInstance();
+
+    Atom intern(const QString& text);
+    Atom lookup(const QString& text) const;    // 只查不插，未登记时返回 NoAtom
+    QString string(Atom atom) const;
+
+    // 🚀 NEW: 直接与字节区比较前缀，不物化 QString
+    bool startsWith(Atom atom, const QString& prefix, Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+
+    int atomCount() const;
+    int storageBytes() const;
+
+    // 便捷写法
+    static Atom atomOf(const QString& text) { return getInstance()->intern(text); }
+    static Atom find(const QString& text) { return getInstance()->lookup(text); }
+    static QString text(Atom atom) { return getInstance()->string(atom); }
+
+private:
+    AtomTable();
+
+    struct Entry {
+        quint32 offset;
+        quint32 size;       // 字节数
+        quint32 hash;
+        bool utf8;
+    };
+
+    // 查找键：Latin-1 文本直接引用 QChar 数据，否则引用 UTF-8 编码结果
+    struct Key {
+        const QChar* chars = nullptr;
+        const char* bytes = nullptr;
+        int size = 0;
+        bool utf8 = false;
+        quint32 hash = 0;
+    };
+
+    mutable QReadWriteLock lock;
+    QByteArray arena;
+    QVector<Entry> entries;
+    QVector<quint32> buckets;      // 开放寻址，存 原子+1，0 表示空桶
+
+    static Key makeKey(const QString& text, QByteArray& utf8Buffer);
+    bool matches(const Entry& entry, const Key& key) const;
+    int findBucket(const Key& key) const;       // 命中或第一个空桶
+    Atom append(const Key& key);
+    void rehash(int bucketCount);
+};
+
+#endif // ATOMTABLE_H
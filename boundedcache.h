@@ -0,0 +1,120 @@
+#ifndef BOUNDEDCACHE_H
+#define BOUNDEDCACHE_H
+
+#include <QHash>
+#include <QVector>
+
+// 🚀 缓存命中统计，用于调整容量
+struct BoundedCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 evictions = 0;
+    int size = 0;
+    int capacity = 0;
+
+    double hitRate() const
+    {
+        const quint64 probes = hits + misses;
+        return probes ? double(hits) / double(probes) : 0.0;
+    }
+};
+
+// 🚀 固定容量的 CLOCK 缓存(近似 LRU)
+// 条目存放在定长槽位数组中，命中只置引用位；满了以后时钟指针扫过槽位，清掉引用位，
+// 淘汰第一个未被再次访问的条目。内存上限固定，查找/插入均摊 O(1)，命中时不移动任何节点。
+// Key 需要 qHash 与 operator==；不是线程安全的，与 CompletionManager 一样只在 GUI 线程使用。
+template <typename Key, typename Value>
+class BoundedCache
+{
+public:
+    explicit BoundedCache(int capacity = 1024) : maxEntries(qMax(1, capacity)) {}
+
+    int capacity() const { return maxEntries; }
+    int size() const { return slots.size(); }
+
+    // 改变容量会清空条目，统计保留
+    void setCapacity(int capacity)
+    {
+        maxEntries = qMax(1, capacity);
+        clear();
+    }
+
+    bool lookup(const Key& key, Value& value)
+    {
+        auto it = index.constFind(key);
+        if (it == index.constEnd()) {
+            ++counters.misses;
+            return false;
+        }
+
+        Slot& slot = slots[it.value()];
+        slot.referenced = true;
+        value = slot.value;
+        ++counters.hits;
+        return true;
+    }
+
+    void insert(const Key& key, const Value& value)
+    {
+        auto it = index.constFind(key);
+        if (it != index.constEnd()) {
+            Slot& slot = slots[it.value()];
+            slot.value = value;
+            slot.referenced = true;
+            return;
+        }
+
+        if (slots.size() < maxEntries) {
+            index.insert(key, slots.size());
+            slots.append(Slot{ key, value, false });
+            return;
+        }
+
+        // 转一圈内必然找到引用位已清的槽位
+        while (slots.at(hand).referenced) {
+            slots[hand].referenced = false;
+            hand = (hand + 1) % slots.size();
+        }
+
+        Slot& victim = slots[hand];
+        index.remove(victim.key);
+        index.insert(key, hand);
+        victim.key = key;
+        victim.value = value;
+        victim.referenced = false;
+        hand = (hand + 1) % slots.size();
+        ++counters.evictions;
+    }
+
+    void clear()
+    {
+        slots.clear();
+        index.clear();
+        hand = 0;
+    }
+
+    BoundedCacheStats stats() const
+    {
+        BoundedCacheStats result = counters;
+        result.size = slots.size();
+        result.capacity = maxEntries;
+        return result;
+    }
+
+    void resetStats() { counters = BoundedCacheStats(); }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+        bool referenced;
+    };
+
+    QVector<Slot> slots;
+    QHash<Key, int> index;
+    int hand = 0;
+    int maxEntries;
+    BoundedCacheStats counters;
+};
+
+#endif // BOUNDEDCACHE_H
@@ -0,0 +1,251 @@
+#include "commentmask.h"
+#include "textscanner.h"
+
+#include <QDataStream>
+
+CommentMask::CommentMask(const QString& text)
+{
+    build(text);
+}
+
+void CommentMask::build(const QString& text)
+{
+    clear();
+
+    textLength = text.size();
+    const int wordCount = (textLength + 63) / 64;
+    commentBits.fill(0, wordCount);
+    stringBits.fill(0, wordCount);
+
+    const QChar* data = text.constData();
+    int pos = 0;
+
+    // 🚀 向量化扫描直接跳到下一个 / 或 "，其余字符不逐个进入状态机
+    while ((pos = TextScanner::indexOfAny(data, pos, textLength, '/', '"')) < textLength) {
+        const ushort c = data[pos].unicode();
+
+        if (c == '/') {
+            const ushort next = pos + 1 < textLength ? data[pos + 1].unicode() : 0;
+
+            // 单行注释：到行尾(不含换行符)
+            if (next == '/') {
+                const int end = TextScanner::indexOf(data, pos + 2, textLength, '\n');
+                setRange(commentBits, pos, end);
+                regionList.append({pos, end, LineComment});
+                pos = end;
+                continue;
+            }
+
+            // 多行注释：到 */ 为止，未闭合时到文件末尾
+            if (next == '*') {
+                int end = pos + 2;
+                while ((end = TextScanner::indexOf(data, end, textLength, '*')) < textLength &&
+                       !(end + 1 < textLength && data[end + 1].unicode() == '/')) {
+                    ++end;
+                }
+                end = qMin(end + 2, textLength);
+                setRange(commentBits, pos, end);
+                regionList.append({pos, end, BlockComment});
+                pos = end;
+                continue;
+            }
+
+            ++pos;
+            continue;
+        }
+
+        // 字符串：支持转义，未闭合时到行尾为止
+        int end = pos + 1;
+        while ((end = TextScanner::indexOfAny(data, end, textLength, '\\', '"', '\n')) < textLength) {
+            const ushort ch = data[end].unicode();
+            if (ch == '\\') {
+                end += 2;
+                continue;
+            }
+            if (ch == '"') {
+                ++end;
+            }
+            break;
+        }
+        end = qMin(end, textLength);
+        setRange(stringBits, pos, end);
+        regionList.append({pos, end, StringLiteral});
+        pos = end;
+    }
+}
+
+void CommentMask::clear()
+{
+    commentBits.clear();
+    stringBits.clear();
+    regionList.clear();
+    textLength = 0;
+}
+
+void CommentMask::replace(int start, int removedLength, const CommentMask& replacement)
+{
+    const int removedEnd = start + removedLength;
+    const int insertedLength = replacement.textLength;
+    const int tailLength = textLength - removedEnd;
+    const int newLength = start + insertedLength + tailLength;
+    const int wordCount = (newLength + 63) / 64;
+
+    QVector<quint64> newCommentBits(wordCount, 0);
+    QVector<quint64> newStringBits(wordCount, 0);
+
+    copyBits(commentBits, 0, newCommentBits, 0, start);
+    copyBits(replacement.commentBits, 0, newCommentBits, start, insertedLength);
+    copyBits(commentBits, removedEnd, newCommentBits, start + insertedLength, tailLength);
+
+    copyBits(stringBits, 0, newStringBits, 0, start);
+    copyBits(replacement.stringBits, 0, newStringBits, start, insertedLength);
+    copyBits(stringBits, removedEnd, newStringBits, start + insertedLength, tailLength);
+
+    // 区间列表同样拼接：前段保留，替换段加偏移，后段平移
+    const int delta = insertedLength - removedLength;
+    QVector<Region> newRegions;
+    newRegions.reserve(regionList.size() + replacement.regionList.size());
+
+    for (const Region& region : qAsConst(regionList)) {
+        if (region.endPos > start) {
+            break;
+        }
+        newRegions.append(region);
+    }
+    for (const Region& region : replacement.regionList) {
+        newRegions.append({region.startPos + start, region.endPos + start, region.kind});
+    }
+    for (const Region& region : qAsConst(regionList)) {
+        if (region.startPos >= removedEnd) {
+            newRegions.append({region.startPos + delta, region.endPos + delta, region.kind});
+        }
+    }
+
+    commentBits.swap(newCommentBits);
+    stringBits.swap(newStringBits);
+    regionList.swap(newRegions);
+    textLength = newLength;
+}
+
+bool CommentMask::overlapsComment(int start, int length) const
+{
+    return anyInRange(commentBits, start, start + length);
+}
+
+bool CommentMask::overlapsCommentOrString(int start, int length) const
+{
+    return anyInRange(commentBits, start, start + length) ||
+           anyInRange(stringBits, start, start + length);
+}
+
+bool CommentMask::testBit(const QVector<quint64>& bits, int position)
+{
+    if (position < 0) {
+        return false;
+    }
+    const int word = position >> 6;
+    if (word >= bits.size()) {
+        return false;
+    }
+    return (bits.at(word) >> (position & 63)) & 1u;
+}
+
+void CommentMask::setRange(QVector<quint64>& bits, int start, int end)
+{
+    for (int pos = start; pos < end; ) {
+        const int word = pos >> 6;
+        const int bit = pos & 63;
+        const int count = qMin(64 - bit, end - pos);
+        const quint64 mask = (count == 64) ? ~quint64(0) : (((quint64(1) << count) - 1) << bit);
+        bits[word] |= mask;
+        pos += count;
+    }
+}
+
+bool CommentMask::anyInRange(const QVector<quint64>& bits, int start, int end)
+{
+    start = qMax(start, 0);
+    end = qMin(end, bits.size() * 64);
+
+    for (int pos = start; pos < end; ) {
+        const int word = pos >> 6;
+        const int bit = pos & 63;
+        const int count = qMin(64 - bit, end - pos);
+        const quint64 mask = (count == 64) ? ~quint64(0) : (((quint64(1) << count) - 1) << bit);
+        if (bits.at(word) & mask) {
+            return true;
+        }
+        pos += count;
+    }
+    return false;
+}
+
+// target 对应的位须已清零；按64位字成块复制，源/目标位偏移不同时每字最多拆成两次
+void CommentMask::copyBits(const QVector<quint64>& source, int sourcePos,
+                           QVector<quint64>& target, int targetPos, int count)
+{
+    while (count > 0) {
+        const int sourceBit = sourcePos & 63;
+        const int targetBit = targetPos & 63;
+        const int n = qMin(count, qMin(64 - sourceBit, 64 - targetBit));
+        const quint64 mask = (n == 64) ? ~quint64(0) : ((quint64(1) << n) - 1);
+
+        const quint64 bits = (source.at(sourcePos >> 6) >> sourceBit) & mask;
+        target[targetPos >> 6] |= bits << targetBit;
+
+        sourcePos += n;
+        targetPos += n;
+        count -= n;
+    }
+}
+
+bool CommentMask::isWellFormed() const
+{
+    const int wordCount = (textLength + 63) / 64;
+    if (textLength < 0 || commentBits.size() != wordCount || stringBits.size() != wordCount) {
+        return false;
+    }
+    for (const Region &region : regionList) {
+        if (region.startPos < 0 || region.startPos > region.endPos || region.endPos > textLength ||
+            region.kind < LineComment || region.kind > StringLiteral) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QDataStream &operator<<(QDataStream &out, const CommentMask &mask)
+{
+    out << qint32(mask.textLength) << mask.commentBits << mask.stringBits;
+
+    out << qint32(mask.regionList.size());
+    for (const CommentMask::Region &region : mask.regionList) {
+        out << qint32(region.startPos) << qint32(region.endPos) << qint32(region.kind);
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, CommentMask &mask)
+{
+    mask.clear();
+
+    qint32 textLength = 0;
+    qint32 regionCount = 0;
+    in >> textLength >> mask.commentBits >> mask.stringBits >> regionCount;
+    mask.textLength = textLength;
+
+    mask.regionList.reserve(qBound(0, regionCount, 4096));     // 计数可能来自损坏的缓存
+    for (qint32 i = 0; i < regionCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 startPos = 0;
+        qint32 endPos = 0;
+        qint32 kind = 0;
+        in >> startPos >> endPos >> kind;
+
+        CommentMask::Region region;
+        region.startPos = startPos;
+        region.endPos = endPos;
+        region.kind = static_cast<CommentMask::RegionKind>(kind);
+        mask.regionList.append(region);
+    }
+    return in;
+}
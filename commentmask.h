@@ -0,0 +1,68 @@
+#ifndef COMMENTMASK_H
+#define COMMENTMASK_H
+
+#include <QString>
+#include <QVector>
+
+class QDataStream;
+
+// 🚀 注释/字符串掩码
+// 单遍字符级状态机标记 // 、/* */ 注释与 "..." 字符串，每个字符占1位，
+// 位置查询为O(1)，区间查询按64位字逐块检查
+class CommentMask
+{
+public:
+    enum RegionKind {
+        LineComment,
+        BlockComment,
+        StringLiteral
+    };
+
+    struct Region {
+        int startPos;
+        int endPos;         // 不含
+        RegionKind kind;
+    };
+
+    CommentMask() = default;
+    explicit CommentMask(const QString& text);
+
+    void build(const QString& text);
+    void clear();
+
+    // 🚀 NEW: 用 replacement(替换文本的掩码)替换 [start, start + removedLength)，其后的位按长度差平移；
+    // 调用方保证替换区间的两端不落在注释/字符串内部
+    void replace(int start, int removedLength, const CommentMask& replacement);
+
+    int length() const { return textLength; }
+
+    bool isComment(int position) const { return testBit(commentBits, position); }
+    bool isString(int position) const { return testBit(stringBits, position); }
+    bool isCommentOrString(int position) const { return isComment(position) || isString(position); }
+
+    // [start, start + length) 是否与注释(或字符串)有重叠
+    bool overlapsComment(int start, int length) const;
+    bool overlapsCommentOrString(int start, int length) const;
+
+    const QVector<Region>& regions() const { return regionList; }
+
+    // 🚀 NEW: 写入/读出磁盘符号索引缓存
+    friend QDataStream &operator<<(QDataStream &out, const CommentMask &mask);
+    friend QDataStream &operator>>(QDataStream &in, CommentMask &mask);
+    // 读出的掩码与长度一致：位向量覆盖全部字符，区间落在文本内
+    bool isWellFormed() const;
+
+private:
+    QVector<quint64> commentBits;
+    QVector<quint64> stringBits;
+    QVector<Region> regionList;
+    int textLength = 0;
+
+    static bool testBit(const QVector<quint64>& bits, int position);
+    static void setRange(QVector<quint64>& bits, int start, int end);
+    static bool anyInRange(const QVector<quint64>& bits, int start, int end);
+    static void copyBits(const QVector<quint64>& source, int sourcePos,
+                         QVector<quint64>& target, int targetPos, int count);
+};
+
+#endif // COMMENTMASK_H
@@ -1,6 +1,8 @@
 #include "completionmanager.h"
+#include "symbolsnapshot.h"
 #include "symbolrelationshipengine.h"
 #include "smartrelationshipbuilder.h"
+#include "abbreviationmatcher.h"
 
 #include <QDateTime>
 #include <algorithm>
@@ -14,13 +16,8 @@ CompletionManager::CompletionManager()
     // 预分配内存以提高性能
     keywordMatchCache.reserve(100);
     keywordScoreCache.reserve(100);
-    symbolScoreCache.reserve(200);
-    singleMatchCache.reserve(1000);
-    singleScoreCache.reserve(1000);
-    positionCache.reserve(500);
 
     // 🚀 NEW: Reserve space for optimized caches
-    allSymbolScoreCache.reserve(150);
     allSymbolMatchCache.reserve(150);
     precomputedCompletions.reserve(20);
     precomputedPrefixMatches.reserve(300);
@@ -42,89 +39,132 @@ CompletionManager* CompletionManager::getInstance()
 
 QVector<QPair<QString, int>> CompletionManager::getScoredAllSymbolMatches(const QString& prefix)
 {
-    QString cacheKey = QString("all_symbols_%1").arg(prefix);
+    const quint64 cacheKey = queryHash(prefix);
 
     // 🚀 智能缓存检查
-    if (allSymbolScoreCache.contains(cacheKey) && allSymbolsCacheValid) {
-        return allSymbolScoreCache[cacheKey];
+    QVector<QPair<QString, int>> cached;
+    if (allSymbolsCacheValid && allSymbolScoreCache.lookup(cacheKey, cached)) {
+        return cached;
     }
 
     // 🚀 确保所有符号缓存是最新的
     updateAllSymbolsCache();
 
-    // 🚀 使用预计算的符号名称列表进行快速过滤
     QVector<QPair<QString, int>> scoredMatches;
-    scoredMatches.reserve(qMin(cachedAllSymbolNames.size(), 50));
+    if (prefix.isEmpty()) {
+        return scoredMatches;   // 空前缀不打分
+    }
+    scoredMatches.reserve(qMin(allSymbolNames.entryCount(), 50));
 
-    for (const QString& symbolName : qAsConst(cachedAllSymbolNames)) {
-        int score = calculateMatchScore(symbolName, prefix);
-        if (score > 0) {
-            scoredMatches.append(qMakePair(symbolName, score));
+    if (completionSession.isActive()) {
+        // 🚀 编辑器正在补全同一个单词：只在上一次按键的幸存者中收窄，退格时直接取缓存的较短一级
+        for (const CompletionSession::Candidate& candidate :
+             completionSession.candidates(allSymbolNames, allSymbolNamesVersion, prefix)) {
+            scoredMatches.append(qMakePair(allSymbolNames.trieAt(candidate.trie).nameAt(candidate.entry),
+                                           candidate.score));
+        }
+    } else {
+        // 🚀 前缀命中(1000 / 800+)直接由前缀树给出，开销与命中数成正比。
+        // 包含/缩写匹配的得分低于前缀命中(缩写最高约 490 + 59 * 前缀长度)，
+        // 前缀命中已填满结果且前缀不超过6个字符时，其余名称不可能进入前列，不必逐个打分
+        const QStringList prefixMatches = allSymbolNames.namesWithPrefix(prefix);
+        if (prefixMatches.size() >= 20 && prefix.length() <= 6) {
+            for (const QString& symbolName : prefixMatches) {
+                const int score = symbolName.length() == prefix.length() ? 1000 : 800 + (100 - prefix.length());
+                scoredMatches.append(qMakePair(symbolName, score));
+            }
+        } else {
+            // 🚀 全量打分：缩写只折叠一次，候选用建索引时的签名，缺字符的名称一次掩码测试即排除；
+            // 各文件的前缀树中可能有同名条目，命中的名称按原子去重
+            const AbbreviationMatcher::Query query = AbbreviationMatcher::queryOf(prefix);
+            QSet<AtomTable::Atom> seen;
+            for (int t = 0; t < allSymbolNames.trieCount(); ++t) {
+                const SymbolNameTrie& trie = allSymbolNames.trieAt(t);
+                for (int i = 0; i < trie.size(); ++i) {
+                    const AbbreviationMatcher::Signature& signature = trie.signatureAt(i);
+                    if (!AbbreviationMatcher::mayMatch(signature, query)) {
+                        continue;
+                    }
+                    const QString& symbolName = trie.nameAt(i);
+                    const int score = AbbreviationMatcher::score(symbolName, signature, query);
+                    if (score > 0 && !seen.contains(trie.atomAt(i))) {
+                        seen.insert(trie.atomAt(i));
+                        scoredMatches.append(qMakePair(symbolName, score));
+                    }
+                }
+            }
         }
     }
 
-    // 🚀 高效排序
-    std::sort(scoredMatches.begin(), scoredMatches.end(),
-              [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
-                  if (a.second != b.second) {
-                      return a.second > b.second;
-                  }
-                  return a.first < b.first;
-              });
-
-    // 🚀 限制结果数量以提高性能
-    if (scoredMatches.size() > 20) {
-        scoredMatches = scoredMatches.mid(0, 20);
-    }
+    // 🚀 只需前20个：部分排序，幸存者很多时不必全排
+    const int keep = qMin(scoredMatches.size(), 20);
+    std::partial_sort(scoredMatches.begin(), scoredMatches.begin() + keep, scoredMatches.end(),
+                      [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
+                          if (a.second != b.second) {
+                              return a.second > b.second;
+                          }
+                          return a.first < b.first;
+                      });
+    scoredMatches.resize(keep);
 
     // 缓存结果
-    allSymbolScoreCache[cacheKey] = scoredMatches;
+    allSymbolScoreCache.insert(cacheKey, scoredMatches);
     return scoredMatches;
 }
 
+void CompletionManager::beginCompletionSession(const QString& fileName, int wordStartPos)
+{
+    // 同一锚点重复调用保留已缓存的各级结果
+    completionSession.begin(fileName, wordStartPos);
+}
+
+void CompletionManager::endCompletionSession()
+{
+    completionSession.reset();
+}
+
 // 🚀 智能符号匹配方法（使用索引优化）
 QVector<QPair<sym_list::SymbolInfo, int>> CompletionManager::getScoredSymbolMatches(
     sym_list::sym_type_e symbolType, const QString& prefix)
 {
     updateSymbolCaches();
-    QString cacheKey = buildSymbolCacheKey(symbolType, prefix);
+    const QueryKey cacheKey = { quint32(symbolType), queryHash(prefix) };
 
-    if (symbolScoreCache.contains(cacheKey)) {
-        return symbolScoreCache[cacheKey];
+    QVector<QPair<sym_list::SymbolInfo, int>> cached;
+    if (symbolScoreCache.lookup(cacheKey, cached)) {
+        return cached;
     }
 
-    // 🚀 使用高性能索引查找
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> symbols = symbolList->findSymbolsByType(symbolType);
+    // 🚀 沿类型索引零拷贝遍历，只物化命中的符号
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
 
     QVector<QPair<sym_list::SymbolInfo, int>> scoredMatches;
-    scoredMatches.reserve(qMin(symbols.size(), 30));
+    scoredMatches.reserve(30);
 
     // 🚀 优化的匹配逻辑
-    for (const sym_list::SymbolInfo &symbol : qAsConst(symbols)) {
+    snapshot->forEachOfType(symbolType, [&](const SymbolRef& symbol) {
         int score = 0;
 
         if (prefix.isEmpty()) {
             score = 100; // 空前缀：显示所有符号
         } else {
-            const QString lowerText = symbol.symbolName.toLower();
-            const QString lowerPrefix = prefix.toLower();
+            const QString symbolName = symbol.name();
 
-            if (lowerText == lowerPrefix) {
+            if (symbolName.compare(prefix, Qt::CaseInsensitive) == 0) {
                 score = 1000; // 精确匹配
-            } else if (lowerText.startsWith(lowerPrefix)) {
+            } else if (symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
                 score = 800 + (100 - prefix.length()); // 前缀匹配
-            } else if (lowerText.contains(lowerPrefix)) {
-                score = 400 + (100 - symbol.symbolName.length()); // 包含匹配
-            } else if (matchesAbbreviation(symbol.symbolName, prefix)) {
+            } else if (symbolName.contains(prefix, Qt::CaseInsensitive)) {
+                score = 400 + (100 - symbolName.length()); // 包含匹配
+            } else if (matchesAbbreviation(symbolName, prefix)) {
                 score = 200; // 缩写匹配
             }
         }
 
         if (score > 0) {
-            scoredMatches.append(qMakePair(symbol, score));
+            scoredMatches.append(qMakePair(symbol.toSymbolInfo(), score));
         }
-    }
+    });
 
     // 🚀 高效排序
     std::sort(scoredMatches.begin(), scoredMatches.end(),
@@ -140,7 +180,7 @@ QVector<QPair<sym_list::SymbolInfo, int>> CompletionManager::getScoredSymbolMatc
         scoredMatches = scoredMatches.mid(0, 15);
     }
 
-    symbolScoreCache[cacheKey] = scoredMatches;
+    symbolScoreCache.insert(cacheKey, scoredMatches);
     return scoredMatches;
 }
 
@@ -174,12 +214,10 @@ void CompletionManager::updateAllSymbolsCache()
 {
     if (allSymbolsCacheValid) return;
 
-    // 🚀 使用高性能方法获取所有唯一符号名称
-    sym_list* symbolList = sym_list::getInstance();
-    QSet<QString> uniqueNames = symbolList->getUniqueSymbolNames();
-
-    cachedAllSymbolNames = uniqueNames.toList();
-    cachedAllSymbolNames.sort(); // 排序以提高查找效率
+    // 🚀 取快照的名称索引(只引用各分片已建好的前缀树，复制开销与文件数成正比)
+    const std::shared_ptr<const SymbolSnapshot> snapshot = sym_list::getInstance()->getSnapshot();
+    allSymbolNames = snapshot->nameIndex();
+    allSymbolNamesVersion = snapshot->version();
 
     // 清空旧的匹配缓存
     allSymbolScoreCache.clear();
@@ -208,15 +246,9 @@ void CompletionManager::precomputeFrequentCompletions()
     QStringList commonPrefixes = {"c", "d", "e", "m", "r", "s", "t", "v", "w"};
 
     for (const QString& prefix : commonPrefixes) {
-        QStringList matches;
-        for (const QString& name : qAsConst(cachedAllSymbolNames)) {
-            if (name.startsWith(prefix, Qt::CaseInsensitive)) {
-                matches.append(name);
-            }
-        }
-
+        // 前缀树给出的结果已按名称排序
+        QStringList matches = allSymbolNames.namesWithPrefix(prefix);
         if (!matches.isEmpty()) {
-            matches.sort();
             precomputedPrefixMatches[prefix] = matches;
         }
     }
@@ -230,7 +262,7 @@ bool CompletionManager::shouldSkipCacheRefresh()
     if (!smartCachingEnabled) return false;
 
     sym_list* symbolList = sym_list::getInstance();
-    int currentSize = symbolList->getAllSymbols().size();
+    int currentSize = symbolList->getSymbolCount();
     QString currentHash = calculateSymbolDatabaseHash();
 
     // 大小没有变化且内容哈希相同
@@ -251,18 +283,8 @@ bool CompletionManager::shouldSkipCacheRefresh()
 // 🚀 计算符号数据库内容哈希
 QString CompletionManager::calculateSymbolDatabaseHash()
 {
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    // 使用符号数量和前几个符号名称生成轻量级哈希
-    QString hashInput = QString::number(allSymbols.size());
-
-    int sampleSize = qMin(10, allSymbols.size());
-    for (int i = 0; i < sampleSize; ++i) {
-        hashInput += allSymbols[i].symbolName;
-    }
-
-    return QString::number(qHash(hashInput));
+    // 🚀 快照版本号：符号库每发布一次新版本就递增，O(1) 且不会漏掉数量不变的修改
+    return QString::number(sym_list::getInstance()->getSnapshot()->version());
 }
 
 // 🚀 启用/禁用智能缓存
@@ -395,7 +417,7 @@ void CompletionManager::invalidateSymbolCaches()
     // 保留预计算数据，除非符号结构发生重大变化
     if (smartCachingEnabled) {
         sym_list* symbolList = sym_list::getInstance();
-        int currentSize = symbolList->getAllSymbols().size();
+        int currentSize = symbolList->getSymbolCount();
 
         if (abs(currentSize - lastSymbolDatabaseSize) > cacheInvalidationThreshold) {
             precomputedCompletions.clear();
@@ -411,8 +433,9 @@ void CompletionManager::invalidateSymbolCaches()
 
 void CompletionManager::updateSymbolCaches()
 {
-    sym_list* symbolList = sym_list::getInstance();
-    int currentSize = symbolList->getAllSymbols().size();
+    // 🚀 同一快照内取数，各类型缓存彼此一致
+    const std::shared_ptr<const SymbolSnapshot> snapshot = sym_list::getInstance()->getSnapshot();
+    int currentSize = snapshot->symbolCount();
 
     // 🚀 智能更新检测
     bool shouldUpdate = (currentSize != lastSymbolDatabaseSize) || symbolTypeCache.isEmpty();
@@ -422,12 +445,12 @@ void CompletionManager::updateSymbolCaches()
         lastSymbolDatabaseSize = currentSize;
 
         // 🚀 使用高性能索引方法填充缓存
-        symbolTypeCache[sym_list::sym_reg] = symbolList->findSymbolsByType(sym_list::sym_reg);
-        symbolTypeCache[sym_list::sym_wire] = symbolList->findSymbolsByType(sym_list::sym_wire);
-        symbolTypeCache[sym_list::sym_logic] = symbolList->findSymbolsByType(sym_list::sym_logic);
-        symbolTypeCache[sym_list::sym_module] = symbolList->findSymbolsByType(sym_list::sym_module);
-        symbolTypeCache[sym_list::sym_task] = symbolList->findSymbolsByType(sym_list::sym_task);
-        symbolTypeCache[sym_list::sym_function] = symbolList->findSymbolsByType(sym_list::sym_function);
+        symbolTypeCache[sym_list::sym_reg] = snapshot->symbolsOfType(sym_list::sym_reg);
+        symbolTypeCache[sym_list::sym_wire] = snapshot->symbolsOfType(sym_list::sym_wire);
+        symbolTypeCache[sym_list::sym_logic] = snapshot->symbolsOfType(sym_list::sym_logic);
+        symbolTypeCache[sym_list::sym_module] = snapshot->symbolsOfType(sym_list::sym_module);
+        symbolTypeCache[sym_list::sym_task] = snapshot->symbolsOfType(sym_list::sym_task);
+        symbolTypeCache[sym_list::sym_function] = snapshot->symbolsOfType(sym_list::sym_function);
 
         // 🚀 标记需要更新所有符号缓存
         allSymbolsCacheValid = false;
@@ -442,24 +465,19 @@ bool CompletionManager::matchesAbbreviation(const QString &text, const QString &
         return false;
     }
 
-    // 检查缓存
-    QString cacheKey = buildSingleMatchKey(text, abbreviation);
-    if (singleMatchCache.contains(cacheKey)) {
-        return singleMatchCache[cacheKey];
+    // 检查缓存(未登记为原子的文本不缓存，直接计算)
+    QueryKey cacheKey;
+    const bool cacheable = nameKey(text, abbreviation, cacheKey);
+    bool result = false;
+    if (cacheable && singleMatchCache.lookup(cacheKey, result)) {
+        return result;
     }
 
-    const QString lowerText = text.toLower();
-    const QString lowerAbbrev = abbreviation.toLower();
-
-    // 前缀匹配优先
-    if (lowerText.startsWith(lowerAbbrev)) {
-        singleMatchCache[cacheKey] = true;
-        return true;
+    // 🚀 前缀匹配必然也是缩写(子序列)匹配，由位并行内核一次判定
+    result = AbbreviationMatcher::matches(text, abbreviation);
+    if (cacheable) {
+        singleMatchCache.insert(cacheKey, result);
     }
-
-    // 缩写匹配（传入原始文本以支持驼峰命名检测）
-    bool result = isValidAbbreviationMatch(text, abbreviation);
-    singleMatchCache[cacheKey] = result;
     return result;
 }
 
@@ -470,166 +488,91 @@ int CompletionManager::calculateMatchScore(const QString &text, const QString &a
     }
 
     // 检查缓存
-    QString cacheKey = buildSingleMatchKey(text, abbreviation);
-    if (singleScoreCache.contains(cacheKey)) {
-        return singleScoreCache[cacheKey];
-    }
-
-    const QString lowerText = text.toLower();
-    const QString lowerAbbrev = abbreviation.toLower();
-
+    QueryKey cacheKey;
+    const bool cacheable = nameKey(text, abbreviation, cacheKey);
     int score = 0;
-
-    // 精确匹配
-    if (lowerText == lowerAbbrev) {
-        score = 1000;
+    if (cacheable && singleScoreCache.lookup(cacheKey, score)) {
+        return score;
     }
-    // 前缀匹配
-    else if (lowerText.startsWith(lowerAbbrev)) {
-        score = 800 + (100 - abbreviation.length());
-    }
-    // 包含匹配
-    else if (lowerText.contains(lowerAbbrev)) {
-        score = 400 + (100 - text.length());
-    }
-    // 缩写匹配（传入原始文本以支持驼峰命名检测）
-    else if (isValidAbbreviationMatch(text, abbreviation)) {
-        QList<int> positions = findAbbreviationPositions(text, abbreviation);
-        score = 500;
-
-        // 单词边界奖励
-        int wordBoundaryMatches = 0;
-        for (int pos : qAsConst(positions)) {
-            if (pos == 0 || lowerText[pos - 1] == '_' || lowerText[pos - 1] == ' ') {
-                wordBoundaryMatches++;
-            }
-            // 驼峰命名边界检查
-            if (pos > 0 && pos < lowerText.length()) {
-                QChar prevChar = text[pos - 1];
-                QChar currChar = text[pos];
-                if (prevChar.isLower() && currChar.isUpper()) {
-                    wordBoundaryMatches++;
-                }
-            }
-        }
-
-        score += wordBoundaryMatches * 50;
-        score -= text.length(); // 较短文本的奖励
 
-        // 连续字符奖励
-        for (int i = 1; i < positions.size(); i++) {
-            if (positions[i] == positions[i-1] + 1) {
-                score += 10;
-            }
-        }
-    }
+    // 🚀 精确 1000 / 前缀 800+ / 包含 400+ / 缩写 500 + 单词边界与连续字符奖励，见 AbbreviationMatcher
+    score = AbbreviationMatcher::score(text, abbreviation);
 
     // 缓存结果
-    singleScoreCache[cacheKey] = score;
+    if (cacheable) {
+        singleScoreCache.insert(cacheKey, score);
+    }
     return score;
 }
 
 // ===== 辅助方法 =====
 
-bool CompletionManager::isValidAbbreviationMatch(const QString &text, const QString &abbreviation)
+QList<int> CompletionManager::findAbbreviationPositions(const QString &text, const QString &abbreviation)
 {
-    if (abbreviation.length() > text.length()) {
-        return false;
+    QueryKey cacheKey;
+    const bool cacheable = nameKey(text, abbreviation, cacheKey);
+    QList<int> positions;
+    if (cacheable && positionCache.lookup(cacheKey, positions)) {
+        return positions;
     }
 
-    // 转换为小写用于比较，但保留原始文本用于驼峰命名检测
-    const QString lowerText = text.toLower();
-    const QString lowerAbbrev = abbreviation.toLower();
-
-    int textPos = 0;
-    int abbrevPos = 0;
-
-    while (abbrevPos < lowerAbbrev.length() && textPos < text.length()) {
-        QChar abbrevChar = lowerAbbrev[abbrevPos];
-        QChar textChar = lowerText[textPos];
-
-        if (abbrevChar == textChar) {
-            abbrevPos++;
-            textPos++;
-        } else {
-            // 检查是否是分隔符（下划线、空格或驼峰命名边界）
-            bool isSeparator = (text[textPos] == '_' || text[textPos] == ' ');
-
-            if (textPos > 0) {
-                QChar prevChar = text[textPos - 1];
-                QChar currChar = text[textPos];
-                // 驼峰命名边界检测：小写字母后跟大写字母
-                if (prevChar.isLower() && currChar.isUpper()) {
-                    isSeparator = true;
-                }
-            }
-
-            // 如果是分隔符，跳过分隔符并检查下一个字符是否匹配
-            if (isSeparator && textPos + 1 < text.length()) {
-                QChar nextChar = lowerText[textPos + 1];
-                if (abbrevChar == nextChar) {
-                    textPos++; // 跳过分隔符
-                    continue;
-                }
-            }
-
-            textPos++;
-        }
+    // 不匹配时为空
+    positions = AbbreviationMatcher::positions(text, AbbreviationMatcher::signatureOf(text),
+                                               AbbreviationMatcher::queryOf(abbreviation));
+    if (cacheable) {
+        positionCache.insert(cacheKey, positions);
     }
-
-    return abbrevPos == lowerAbbrev.length();
+    return positions;
 }
 
-QList<int> CompletionManager::findAbbreviationPositions(const QString &text, const QString &abbreviation)
+// 两个不同种子的32位哈希拼成64位，不同查询串冲突的概率可以忽略
+quint64 CompletionManager::queryHash(const QString& query)
 {
-    QString cacheKey = buildSingleMatchKey(text, abbreviation) + "_pos";
+    return (quint64(qHash(query, 0x9e3779b9u)) << 32) | quint64(qHash(query, 0x85ebca6bu));
+}
 
-    if (positionCache.contains(cacheKey)) {
-        return positionCache[cacheKey];
+// 符号名通常已是原子；只查不登记，避免查询把原子表撑大
+bool CompletionManager::nameKey(const QString& text, const QString& abbreviation, QueryKey& key)
+{
+    const AtomTable::Atom atom = AtomTable::find(text);
+    if (atom == AtomTable::NoAtom) {
+        return false;
     }
+    key.subject = atom;
+    key.query = queryHash(abbreviation);
+    return true;
+}
 
-    QList<int> positions;
-    if (!isValidAbbreviationMatch(text, abbreviation)) {
-        positionCache[cacheKey] = positions;
-        return positions;
+void CompletionManager::setCacheCapacity(CacheKind cache, int capacity)
+{
+    switch (cache) {
+    case SingleMatchCache:    singleMatchCache.setCapacity(capacity); break;
+    case SingleScoreCache:    singleScoreCache.setCapacity(capacity); break;
+    case PositionCache:       positionCache.setCapacity(capacity); break;
+    case SymbolScoreCache:    symbolScoreCache.setCapacity(capacity); break;
+    case AllSymbolScoreCache: allSymbolScoreCache.setCapacity(capacity); break;
     }
+}
 
-    const QString lowerText = text.toLower();
-    const QString lowerAbbrev = abbreviation.toLower();
-
-    int textPos = 0;
-    int abbrevPos = 0;
-
-    while (abbrevPos < lowerAbbrev.length() && textPos < lowerText.length()) {
-        if (lowerAbbrev[abbrevPos] == lowerText[textPos]) {
-            positions.append(textPos);
-            abbrevPos++;
-        } else {
-            // 处理分隔符：跳过分隔符字符
-            bool isSeparator = (text[textPos] == '_' || text[textPos] == ' ');
-            if (textPos > 0) {
-                QChar prevChar = text[textPos - 1];
-                QChar currChar = text[textPos];
-                if (prevChar.isLower() && currChar.isUpper()) {
-                    isSeparator = true;
-                }
-            }
-            if (isSeparator && textPos + 1 < text.length() && 
-                lowerAbbrev[abbrevPos] == lowerText[textPos + 1]) {
-                textPos++; // 跳过分隔符
-                continue;
-            }
-        }
-        textPos++;
+BoundedCacheStats CompletionManager::cacheStats(CacheKind cache) const
+{
+    switch (cache) {
+    case SingleMatchCache:    return singleMatchCache.stats();
+    case SingleScoreCache:    return singleScoreCache.stats();
+    case PositionCache:       return positionCache.stats();
+    case SymbolScoreCache:    return symbolScoreCache.stats();
+    case AllSymbolScoreCache: return allSymbolScoreCache.stats();
     }
-
-    positionCache[cacheKey] = positions;
-    return positions;
+    return BoundedCacheStats();
 }
 
-QString CompletionManager::buildSingleMatchKey(const QString &text, const QString &abbreviation)
+void CompletionManager::resetCacheStats()
 {
-    return QString("%1|%2").arg(text, abbreviation);
+    singleMatchCache.resetStats();
+    singleScoreCache.resetStats();
+    positionCache.resetStats();
+    symbolScoreCache.resetStats();
+    allSymbolScoreCache.resetStats();
 }
 
 QString CompletionManager::buildKeywordCacheKey(const QString &prefix)
@@ -637,11 +580,6 @@ QString CompletionManager::buildKeywordCacheKey(const QString &prefix)
     return QString("kw_%1").arg(prefix);
 }
 
-QString CompletionManager::buildSymbolCacheKey(sym_list::sym_type_e symbolType, const QString &prefix)
-{
-    return QString("sym_%1_%2").arg(static_cast<int>(symbolType)).arg(prefix);
-}
-
 void CompletionManager::initializeKeywords()
 {
     if (keywordsInitialized) return;
@@ -730,8 +668,10 @@ QVector<QPair<QString, int>> CompletionManager::calculateScoredMatches(const QSt
     QVector<QPair<QString, int>> scoredMatches;
     scoredMatches.reserve(candidates.size());
 
+    // 🚀 缩写只折叠一次；候选签名即时计算，比拼接缓存键再查表便宜
+    const AbbreviationMatcher::Query query = AbbreviationMatcher::queryOf(abbreviation);
     for (const QString &candidate : candidates) {
-        int score = calculateMatchScore(candidate, abbreviation);
+        int score = AbbreviationMatcher::score(candidate, AbbreviationMatcher::signatureOf(candidate), query);
         if (score > 0) {
             scoredMatches.append(qMakePair(candidate, score));
         }
@@ -755,8 +695,10 @@ QVector<QPair<sym_list::SymbolInfo, int>> CompletionManager::calculateScoredSymb
     QVector<QPair<sym_list::SymbolInfo, int>> scoredMatches;
     scoredMatches.reserve(symbols.size());
 
+    const AbbreviationMatcher::Query query = AbbreviationMatcher::queryOf(abbreviation);
     for (const sym_list::SymbolInfo &symbol : symbols) {
-        int score = calculateMatchScore(symbol.symbolName, abbreviation);
+        int score = AbbreviationMatcher::score(symbol.symbolName,
+                                               AbbreviationMatcher::signatureOf(symbol.symbolName), query);
         if (score > 0) {
             scoredMatches.append(qMakePair(symbol, score));
         }
@@ -783,7 +725,7 @@ void CompletionManager::invalidateKeywordCaches()
 bool CompletionManager::isSymbolCacheValid()
 {
     sym_list* symbolList = sym_list::getInstance();
-    return lastSymbolDatabaseSize == symbolList->getAllSymbols().size();
+    return lastSymbolDatabaseSize == symbolList->getSymbolCount();
 }
 
 void CompletionManager::setRelationshipEngine(SymbolRelationshipEngine* engine)
@@ -863,13 +805,13 @@ QString CompletionManager::extractStructTypeFromContext(const QString &context)
         QString varName = dotPattern.cap(1);
 
         // 查找该变量的类型
-        sym_list* symList = sym_list::getInstance();
-        for (const auto &symbol : symList->getAllSymbols()) {
-            if (symbol.symbolName == varName &&
-                (symbol.symbolType == sym_list::sym_packed_struct_var ||
-                 symbol.symbolType == sym_list::sym_unpacked_struct_var)) {
-                return symbol.moduleScope;  // 返回结构体类型名称
-            }
+        const sym_list::SymbolInfo symbol = sym_list::getInstance()->getSnapshot()->firstNamed(
+            varName, [](const SymbolRef& candidate) {
+                return candidate.type() == sym_list::sym_packed_struct_var ||
+                       candidate.type() == sym_list::sym_unpacked_struct_var;
+            });
+        if (symbol.symbolId != -1) {
+            return symbol.moduleScope;  // 返回结构体类型名称
         }
     }
 
@@ -1158,13 +1100,14 @@ QString CompletionManager::getStructTypeForVariable(const QString& varName,
         }
     }
 
-    // 在全局范围查找
-    for (const auto& symbol : symList->getAllSymbols()) {
-        if (symbol.symbolName == varName &&
-            (symbol.symbolType == sym_list::sym_packed_struct_var ||
-             symbol.symbolType == sym_list::sym_unpacked_struct_var)) {
-            return symbol.moduleScope;
-        }
+    // 在全局范围查找（按名称索引）
+    const sym_list::SymbolInfo symbol = symList->getSnapshot()->firstNamed(
+        varName, [](const SymbolRef& candidate) {
+            return candidate.type() == sym_list::sym_packed_struct_var ||
+                   candidate.type() == sym_list::sym_unpacked_struct_var;
+        });
+    if (symbol.symbolId != -1) {
+        return symbol.moduleScope;
     }
 
     return "";
@@ -1188,12 +1131,13 @@ QString CompletionManager::getEnumTypeForVariable(const QString& varName,
         }
     }
 
-    // 在全局范围查找
-    for (const auto& symbol : symList->getAllSymbols()) {
-        if (symbol.symbolName == varName &&
-            symbol.symbolType == sym_list::sym_enum_var) {
-            return symbol.moduleScope;
-        }
+    // 在全局范围查找（按名称索引）
+    const sym_list::SymbolInfo symbol = symList->getSnapshot()->firstNamed(
+        varName, [](const SymbolRef& candidate) {
+            return candidate.type() == sym_list::sym_enum_var;
+        });
+    if (symbol.symbolId != -1) {
+        return symbol.moduleScope;
     }
 
     return "";
@@ -1209,25 +1153,17 @@ QStringList CompletionManager::getModulePortCompletions(const QString& prefix,
         return results;
     }
 
-    // 查找模块的端口信息
-    sym_list* symList = sym_list::getInstance();
-
     // 找到模块定义
-    for (const auto& symbol : symList->getAllSymbols()) {
-        if (symbol.symbolType == sym_list::sym_module &&
-            symbol.symbolName == moduleTypeName) {
-
-            // 获取该模块内部的端口信息
-            QStringList ports = getModuleInternalVariablesByType(moduleTypeName,
-                               sym_list::sym_wire, prefix);
-            ports.append(getModuleInternalVariablesByType(moduleTypeName,
-                        sym_list::sym_reg, prefix));
-            ports.append(getModuleInternalVariablesByType(moduleTypeName,
-                        sym_list::sym_logic, prefix));
-
-            results.append(ports);
-            break;
-        }
+    bool isModule = false;
+    sym_list::getInstance()->getSnapshot()->forEachNamed(moduleTypeName, [&](const SymbolRef& symbol) {
+        isModule = isModule || symbol.type() == sym_list::sym_module;
+    });
+
+    if (isModule) {
+        // 获取该模块内部的端口信息
+        results.append(getModuleInternalVariablesByType(moduleTypeName, sym_list::sym_wire, prefix));
+        results.append(getModuleInternalVariablesByType(moduleTypeName, sym_list::sym_reg, prefix));
+        results.append(getModuleInternalVariablesByType(moduleTypeName, sym_list::sym_logic, prefix));
     }
 
     return results;
@@ -1401,22 +1337,16 @@ QStringList CompletionManager::getClockDomainCompletions(const QString& prefix)
 
     QStringList results;
 
-    // 🚀 查找所有时钟关系
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 🚀 检查是否有时钟关系
-        QList<int> clockedModules = relationshipEngine->getRelatedSymbols(
-            symbol.symbolId, SymbolRelationshipEngine::CLOCKS, true);
-
-        if (!clockedModules.isEmpty()) {
-            QString symbolName = symbol.symbolName;
-            if (prefix.isEmpty() || symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
-                results.append(symbolName);
-            }
-        }
-    }
+    // 🚀 查找所有时钟关系(零拷贝遍历，先比较名称前缀再查关系)
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
+    snapshot->forEach(
+        [&](const SymbolRef& symbol) {
+            return symbol.nameStartsWith(prefix, Qt::CaseInsensitive) &&
+                   relationshipEngine->hasRelationships(symbol.symbolId(), SymbolRelationshipEngine::CLOCKS, true);
+        },
+        [&](const SymbolRef& symbol) {
+            results.append(symbol.name());
+        });
 
     clockDomainCache[cacheKey] = results;
     return results;
@@ -1436,21 +1366,16 @@ QStringList CompletionManager::getResetSignalCompletions(const QString& prefix)
 
     QStringList results;
 
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 🚀 检查是否有复位关系
-        QList<int> resetModules = relationshipEngine->getRelatedSymbols(
-            symbol.symbolId, SymbolRelationshipEngine::RESETS, true);
-
-        if (!resetModules.isEmpty()) {
-            QString symbolName = symbol.symbolName;
-            if (prefix.isEmpty() || symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
-                results.append(symbolName);
-            }
-        }
-    }
+    // 🚀 检查复位关系(零拷贝遍历，先比较名称前缀再查关系)
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
+    snapshot->forEach(
+        [&](const SymbolRef& symbol) {
+            return symbol.nameStartsWith(prefix, Qt::CaseInsensitive) &&
+                   relationshipEngine->hasRelationships(symbol.symbolId(), SymbolRelationshipEngine::RESETS, true);
+        },
+        [&](const SymbolRef& symbol) {
+            results.append(symbol.name());
+        });
 
     resetSignalCache[cacheKey] = results;
     return results;
@@ -1470,14 +1395,14 @@ QStringList CompletionManager::getVariableCompletionsInScope(const QString& modu
     // 🚀 获取模块内指定类型的变量
     QStringList moduleChildren = getModuleChildrenCompletions(moduleName, prefix);
 
-    sym_list* symbolList = sym_list::getInstance();
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
     for (const QString& childName : moduleChildren) {
-        QList<sym_list::SymbolInfo> symbols = symbolList->findSymbolsByName(childName);
-        for (const sym_list::SymbolInfo& symbol : symbols) {
-            if (symbol.symbolType == variableType) {
-                results.append(symbol.symbolName);
-                break;
-            }
+        bool found = false;
+        snapshot->forEachNamed(childName, [&](const SymbolRef& symbol) {
+            found = found || symbol.type() == variableType;
+        });
+        if (found) {
+            results.append(childName);
         }
     }
 
@@ -1531,32 +1456,8 @@ QString CompletionManager::getCurrentModule(const QString& fileName, int cursorP
         return QString();
     }
 
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> fileSymbols = symbolList->findSymbolsByFileName(fileName);
-
-    // 🚀 过滤出模块符号并按位置排序
-    QList<sym_list::SymbolInfo> modules;
-    for (const sym_list::SymbolInfo& symbol : fileSymbols) {
-        if (symbol.symbolType == sym_list::sym_module) {
-            modules.append(symbol);
-        }
-    }
-
-    if (modules.isEmpty()) {
-        return QString();
-    }
-
-    // 按开始位置排序
-    std::sort(modules.begin(), modules.end(),
-              [](const sym_list::SymbolInfo& a, const sym_list::SymbolInfo& b) {
-                  return a.position < b.position;
-              });
-
-    // 🚀 需要更精确地检测模块边界
-    // 这里需要找到 endmodule 的位置
-    QString currentModuleName = findModuleAtPosition(modules, cursorPosition, fileName);
-
-    return currentModuleName;
+    // 🚀 模块区间表在解析时建立(含 endmodule 位置与嵌套关系)，这里只需二分查找，不再读取文件
+    return sym_list::getInstance()->getScopeTree(fileName).moduleAtPosition(cursorPosition);
 }
 QStringList CompletionManager::getSymbolNamesFromIds(const QList<int>& symbolIds)
 {
@@ -1574,48 +1475,10 @@ QStringList CompletionManager::getSymbolNamesFromIds(const QList<int>& symbolIds
     return names;
 }
 
-QString CompletionManager::findModuleAtPosition(
-    const QList<sym_list::SymbolInfo>& modules,
-    int cursorPosition,
-    const QString& fileName)
-{
-    // 🚀 读取文件内容以精确查找 endmodule 位置
-    QFile file(fileName);
-    QString fileContent;
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        fileContent = file.readAll();
-    }
-
-    for (const auto& module : modules) {
-        if (cursorPosition >= module.position) {
-            // 🔧 FIX: 查找对应的 endmodule 位置
-            int moduleEndPosition = findEndModulePosition(fileContent, module);
-
-            if (moduleEndPosition == -1) {
-                // 使用下一个模块开始位置作为边界
-                moduleEndPosition = getNextModulePosition(modules, module);
-            }
-
-            // 🔧 FIX: 检查光标是否在模块范围内
-            if (cursorPosition < moduleEndPosition) {
-                return module.symbolName;
-            }
-        }
-    }
-
-    return QString(); // 不在任何模块内
-}
-
 int CompletionManager::findSymbolIdByName(const QString& symbolName)
 {
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> symbols = symbolList->findSymbolsByName(symbolName);
-
-    if (!symbols.isEmpty()) {
-        return symbols.first().symbolId;
-    }
-
-    return -1;
+    // 🚀 原子查找，不物化 SymbolInfo
+    return sym_list::getInstance()->findSymbolIdByName(symbolName);
 }
 
 void CompletionManager::updateRelationshipCaches()
@@ -1624,15 +1487,8 @@ void CompletionManager::updateRelationshipCaches()
         return;
     }
 
-    // 🚀 构建符号到模块的映射缓存
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        if (!symbol.moduleScope.isEmpty()) {
-            symbolToModuleCache[symbol.symbolName] = symbol.moduleScope;
-        }
-    }
+    // 🚀 构建符号到模块的映射缓存(原子键，直接读取各分片的整型列)
+    symbolToModuleCache = sym_list::getInstance()->getSymbolScopeAtoms();
 
     relationshipCacheValid = true;
 }
@@ -1644,17 +1500,18 @@ QStringList CompletionManager::filterCompletionsByContext(const QStringList& com
     if (context == "assignment") {
         // 在赋值上下文中，优先显示变量
         QStringList filtered;
-        sym_list* symbolList = sym_list::getInstance();
+        const auto snapshot = sym_list::getInstance()->getSnapshot();
 
         for (const QString& completion : completions) {
-            QList<sym_list::SymbolInfo> symbols = symbolList->findSymbolsByName(completion);
-            for (const sym_list::SymbolInfo& symbol : qAsConst(symbols)) {
-                if (symbol.symbolType == sym_list::sym_reg ||
-                    symbol.symbolType == sym_list::sym_wire ||
-                    symbol.symbolType == sym_list::sym_logic) {
-                    filtered.append(completion);
-                    break;
-                }
+            bool isVariable = false;
+            snapshot->forEachNamed(completion, [&](const SymbolRef& symbol) {
+                isVariable = isVariable ||
+                             symbol.type() == sym_list::sym_reg ||
+                             symbol.type() == sym_list::sym_wire ||
+                             symbol.type() == sym_list::sym_logic;
+            });
+            if (isVariable) {
+                filtered.append(completion);
             }
         }
 
@@ -1714,9 +1571,14 @@ int CompletionManager::calculateScopeScore(const QString& symbol, const QString&
         return 0;
     }
 
-    // 🚀 如果符号在当前模块作用域内，给予额外评分
-    if (symbolToModuleCache.contains(symbol) &&
-        symbolToModuleCache[symbol] == currentModule) {
+    // 🚀 如果符号在当前模块作用域内，给予额外评分(原子比较)
+    const AtomTable* atoms = AtomTable::getInstance();
+    const AtomTable::Atom moduleAtom = atoms->lookup(currentModule);
+    if (moduleAtom == AtomTable::NoAtom) {
+        return 0;
+    }
+
+    if (symbolToModuleCache.value(atoms->lookup(symbol), AtomTable::NoAtom) == moduleAtom) {
         return 20;
     }
 
@@ -1737,35 +1599,29 @@ QStringList CompletionManager::getModuleInternalVariables(const QString& moduleN
         return QStringList();
     }
 
-    QStringList results;
     sym_list* symbolList = sym_list::getInstance();
+    const auto snapshot = symbolList->getSnapshot();
 
-    // 🚀 方法1：通过 moduleScope 字段过滤
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
+    // 🚀 方法1：通过 moduleScope 字段过滤。各前缀树按 (作用域, 类型) 掩码剪枝，归并后已去重、按名称排序
+    static const SymbolNameTrie::TypeMask internalTypes = SymbolNameTrie::typeBits({
+        sym_list::sym_reg,
+        sym_list::sym_wire,
+        sym_list::sym_logic,
+        sym_list::sym_localparam,
+        sym_list::sym_parameter
+    });
 
-    int logicCount = 0;
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        if (symbol.symbolType == sym_list::sym_logic) {
-            logicCount++;
-            if (logicCount >= 10) break; // 只显示前10个避免输出太多
-        }
+    QStringList results;
+    const AtomTable::Atom moduleAtom = AtomTable::find(moduleName);
+    if (moduleAtom != AtomTable::NoAtom) {
+        results = snapshot->nameIndex().namesWithPrefixInScope(prefix, internalTypes, moduleAtom);
     }
-
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 检查是否属于指定模块且为内部变量类型
-        if (symbol.moduleScope == moduleName &&
-            isInternalVariableType(symbol.symbolType)) {
-
-            // 前缀匹配
-            if (prefix.isEmpty() ||
-                symbol.symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
-                results.append(symbol.symbolName);
-            }
-        }
+    if (!results.isEmpty()) {
+        return results;
     }
 
     // 🚀 方法2：如果 moduleScope 字段为空，使用关系引擎
-    if (results.isEmpty() && relationshipEngine) {
+    if (relationshipEngine) {
         int moduleId = findSymbolIdByName(moduleName);
         if (moduleId != -1) {
             QList<int> childrenIds = relationshipEngine->getModuleChildren(moduleId);
@@ -1782,7 +1638,7 @@ QStringList CompletionManager::getModuleInternalVariables(const QString& moduleN
         }
     }
 
-    // 去重并排序
+    // 关系引擎给出的子符号需要去重并排序
     results.removeDuplicates();
     results.sort(Qt::CaseInsensitive);
 
@@ -1801,132 +1657,58 @@ bool CompletionManager::isInternalVariableType(sym_list::sym_type_e symbolType)
 
 QStringList CompletionManager::getGlobalSymbolCompletions(const QString& prefix)
 {
-    QStringList results;
-    sym_list* symbolList = sym_list::getInstance();
-
     // 🚀 只返回模块声明、任务、函数等全局符号
-    QList<sym_list::sym_type_e> globalTypes = {
+    static const SymbolNameTrie::TypeMask globalTypes = SymbolNameTrie::typeBits({
         sym_list::sym_module,
         sym_list::sym_task,
         sym_list::sym_function,
         sym_list::sym_interface,
         sym_list::sym_package
-    };
-
-    for (sym_list::sym_type_e type : globalTypes) {
-        QList<sym_list::SymbolInfo> symbols = symbolList->findSymbolsByType(type);
-
-        for (const sym_list::SymbolInfo& symbol : symbols) {
-            if (prefix.isEmpty() ||
-                symbol.symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
-                results.append(symbol.symbolName);
-            }
-        }
-    }
+    });
 
-    // 去重并排序
-    results.removeDuplicates();
-    results.sort(Qt::CaseInsensitive);
-
-    // 限制数量避免过多
-    if (results.size() > 15) {
-        results = results.mid(0, 15);
-    }
-
-    return results;
+    // 前缀树按类型掩码剪枝、按名称顺序给出，取够 15 个即停(限制数量避免过多)
+    return sym_list::getInstance()->getSnapshot()->nameIndex().namesWithPrefix(prefix, globalTypes, 15);
 }
 
 QStringList CompletionManager::getModuleInternalVariablesByType(const QString& moduleName,
                                                                sym_list::sym_type_e symbolType,
                                                                const QString& prefix) {
     QStringList results;
-    sym_list* symbolList = sym_list::getInstance();
 
     if (moduleName.isEmpty()) {
         return results;
     }
 
-    // 🔧 FIX: 强化过滤逻辑，添加额外验证
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    int matchedCount = 0;
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 严格的过滤条件
-        bool isCorrectModule = (symbol.moduleScope == moduleName);
-        bool isCorrectType = (symbol.symbolType == symbolType);
-        // 🚀 使用模糊匹配功能（支持前缀匹配、包含匹配和缩写匹配）
-        bool matchesPrefix = (prefix.isEmpty() ||
-                             matchesAbbreviation(symbol.symbolName, prefix));
-
-        if (isCorrectModule && isCorrectType && matchesPrefix) {
-            results.append(symbol.symbolName);
-            matchedCount++;
-        }
+    for (const sym_list::SymbolInfo& symbol : getCommandModeSymbols(moduleName, symbolType, prefix)) {
+        results.append(symbol.symbolName);
     }
-
-    results.removeDuplicates();
-    results.sort(Qt::CaseInsensitive);
     return results;
 }
 
-int CompletionManager::getNextModulePosition(const QList<sym_list::SymbolInfo>& modules,
-                                            const sym_list::SymbolInfo& currentModule)
+int CompletionManager::findEndModulePosition(const sym_list::SymbolInfo& moduleSymbol)
 {
-    for (int i = 0; i < modules.size(); ++i) {
-        if (modules[i].symbolId == currentModule.symbolId && i < modules.size() - 1) {
-            return modules[i + 1].position;
-        }
+    // 🚀 查询模块区间表：endmodule 之后的位置，未闭合时返回 -1
+    const ScopeTree spans = sym_list::getInstance()->getScopeTree(moduleSymbol.fileName);
+    const int index = spans.spanStartingAt(moduleSymbol.position);
+    if (index < 0 || !spans.at(index).isClosed()) {
+        return -1;
     }
-    return INT_MAX; // 如果是最后一个模块，返回最大值
-}
-
-int CompletionManager::findEndModulePosition(
-    const QString& fileContent,
-    const sym_list::SymbolInfo& moduleSymbol)
-{
-    int searchStart = moduleSymbol.position;
-    int moduleDepth = 0;
-    bool foundModule = false;
-
-    QRegExp moduleStartPattern("\\bmodule\\s+");
-    QRegExp moduleEndPattern("\\bendmodule\\b");
-
-    int pos = searchStart;
-    while (pos < fileContent.length()) {
-        int nextModuleStart = moduleStartPattern.indexIn(fileContent, pos);
-        int nextModuleEnd = moduleEndPattern.indexIn(fileContent, pos);
-
-        if (nextModuleStart != -1 &&
-            (nextModuleEnd == -1 || nextModuleStart < nextModuleEnd)) {
-            // 处理嵌套模块
-            if (foundModule || nextModuleStart == moduleSymbol.position) {
-                moduleDepth++;
-                foundModule = true;
-            }
-            pos = nextModuleStart + moduleStartPattern.matchedLength();
-        } else if (nextModuleEnd != -1) {
-            if (foundModule) {
-                moduleDepth--;
-                if (moduleDepth == 0) {
-                    return nextModuleEnd + moduleEndPattern.matchedLength();
-                }
-            }
-            pos = nextModuleEnd + moduleEndPattern.matchedLength();
-        } else {
-            break;
-        }
-    }
-
-    return -1;
+    return spans.at(index).endPosition;
 }
 
 QStringList CompletionManager::getGlobalSymbolsByType(sym_list::sym_type_e symbolType,
                                                      const QString& prefix)
 {
     QStringList results;
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
+    for (const sym_list::SymbolInfo& symbol : getGlobalSymbolsByType_Info(symbolType, prefix)) {
+        results.append(symbol.symbolName);
+    }
+    return results;
+}
 
+QList<sym_list::SymbolInfo> CompletionManager::getGlobalSymbolsByType_Info(sym_list::sym_type_e symbolType,
+                                                                          const QString& prefix)
+{
     // 🔧 FIX: 全局符号类型定义
     QList<sym_list::sym_type_e> globalSymbolTypes = {
         sym_list::sym_module,
@@ -1940,49 +1722,60 @@ QStringList CompletionManager::getGlobalSymbolsByType(sym_list::sym_type_e symbo
 
     // 🔧 FIX: 检查是否为全局符号类型
     if (!globalSymbolTypes.contains(symbolType)) {
-        return results;
+        return QList<sym_list::SymbolInfo>();
     }
 
-    int foundCount = 0;
-    int totalSymbolsOfType = 0;
+    // 🔧 FIX: 全局符号应该没有 moduleScope 或者 moduleScope 为空
+    // 对于某些符号类型（如 module, interface），它们本身就是顶级声明
+    const bool isTopLevelType = (symbolType == sym_list::sym_module ||
+                                 symbolType == sym_list::sym_interface ||
+                                 symbolType == sym_list::sym_package);
 
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 🔧 FIX: 统计指定类型的所有符号
-        if (symbol.symbolType == symbolType) {
-            totalSymbolsOfType++;
-        }
-
-        // 🔧 FIX: 只返回指定类型的全局符号
-        if (symbol.symbolType == symbolType) {
-            // 🔧 FIX: 全局符号应该没有 moduleScope 或者 moduleScope 为空
-            // 对于某些符号类型（如 module, interface），它们本身就是顶级声明
-            bool isGlobalSymbol = false;
-
-            if (symbolType == sym_list::sym_module ||
-                symbolType == sym_list::sym_interface ||
-                symbolType == sym_list::sym_package) {
-                // 这些类型本身就是全局的
-                isGlobalSymbol = true;
-            } else {
-                // 其他类型需要检查是否在模块外部声明
-                isGlobalSymbol = symbol.moduleScope.isEmpty();
-            }
+    // 🚀 只取指定类型的符号（类型索引），其他类型取空作用域下的该类型符号（组合索引）
+    return collectCommandModeSymbols(symbolType, QString(), isTopLevelType, prefix);
+}
 
-            if (isGlobalSymbol) {
-                // 🚀 使用模糊匹配功能（支持前缀匹配、包含匹配和缩写匹配）
-                if (prefix.isEmpty() || matchesAbbreviation(symbol.symbolName, prefix)) {
-                    results.append(symbol.symbolName);
-                    foundCount++;
-                }
-            }
-        }
+QList<sym_list::SymbolInfo> CompletionManager::getCommandModeSymbols(const QString& moduleName,
+                                                                    sym_list::sym_type_e symbolType,
+                                                                    const QString& prefix)
+{
+    if (moduleName.isEmpty()) {
+        return getGlobalSymbolsByType_Info(symbolType, prefix);
     }
+    return collectCommandModeSymbols(symbolType, moduleName, false, prefix);
+}
 
-    // 去重并排序
-    results.removeDuplicates();
-    results.sort(Qt::CaseInsensitive);
+// 按类型(anyScope)或 (作用域, 类型) 收集匹配前缀的符号，同名只保留第一个，按名称排序
+QList<sym_list::SymbolInfo> CompletionManager::collectCommandModeSymbols(sym_list::sym_type_e symbolType,
+                                                                        const QString& scope, bool anyScope,
+                                                                        const QString& prefix)
+{
+    QList<sym_list::SymbolInfo> results;
+    QSet<AtomTable::Atom> seenNames;
+
+    auto collect = [&](const SymbolRef& symbol) {
+        if (seenNames.contains(symbol.nameAtom())) {
+            return;
+        }
+        // 🚀 使用模糊匹配功能（支持前缀匹配、包含匹配和缩写匹配）
+        const QString symbolName = symbol.name();
+        if (prefix.isEmpty() || matchesAbbreviation(symbolName, prefix)) {
+            seenNames.insert(symbol.nameAtom());
+            results.append(symbol.toSymbolInfo());
+        }
+    };
 
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
+    if (anyScope) {
+        snapshot->forEachOfType(symbolType, collect);
+    } else {
+        snapshot->forEachOfTypeInScope(symbolType, scope, collect);
+    }
 
+    std::sort(results.begin(), results.end(),
+              [](const sym_list::SymbolInfo& a, const sym_list::SymbolInfo& b) {
+        return a.symbolName.compare(b.symbolName, Qt::CaseInsensitive) < 0;
+    });
     return results;
 }
 
@@ -2059,20 +1852,12 @@ QList<sym_list::SymbolInfo> CompletionManager::getModuleInternalSymbolsByType(
     QList<sym_list::SymbolInfo> results;
     sym_list* symbolList = sym_list::getInstance();
 
-    // 🚀 直接搜索并返回 SymbolInfo，避免字符串转换
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
-
-    for (const sym_list::SymbolInfo& symbol : allSymbols) {
-        // 过滤条件
-        if (symbol.moduleScope == moduleName &&
-            isSymbolTypeMatchCommand(symbol.symbolType, symbolType)) {
-
-            if (prefix.isEmpty() ||
-                symbol.symbolName.startsWith(prefix, Qt::CaseInsensitive)) {
-                results.append(symbol);
-            }
+    // 🚀 先在列上比较名称前缀，只物化命中的 SymbolInfo
+    symbolList->getSnapshot()->forEachOfTypeInScope(symbolType, moduleName, [&](const SymbolRef& symbol) {
+        if (symbol.nameStartsWith(prefix, Qt::CaseInsensitive)) {
+            results.append(symbol.toSymbolInfo());
         }
-    }
+    });
 
     // 🚀 如果 moduleScope 为空，使用关系引擎
     if (results.isEmpty() && relationshipEngine) {
@@ -2102,19 +1887,19 @@ QStringList CompletionManager::getEnumValueCompletions(const QString& prefix,
                                                       const QString& enumTypeName)
 {
     QStringList results;
-    sym_list* symList = sym_list::getInstance();
-
-    for (const auto& symbol : symList->getAllSymbols()) {
-        if (symbol.symbolType == sym_list::sym_enum_value) {
-            // 如果指定了枚举类型，只返回该类型的值
-            if (!enumTypeName.isEmpty() && symbol.moduleScope != enumTypeName) {
-                continue;
-            }
-
-            if (prefix.isEmpty() || matchesAbbreviation(symbol.symbolName, prefix)) {
-                results.append(symbol.symbolName);
-            }
+    auto collect = [&](const SymbolRef& symbol) {
+        const QString symbolName = symbol.name();
+        if (prefix.isEmpty() || matchesAbbreviation(symbolName, prefix)) {
+            results.append(symbolName);
         }
+    };
+
+    // 如果指定了枚举类型，只返回该类型的值（枚举值的 moduleScope 保存所属枚举类型名）
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
+    if (enumTypeName.isEmpty()) {
+        snapshot->forEachOfType(sym_list::sym_enum_value, collect);
+    } else {
+        snapshot->forEachOfTypeInScope(sym_list::sym_enum_value, enumTypeName, collect);
     }
 
     results.removeDuplicates();
@@ -2127,19 +1912,19 @@ QStringList CompletionManager::getStructMemberCompletions(const QString& prefix,
                                                          const QString& structTypeName)
 {
     QStringList results;
-    sym_list* symList = sym_list::getInstance();
-
-    for (const auto& symbol : symList->getAllSymbols()) {
-        if (symbol.symbolType == sym_list::sym_struct_member) {
-            // 如果指定了结构体类型，只返回该类型的成员
-            if (!structTypeName.isEmpty() && symbol.moduleScope != structTypeName) {
-                continue;
-            }
-
-            if (prefix.isEmpty() || matchesAbbreviation(symbol.symbolName, prefix)) {
-                results.append(symbol.symbolName);
-            }
+    auto collect = [&](const SymbolRef& symbol) {
+        const QString symbolName = symbol.name();
+        if (prefix.isEmpty() || matchesAbbreviation(symbolName, prefix)) {
+            results.append(symbolName);
         }
+    };
+
+    // 如果指定了结构体类型，只返回该类型的成员
+    const auto snapshot = sym_list::getInstance()->getSnapshot();
+    if (structTypeName.isEmpty()) {
+        snapshot->forEachOfType(sym_list::sym_struct_member, collect);
+    } else {
+        snapshot->forEachOfTypeInScope(sym_list::sym_struct_member, structTypeName, collect);
     }
 
     results.removeDuplicates();
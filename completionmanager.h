@@ -10,6 +10,10 @@
 #include <QSet>
 #include <memory>
 #include "syminfo.h"
+#include "atomtable.h"
+#include "symbolnameindex.h"
+#include "boundedcache.h"
+#include "completionsession.h"
 
 class SymbolRelationshipEngine; // 🚀 NEW: 前向声明
 class SmartRelationshipBuilder;  // 🚀 NEW: 前向声明
@@ -47,6 +51,10 @@ public:
         sym_list::sym_type_e symbolType, const QString& prefix);
 
     QVector<QPair<QString, int>> getScoredAllSymbolMatches(const QString& prefix);
+
+    // 🚀 NEW: 补全会话锚定在编辑器的单词起点；会话期间全符号评分逐级收窄，单词结束或补全框关闭时结束
+    void beginCompletionSession(const QString& fileName, int wordStartPos);
+    void endCompletionSession();
     QStringList getAllSymbolCompletions(const QString& prefix);
 
     QStringList getKeywordCompletions(const QString& prefix);
@@ -79,6 +87,18 @@ public:
     void invalidateRelationshipCaches();
     void refreshRelationshipData();
 
+    // 🚀 NEW: 匹配/评分缓存均为定长 CLOCK 缓存，容量可调，命中统计用于调优
+    enum CacheKind {
+        SingleMatchCache,
+        SingleScoreCache,
+        PositionCache,
+        SymbolScoreCache,
+        AllSymbolScoreCache
+    };
+    void setCacheCapacity(CacheKind cache, int capacity);   // 清空该缓存
+    BoundedCacheStats cacheStats(CacheKind cache) const;
+    void resetCacheStats();
+
     QString getCurrentModule(const QString& fileName, int cursorPosition);
     QStringList getModuleInternalVariables(const QString& moduleName, const QString& prefix);
     QStringList getGlobalSymbolCompletions(const QString& prefix);
@@ -100,7 +120,13 @@ public:
 
     QList<sym_list::SymbolInfo> getGlobalSymbolsByType_Info(sym_list::sym_type_e symbolType,
                                                             const QString& prefix = "");
-    int findEndModulePosition(const QString &fileContent, const sym_list::SymbolInfo &moduleSymbol);
+
+    // 🚀 NEW: 命令模式补全(r/w/l/m/t/f)：模块内走 (作用域, 类型) 索引，模块外取全局符号；
+    // 每个名称取一个符号，按名称排序，调用方不必再按名称回查符号库
+    QList<sym_list::SymbolInfo> getCommandModeSymbols(const QString& moduleName,
+                                                      sym_list::sym_type_e symbolType,
+                                                      const QString& prefix = "");
+    int findEndModulePosition(const sym_list::SymbolInfo &moduleSymbol);
     void invalidateCommandModeCache();
 
 
@@ -109,7 +135,27 @@ private:
 
     static std::unique_ptr<CompletionManager> instance;
 
-    bool isValidAbbreviationMatch(const QString &text, const QString &abbreviation);
+    // 🚀 缓存键：主体(名称原子或符号类型) + 查询串的64位哈希，探测时不拼接字符串
+    struct QueryKey {
+        quint32 subject;
+        quint64 query;
+
+        bool operator==(const QueryKey& other) const
+        {
+            return subject == other.subject && query == other.query;
+        }
+        friend uint qHash(const QueryKey& key, uint seed = 0)
+        {
+            return ::qHash(key.query, seed) ^ key.subject;
+        }
+    };
+
+    static quint64 queryHash(const QString& query);
+    static bool nameKey(const QString& text, const QString& abbreviation, QueryKey& key);
+
+    QList<sym_list::SymbolInfo> collectCommandModeSymbols(sym_list::sym_type_e symbolType,
+                                                          const QString& scope, bool anyScope,
+                                                          const QString& prefix);
 
     QStringList svKeywords;
     bool keywordsInitialized = false;
@@ -117,7 +163,7 @@ private:
     QHash<QString, QVector<QPair<QString, int>>> keywordScoreCache;
 
     QHash<sym_list::sym_type_e, QList<sym_list::SymbolInfo>> symbolTypeCache;
-    QHash<QString, QVector<QPair<sym_list::SymbolInfo, int>>> symbolScoreCache;
+    BoundedCache<QueryKey, QVector<QPair<sym_list::SymbolInfo, int>>> symbolScoreCache{256};   // (类型, 前缀)
     int lastSymbolDatabaseSize = 0;
     QString lastSymbolDatabaseHash;
 
@@ -125,15 +171,17 @@ private:
     QHash<QString, QStringList> precomputedPrefixMatches;
     bool precomputedDataValid = false;
 
-    QHash<QString, QVector<QPair<QString, int>>> allSymbolScoreCache;
+    BoundedCache<quint64, QVector<QPair<QString, int>>> allSymbolScoreCache{256};             // 前缀哈希
     QHash<QString, QStringList> allSymbolMatchCache;
-    QStringList cachedAllSymbolNames;
+    SymbolNameIndex allSymbolNames;         // 🚀 全部名称的前缀索引(各分片前缀树的集合)
+    quint64 allSymbolNamesVersion = 0;      // 名称索引所属的快照版本
+    CompletionSession completionSession;
     bool allSymbolsCacheValid = false;
 
-    // 单个匹配结果缓存
-    QHash<QString, bool> singleMatchCache;
-    QHash<QString, int> singleScoreCache;
-    QHash<QString, QList<int>> positionCache;
+    // 单个匹配结果缓存：(名称原子, 缩写哈希)
+    BoundedCache<QueryKey, bool> singleMatchCache{4096};
+    BoundedCache<QueryKey, int> singleScoreCache{4096};
+    BoundedCache<QueryKey, QList<int>> positionCache{1024};
 
     // 🚀 智能缓存控制
     bool smartCachingEnabled = true;
@@ -148,7 +196,7 @@ private:
     QHash<QString, QStringList> symbolRelationsCache;      // 符号名 -> 相关符号列表
     QHash<QString, QStringList> clockDomainCache;          // 时钟域缓存
     QHash<QString, QStringList> resetSignalCache;          // 复位信号缓存
-    QHash<QString, QString> symbolToModuleCache;           // 符号 -> 所属模块映射
+    QHash<AtomTable::Atom, AtomTable::Atom> symbolToModuleCache;   // 符号原子 -> 所属模块原子
     bool relationshipCacheValid = false;
 
     // ===== 辅助方法 =====
@@ -157,9 +205,7 @@ private:
     bool isSymbolCacheValid();
     QString calculateSymbolDatabaseHash();
 
-    QString buildSingleMatchKey(const QString &text, const QString &abbreviation);
     QString buildKeywordCacheKey(const QString &prefix);
-    QString buildSymbolCacheKey(sym_list::sym_type_e symbolType, const QString &prefix);
 
     // 🚀 优化的匹配方法
     QVector<QPair<QString, int>> calculateScoredMatches(const QStringList &candidates, const QString &abbreviation);
@@ -188,9 +234,6 @@ private:
     QStringList getBasicSymbolCompletions(const QString &prefix);
 
     bool isInternalVariableType(sym_list::sym_type_e symbolType);
-    QString findModuleAtPosition(const QList<sym_list::SymbolInfo>& modules,
-                               int cursorPosition,
-                               const QString& fileName);
 
     // 🚀 新增：检查符号类型是否匹配命令
     bool isSymbolTypeMatchCommand(sym_list::sym_type_e symbolType,
@@ -206,8 +249,6 @@ private:
 
     QString getSymbolTypeName(sym_list::sym_type_e symbolType);
 
-    int getNextModulePosition(const QList<struct sym_list::SymbolInfo>& modules,
-                              const struct sym_list::SymbolInfo& currentModule);
     QStringList getEnumValueCompletions(const QString &prefix, const QString &enumTypeName);
     QStringList getStructMemberCompletions(const QString &prefix, const QString &structTypeName);
     QString extractStructTypeFromContext(const QString &context);
@@ -0,0 +1,97 @@
+#include "completionsession.h"
+
+#include "abbreviationmatcher.h"
+
+#include <QSet>
+
+void CompletionSession::begin(const QString& fileName, int wordStartPos)
+{
+    if (isAnchoredAt(fileName, wordStartPos)) {
+        return;
+    }
+
+    reset();
+    active = true;
+    anchorFile = fileName;
+    anchorPosition = wordStartPos;
+}
+
+void CompletionSession::reset()
+{
+    active = false;
+    anchorFile.clear();
+    anchorPosition = -1;
+    levels.clear();
+}
+
+bool CompletionSession::isAnchoredAt(const QString& fileName, int wordStartPos) const
+{
+    return active && anchorPosition == wordStartPos && anchorFile == fileName;
+}
+
+const QVector<CompletionSession::Candidate>& CompletionSession::candidates(const SymbolNameIndex& names,
+                                                                          quint64 version,
+                                                                          const QString& prefix)
+{
+    static const QVector<Candidate> none;
+
+    // 名称表换了版本，条目下标不再有效
+    if (namesVersion != version) {
+        levels.clear();
+        namesVersion = version;
+    }
+
+    // 空前缀不打分，也不能作为收窄的起点
+    if (prefix.isEmpty()) {
+        return none;
+    }
+
+    // 得分只取决于折叠后的前缀。退格或改写时弹出不再是当前前缀之前缀的层
+    const QString folded = prefix.toLower();
+    while (!levels.isEmpty() && !folded.startsWith(levels.last().prefix)) {
+        levels.removeLast();
+    }
+    if (!levels.isEmpty() && levels.last().prefix == folded) {
+        return levels.last().survivors;
+    }
+
+    const AbbreviationMatcher::Query query = AbbreviationMatcher::queryOf(prefix);
+    Level level;
+    level.prefix = folded;
+
+    auto scoreOf = [&](const SymbolNameTrie& trie, int entry) {
+        const AbbreviationMatcher::Signature& signature = trie.signatureAt(entry);
+        if (!AbbreviationMatcher::mayMatch(signature, query)) {
+            return 0;
+        }
+        return AbbreviationMatcher::score(trie.nameAt(entry), signature, query);
+    };
+
+    if (levels.isEmpty()) {
+        // 第一级：全量扫描，缺字符的名称一次掩码测试即排除；同名出现在多个文件中时只保留一个
+        QSet<AtomTable::Atom> seen;
+        for (int trieIndex = 0; trieIndex < names.trieCount(); ++trieIndex) {
+            const SymbolNameTrie& trie = names.trieAt(trieIndex);
+            for (int entry = 0; entry < trie.size(); ++entry) {
+                const int score = scoreOf(trie, entry);
+                if (score > 0 && !seen.contains(trie.atomAt(entry))) {
+                    seen.insert(trie.atomAt(entry));
+                    level.survivors.append(Candidate{ trieIndex, entry, score });
+                }
+            }
+        }
+    } else {
+        // 🚀 之后每一级只在上一层幸存者中重新打分
+        const QVector<Candidate>& previous = levels.last().survivors;
+        level.survivors.reserve(previous.size());
+        for (const Candidate& candidate : previous) {
+            const int score = scoreOf(names.trieAt(candidate.trie), candidate.entry);
+            if (score > 0) {
+                level.survivors.append(Candidate{ candidate.trie, candidate.entry, score });
+            }
+        }
+    }
+
+    levels.append(level);
+    return levels.last().survivors;
+}
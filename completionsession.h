@@ -0,0 +1,47 @@
+#ifndef COMPLETIONSESSION_H
+#define COMPLETIONSESSION_H
+
+#include <QString>
+#include <QVector>
+
+#include "symbolnameindex.h"
+
+// 🚀 前缀逐步收窄的补全会话
+// 会话锚定在编辑器正在补全的单词起点(文件 + wordStartPos)，按输入的每一级前缀保存一层幸存候选及其得分。
+// 缩写(子序列)匹配对前缀单调：扩展后的前缀能匹配的名称，必然也能匹配原前缀，
+// 因此继续输入时只需在上一层幸存者中重新打分；退格时弹回已缓存的较短一级，不必重算。
+// 每次按键的开销与上一层幸存者数量成正比，与工作区符号总数无关。
+// 名称表(快照版本)变化或锚点移动时会话整体失效。
+class CompletionSession
+{
+public:
+    struct Candidate {
+        int trie;       // SymbolNameIndex 中的前缀树下标
+        int entry;      // 该树的条目下标
+        int score;
+    };
+
+    void begin(const QString& fileName, int wordStartPos);
+    void reset();
+    bool isActive() const { return active; }
+    bool isAnchoredAt(const QString& fileName, int wordStartPos) const;
+
+    // prefix 的全部幸存候选(未排序)。names/version 标识候选所在的名称表
+    const QVector<Candidate>& candidates(const SymbolNameIndex& names, quint64 version, const QString& prefix);
+
+    int depth() const { return levels.size(); }
+
+private:
+    struct Level {
+        QString prefix;     // 折叠小写后的前缀
+        QVector<Candidate> survivors;
+    };
+
+    bool active = false;
+    QString anchorFile;
+    int anchorPosition = -1;
+    quint64 namesVersion = 0;
+    QVector<Level> levels;
+};
+
+#endif // COMPLETIONSESSION_H
@@ -10,8 +10,14 @@ CONFIG += c++14
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    abbreviationmatcher.cpp \
+    atomtable.cpp \
+    commentmask.cpp \
     completionmanager.cpp \
     completionmodel.cpp \
+    completionsession.cpp \
+    linefingerprinttable.cpp \
+    lineoffsettable.cpp \
     main.cpp \
     mainwindow.cpp \
     modemanager.cpp \
@@ -20,16 +26,36 @@ SOURCES += \
     navigationmanager.cpp \
     navigationwidget.cpp \
     relationshipprogressdialog.cpp \
+    scopetree.cpp \
     smartrelationshipbuilder.cpp \
+    snapshottables.cpp \
+    svdeclarationparser.cpp \
+    svpatternregistry.cpp \
+    svlexer.cpp \
     symbolanalyzer.cpp \
+    symbolindexcache.cpp \
+    symbolnameindex.cpp \
+    symbolnametrie.cpp \
     symbolrelationshipengine.cpp \
+    symbolshard.cpp \
+    symbolsnapshot.cpp \
+    symbolstore.cpp \
     syminfo.cpp \
     tabmanager.cpp \
+    textscanner.cpp \
+    workspaceindexer.cpp \
     workspacemanager.cpp
 
 HEADERS += \
+    abbreviationmatcher.h \
+    atomtable.h \
+    boundedcache.h \
+    commentmask.h \
     completionmanager.h \
     completionmodel.h \
+    completionsession.h \
+    linefingerprinttable.h \
+    lineoffsettable.h \
     mainwindow.h \
     modemanager.h \
     mycodeeditor.h \
@@ -37,11 +63,24 @@ HEADERS += \
     navigationmanager.h \
     navigationwidget.h \
     relationshipprogressdialog.h \
+    scopetree.h \
     smartrelationshipbuilder.h \
+    snapshottables.h \
+    svdeclarationparser.h \
+    svpatternregistry.h \
+    svlexer.h \
     symbolanalyzer.h \
+    symbolindexcache.h \
+    symbolnameindex.h \
+    symbolnametrie.h \
     symbolrelationshipengine.h \
+    symbolshard.h \
+    symbolsnapshot.h \
+    symbolstore.h \
     syminfo.h \
     tabmanager.h \
+    textscanner.h \
+    workspaceindexer.h \
     workspacemanager.h
 
 FORMS += \
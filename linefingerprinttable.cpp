@@ -0,0 +1,161 @@
+#include "linefingerprinttable.h"
+#include "textscanner.h"
+
+LineFingerprintTable::LineFingerprintTable(const QString& text)
+{
+    build(text);
+}
+
+void LineFingerprintTable::build(const QString& text)
+{
+    // 行的划分与 LineOffsetTable 一致：n 个换行符对应 n + 1 行
+    hashes.clear();
+    hashes.reserve(text.size() / 32 + 1);
+
+    const QChar* data = text.constData();
+    const int size = text.size();
+    int lineStart = 0;
+    int lineEnd;
+    while ((lineEnd = TextScanner::indexOf(data, lineStart, size, '\n')) < size) {
+        hashes.append(hashLine(data + lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+    hashes.append(hashLine(data + lineStart, size - lineStart));
+
+    // 表会长期缓存，释放按估计行数预留的多余容量
+    hashes.squeeze();
+}
+
+quint64 LineFingerprintTable::hashLine(const QChar* data, int length)
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    for (int i = 0; i < length; ++i) {
+        const ushort unit = data[i].unicode();
+        hash ^= unit & 0xFF;
+        hash *= Q_UINT64_C(1099511628211);
+        hash ^= unit >> 8;
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+bool LineFingerprintTable::diff(const LineFingerprintTable& oldTable, const LineFingerprintTable& newTable,
+                                QVector<Hunk>& hunks, int maxEdits)
+{
+    hunks.clear();
+
+    const QVector<quint64>& a = oldTable.hashes;
+    const QVector<quint64>& b = newTable.hashes;
+
+    // 先去掉公共前后缀，通常只剩编辑附近的少数几行
+    int prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && a.at(prefix) == b.at(prefix)) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+           a.at(a.size() - 1 - suffix) == b.at(b.size() - 1 - suffix)) {
+        ++suffix;
+    }
+
+    const int n = a.size() - prefix - suffix;
+    const int m = b.size() - prefix - suffix;
+    if (n == 0 && m == 0) {
+        return true;
+    }
+
+    // Myers O(ND)：v[k] 为对角线 k = x - y 上走得最远的 x；
+    // 第 d 步开始前把 v[-(d-1) .. d-1] 存入 trace，起点为 (d-1)^2，回溯时用来找上一步的位置
+    const int maxD = qMin(maxEdits, n + m);
+    const int offset = maxD + 1;
+    QVector<int> v(2 * maxD + 3, 0);
+    QVector<int> trace;
+
+    int editDistance = -1;
+    for (int d = 0; d <= maxD && editDistance < 0; ++d) {
+        for (int k = -(d - 1); k <= d - 1 && d > 0; ++k) {
+            trace.append(v.at(k + offset));
+        }
+
+        for (int k = -d; k <= d; k += 2) {
+            int x;
+            if (k == -d || (k != d && v.at(k - 1 + offset) < v.at(k + 1 + offset))) {
+                x = v.at(k + 1 + offset);           // 向下：插入新行
+            } else {
+                x = v.at(k - 1 + offset) + 1;       // 向右：删除旧行
+            }
+            int y = x - k;
+            while (x < n && y < m && a.at(prefix + x) == b.at(prefix + y)) {
+                ++x;
+                ++y;
+            }
+            v[k + offset] = x;
+
+            if (x >= n && y >= m) {
+                editDistance = d;
+                break;
+            }
+        }
+    }
+
+    if (editDistance < 0) {
+        return false;
+    }
+
+    // 回溯，标记删除的旧行与插入的新行
+    QVector<bool> removed(n, false);
+    QVector<bool> inserted(m, false);
+    int x = n;
+    int y = m;
+    for (int d = editDistance; d > 0; --d) {
+        const int base = (d - 1) * (d - 1) + (d - 1);   // trace 中 k = 0 的下标
+        const int k = x - y;
+
+        int previousK;
+        if (k == -d || (k != d && trace.at(base + k - 1) < trace.at(base + k + 1))) {
+            previousK = k + 1;
+        } else {
+            previousK = k - 1;
+        }
+        const int previousX = trace.at(base + previousK);
+        const int previousY = previousX - previousK;
+
+        while (x > previousX && y > previousY) {
+            --x;
+            --y;
+        }
+        if (previousK == k + 1) {
+            inserted[previousY] = true;
+        } else {
+            removed[previousX] = true;
+        }
+        x = previousX;
+        y = previousY;
+    }
+
+    // 相邻的删除/插入合并成一个块
+    int i = 0;
+    int j = 0;
+    while (i < n || j < m) {
+        if ((i < n && removed.at(i)) || (j < m && inserted.at(j))) {
+            Hunk hunk;
+            hunk.oldStart = prefix + i;
+            hunk.newStart = prefix + j;
+            while ((i < n && removed.at(i)) || (j < m && inserted.at(j))) {
+                while (i < n && removed.at(i)) {
+                    ++i;
+                }
+                while (j < m && inserted.at(j)) {
+                    ++j;
+                }
+            }
+            hunk.oldCount = prefix + i - hunk.oldStart;
+            hunk.newCount = prefix + j - hunk.newStart;
+            hunks.append(hunk);
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+    return true;
+}
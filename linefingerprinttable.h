@@ -0,0 +1,44 @@
+#ifndef LINEFINGERPRINTTABLE_H
+#define LINEFINGERPRINTTABLE_H
+
+#include <QString>
+#include <QVector>
+
+// 🚀 每个文件的行指纹表
+// 每行一个64位哈希(FNV-1a，含行首缩进)；文件在磁盘上变化时与上次分析时的指纹做 Myers 行级diff，
+// 得到真正增删的行块。插入一行只产生一个块，其后的行按新行号平移，不再逐行按下标比较。
+class LineFingerprintTable
+{
+public:
+    // 旧文件 [oldStart, oldStart + oldCount) 行被替换为新文件 [newStart, newStart + newCount) 行
+    struct Hunk {
+        int oldStart;
+        int oldCount;
+        int newStart;
+        int newCount;
+    };
+
+    LineFingerprintTable() = default;
+    explicit LineFingerprintTable(const QString& text);
+
+    void build(const QString& text);
+    void clear() { hashes.clear(); }
+
+    bool isEmpty() const { return hashes.isEmpty(); }
+    int lineCount() const { return hashes.size(); }
+    quint64 fingerprint(int line) const { return hashes.at(line); }
+
+    // 占用的堆内存(字节)，用于分析缓存的内存预算
+    qint64 memoryUsage() const { return qint64(hashes.capacity()) * sizeof(quint64); }
+
+    // 按行号顺序返回变化的行块；编辑距离(增删行数)超过 maxEdits 时返回false，调用方应整文件处理
+    static bool diff(const LineFingerprintTable& oldTable, const LineFingerprintTable& newTable,
+                     QVector<Hunk>& hunks, int maxEdits = 1000);
+
+private:
+    QVector<quint64> hashes;
+
+    static quint64 hashLine(const QChar* data, int length);
+};
+
+#endif // LINEFINGERPRINTTABLE_H
@@ -0,0 +1,130 @@
+#include "lineoffsettable.h"
+#include "textscanner.h"
+
+#include <QDataStream>
+#include <algorithm>
+
+LineOffsetTable::LineOffsetTable()
+{
+    lineStarts.append(0);
+}
+
+LineOffsetTable::LineOffsetTable(const QString& text)
+{
+    build(text);
+}
+
+void LineOffsetTable::build(const QString& text)
+{
+    lineStarts.clear();
+    lineStarts.reserve(text.size() / 32 + 1);
+    lineStarts.append(0);
+
+    // 🚀 换行符位置流即行首表(位置 + 1)
+    TextScanner::appendPositions(text.constData(), text.size(), '\n', 1, lineStarts);
+    textLength = text.size();
+}
+
+void LineOffsetTable::clear()
+{
+    lineStarts.clear();
+    lineStarts.append(0);
+    textLength = 0;
+}
+
+void LineOffsetTable::replace(int start, int removedLength, const QString& insertedText)
+{
+    const int removedEnd = start + removedLength;
+    const int delta = insertedText.size() - removedLength;
+
+    // 起点落在 (start, removedEnd] 内的行，其换行符已被删除
+    auto first = std::upper_bound(lineStarts.begin(), lineStarts.end(), start);
+    auto last = std::upper_bound(first, lineStarts.end(), removedEnd);
+
+    QVector<int> newStarts;
+    newStarts.reserve(lineStarts.size() + insertedText.size() / 32);
+    for (auto it = lineStarts.begin(); it != first; ++it) {
+        newStarts.append(*it);
+    }
+
+    TextScanner::appendPositions(insertedText.constData(), insertedText.size(), '\n', start + 1, newStarts);
+
+    for (auto it = last; it != lineStarts.end(); ++it) {
+        newStarts.append(*it + delta);
+    }
+
+    lineStarts.swap(newStarts);
+    textLength += delta;
+}
+
+int LineOffsetTable::lineStart(int line) const
+{
+    if (line < 0 || line >= lineStarts.size()) {
+        return -1;
+    }
+    return lineStarts.at(line);
+}
+
+int LineOffsetTable::lineEnd(int line) const
+{
+    if (line < 0 || line >= lineStarts.size()) {
+        return -1;
+    }
+    return (line + 1 < lineStarts.size()) ? lineStarts.at(line + 1) - 1 : textLength;
+}
+
+int LineOffsetTable::lineForPosition(int position) const
+{
+    const int clamped = qBound(0, position, textLength);
+
+    // 第一个大于position的行首的前一行即为所在行
+    auto it = std::upper_bound(lineStarts.constBegin(), lineStarts.constEnd(), clamped);
+    return static_cast<int>(it - lineStarts.constBegin()) - 1;
+}
+
+void LineOffsetTable::lineColumn(int position, int& line, int& column) const
+{
+    const int clamped = qBound(0, position, textLength);
+    line = lineForPosition(clamped);
+    column = clamped - lineStarts.at(line);
+}
+
+int LineOffsetTable::positionOf(int line, int column) const
+{
+    const int start = lineStart(line);
+    if (start < 0) {
+        return -1;
+    }
+    return qMin(start + qMax(0, column), lineEnd(line));
+}
+
+bool LineOffsetTable::isWellFormed() const
+{
+    if (textLength < 0 || lineStarts.isEmpty() || lineStarts.first() != 0) {
+        return false;
+    }
+    for (int i = 1; i < lineStarts.size(); ++i) {
+        if (lineStarts.at(i) <= lineStarts.at(i - 1) || lineStarts.at(i) > textLength) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QDataStream &operator<<(QDataStream &out, const LineOffsetTable &table)
+{
+    out << table.lineStarts << qint32(table.textLength);
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, LineOffsetTable &table)
+{
+    qint32 textLength = 0;
+    in >> table.lineStarts >> textLength;
+    table.textLength = textLength;
+
+    if (table.lineStarts.isEmpty()) {
+        table.lineStarts.append(0);
+    }
+    return in;
+}
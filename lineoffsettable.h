@@ -0,0 +1,47 @@
+#ifndef LINEOFFSETTABLE_H
+#define LINEOFFSETTABLE_H
+
+#include <QString>
+#include <QVector>
+
+class QDataStream;
+
+// 🚀 每个文件的行首偏移表
+// 一次扫描记录每行起始字符位置，之后 位置 -> 行/列 的换算只需二分查找，
+// 不再为每个匹配从文件开头逐字符遍历
+class LineOffsetTable
+{
+public:
+    LineOffsetTable();
+    explicit LineOffsetTable(const QString& text);
+
+    void build(const QString& text);
+    void clear();
+
+    // 🚀 NEW: 把 [start, start + removedLength) 替换为 insertedText，只扫描插入的文本，其后的行首整体平移
+    void replace(int start, int removedLength, const QString& insertedText);
+
+    bool isEmpty() const { return textLength == 0; }
+    int lineCount() const { return lineStarts.size(); }
+    int length() const { return textLength; }
+
+    // 行号从0开始；越界时返回-1
+    int lineStart(int line) const;
+    int lineEnd(int line) const;        // 不含换行符
+
+    int lineForPosition(int position) const;
+    void lineColumn(int position, int& line, int& column) const;
+    int positionOf(int line, int column) const;
+
+    // 🚀 NEW: 写入/读出磁盘符号索引缓存
+    friend QDataStream &operator<<(QDataStream &out, const LineOffsetTable &table);
+    friend QDataStream &operator>>(QDataStream &in, LineOffsetTable &table);
+    // 读出的行首表从0开始、严格递增且不超过文本长度
+    bool isWellFormed() const;
+
+private:
+    QVector<int> lineStarts;   // lineStarts[i] = 第i行首字符位置，lineStarts[0] 恒为0
+    int textLength = 0;
+};
+
+#endif // LINEOFFSETTABLE_H
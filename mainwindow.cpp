@@ -17,6 +17,8 @@
 #include <QTextBlock>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QLabel>
+#include <QStatusBar>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -39,6 +41,7 @@ MainWindow::MainWindow(QWidget *parent)
     connectNavigationSignals();
 
     setupDebugButton();
+    setupAnalysisCacheStatus();
 }
 
 MainWindow::~MainWindow()
@@ -72,6 +75,9 @@ void MainWindow::setupManagerConnections()
     connect(tabManager.get(), &TabManager::tabClosed,
             this, [this](const QString& fileName) {
                 if (!workspaceManager->isWorkspaceOpen()) {
+                    // 🚀 NEW: 非工作区模式下丢弃已关闭文件的符号分片(O(1))
+                    sym_list::getInstance()->clearSymbolsForFile(fileName);
+
                     symbolAnalyzer->analyzeOpenTabs(tabManager.get());
 
                     // 🚀 NEW: 清除文件关系
@@ -112,7 +118,8 @@ void MainWindow::setupManagerConnections()
 
                 // 🔧 关键修复：立即更新进度对话框内容，不等待
                 QTimer::singleShot(10, this, [this, svFiles]() {
-                    if (progressDialog) {
+                    // 文件很少时符号分析可能已经结束，不再覆盖关系分析阶段的状态
+                    if (progressDialog && !pendingRelationshipFiles.isEmpty()) {
                         // 立即显示符号分析阶段
                         progressDialog->statusLabel->setText("阶段 1/2: 符号分析进行中...");
                         progressDialog->currentFileLabel->setText("正在扫描和解析SystemVerilog文件结构...");
@@ -130,54 +137,9 @@ void MainWindow::setupManagerConnections()
                     }
                 });
 
-                // 50ms后开始符号分析
-                QTimer::singleShot(50, this, [this]() {
-                    // 执行符号分析
-                    symbolAnalyzer->analyzeWorkspace(workspaceManager.get());
-                });
-
-                // 200ms后开始关系分析
-                QTimer::singleShot(200, this, [this, svFiles]() {
-                    qDebug() << "Starting relationship analysis for" << svFiles.size() << "files";
-
-                    // 更新到关系分析阶段
-                    if (progressDialog) {
-                        progressDialog->statusLabel->setText("阶段 2/2: 关系分析进行中...");
-                        progressDialog->currentFileLabel->setText("正在分析文件间的符号依赖关系...");
-                        progressDialog->progressBar->setFormat(QString("%v / %1 文件 (%p%)").arg(svFiles.size()));
-
-                        if (progressDialog->config.showDetails) {
-                            progressDialog->logProgress("🔗 开始关系分析阶段...");
-                            progressDialog->logProgress("🔍 分析模块实例化关系...");
-                            progressDialog->logProgress("🔍 分析变量赋值关系...");
-                            progressDialog->logProgress("🔍 分析任务/函数调用关系...");
-                        }
-
-                        // 强制刷新UI
-                        progressDialog->update();
-                        progressDialog->repaint();
-                        QApplication::processEvents();
-                    }
-
-                    if (relationshipBuilder) {
-                        relationshipAnalysisTracker.totalFiles = svFiles.size();
-                        relationshipAnalysisTracker.processedFiles = 0;
-                        relationshipAnalysisTracker.isActive = true;
-
-                        qDebug() << "Starting batch relationship analysis tracking";
-
-                        // 批量分析所有SystemVerilog文件的关系
-                        for (const QString& filePath : svFiles) {
-                            QFile file(filePath);
-                            if (file.open(QIODevice::ReadOnly | QFile::Text)) {
-                                QTextStream in(&file);
-                                QString content = in.readAll();
-                                relationshipBuilder->analyzeFile(filePath, content);
-                                file.close();
-                            }
-                        }
-                    }
-                });
+                // 🚀 符号分析由随后的 filesScanned 在线程池上启动，
+                // 关系分析等符号分析完成(batchAnalysisCompleted)后再开始
+                pendingRelationshipFiles = svFiles;
             });
     connect(workspaceManager.get(), &WorkspaceManager::fileChanged,
             this, [this](const QString& filePath) {
@@ -197,7 +159,7 @@ void MainWindow::setupManagerConnections()
 
     connect(workspaceManager.get(), &WorkspaceManager::filesScanned,
             this, [this](const QStringList& svFiles) {
-                // 🔧 FIX: 只做符号分析，关系分析在workspaceOpened中处理
+                // 🔧 FIX: 只做符号分析，关系分析在workspaceOpened登记、符号分析完成后开始
                 symbolAnalyzer->analyzeWorkspace(workspaceManager.get());
                 qDebug() << "Files scanned, symbol analysis triggered for" << svFiles.size() << "files";
             });
@@ -223,6 +185,7 @@ void MainWindow::setupManagerConnections()
             this, [this](const QString& fileName, int symbolCount) {
                 Q_UNUSED(symbolCount)
                 qDebug() << "Symbol analysis completed for" << fileName << "(" << symbolCount << "symbols)";
+                updateAnalysisCacheStatus();
             });
 
     connect(symbolAnalyzer.get(), &SymbolAnalyzer::batchAnalysisCompleted,
@@ -230,6 +193,13 @@ void MainWindow::setupManagerConnections()
                 qDebug() << "=== Symbol Batch Analysis Completed ===";
                 qDebug() << "Files analyzed:" << filesAnalyzed << "Symbols found:" << totalSymbols;
 
+                // 工作区刚打开时，符号分析完成后进入关系分析阶段
+                if (!pendingRelationshipFiles.isEmpty()) {
+                    const QStringList svFiles = pendingRelationshipFiles;
+                    pendingRelationshipFiles.clear();
+                    startRelationshipAnalysis(svFiles);
+                }
+
                 // 🔧 FIX: 只更新状态栏，不触发进度对话框完成
                 if (statusBar()) {
                     statusBar()->showMessage(
@@ -239,6 +209,24 @@ void MainWindow::setupManagerConnections()
                 }
             });
 
+    // 🚀 NEW: 并行符号分析的进度
+    connect(symbolAnalyzer.get(), &SymbolAnalyzer::analysisProgress,
+            this, [this](int filesAnalyzed, int totalFiles, const QString& currentFile) {
+                if (progressDialog && !pendingRelationshipFiles.isEmpty()) {
+                    progressDialog->statusLabel->setText(
+                        QString("阶段 1/2: 符号分析进行中 (%1/%2)").arg(filesAnalyzed).arg(totalFiles));
+                    progressDialog->currentFileLabel->setText(QString("已解析: %1").arg(currentFile));
+                }
+            });
+
+    connect(symbolAnalyzer.get(), &SymbolAnalyzer::batchAnalysisCancelled,
+            this, [this](int filesAnalyzed, int totalSymbols) {
+                qDebug() << "Symbol batch analysis cancelled after" << filesAnalyzed
+                         << "files," << totalSymbols << "symbols";
+                pendingRelationshipFiles.clear();
+                updateAnalysisCacheStatus();
+            });
+
     // NEW: Connect managers to navigation manager
     navigationManager->connectToTabManager(tabManager.get());
     navigationManager->connectToWorkspaceManager(workspaceManager.get());
@@ -652,6 +640,49 @@ void MainWindow::onRelationshipAnalysisError(const QString& fileName, const QStr
     }
 }
 
+void MainWindow::startRelationshipAnalysis(const QStringList& svFiles)
+{
+    qDebug() << "Starting relationship analysis for" << svFiles.size() << "files";
+
+    // 更新到关系分析阶段
+    if (progressDialog) {
+        progressDialog->statusLabel->setText("阶段 2/2: 关系分析进行中...");
+        progressDialog->currentFileLabel->setText("正在分析文件间的符号依赖关系...");
+        progressDialog->progressBar->setFormat(QString("%v / %1 文件 (%p%)").arg(svFiles.size()));
+
+        if (progressDialog->config.showDetails) {
+            progressDialog->logProgress("🔗 开始关系分析阶段...");
+            progressDialog->logProgress("🔍 分析模块实例化关系...");
+            progressDialog->logProgress("🔍 分析变量赋值关系...");
+            progressDialog->logProgress("🔍 分析任务/函数调用关系...");
+        }
+
+        // 强制刷新UI
+        progressDialog->update();
+        progressDialog->repaint();
+        QApplication::processEvents();
+    }
+
+    if (relationshipBuilder) {
+        relationshipAnalysisTracker.totalFiles = svFiles.size();
+        relationshipAnalysisTracker.processedFiles = 0;
+        relationshipAnalysisTracker.isActive = true;
+
+        qDebug() << "Starting batch relationship analysis tracking";
+
+        // 批量分析所有SystemVerilog文件的关系
+        for (const QString& filePath : svFiles) {
+            QFile file(filePath);
+            if (file.open(QIODevice::ReadOnly | QFile::Text)) {
+                QTextStream in(&file);
+                QString content = in.readAll();
+                relationshipBuilder->analyzeFile(filePath, content);
+                file.close();
+            }
+        }
+    }
+}
+
 void MainWindow::showAnalysisProgress(const QStringList& files)
 {
     qDebug() << "=== showAnalysisProgress ===";
@@ -680,6 +711,10 @@ void MainWindow::showAnalysisProgress(const QStringList& files)
             this, [this]() {
                 qDebug() << "Progress dialog cancelled by user";
 
+                // 符号分析阶段被取消时不再进入关系分析
+                pendingRelationshipFiles.clear();
+                symbolAnalyzer->cancelWorkspaceAnalysis();
+
                 if (relationshipBuilder) {
                     relationshipBuilder->cancelAnalysis();
                 }
@@ -779,6 +814,30 @@ void MainWindow::onDebugPrintSymbolIds()
     qDebug() << "=== 调试完成 ===";
 }
 
+void MainWindow::setupAnalysisCacheStatus()
+{
+    analysisCacheLabel = new QLabel(this);
+    analysisCacheLabel->setToolTip("增量分析缓存(各文件的行指纹)占用 / 内存预算，超出时淘汰最久未分析的文件");
+    statusBar()->addPermanentWidget(analysisCacheLabel);
+
+    updateAnalysisCacheStatus();
+}
+
+void MainWindow::updateAnalysisCacheStatus()
+{
+    if (!analysisCacheLabel) {
+        return;
+    }
+
+    const sym_list* symbolList = sym_list::getInstance();
+    const double megabyte = 1024.0 * 1024.0;
+    analysisCacheLabel->setText(
+        QString("分析缓存: %1 / %2 MB (%3个文件)")
+        .arg(symbolList->analysisCacheUsage() / megabyte, 0, 'f', 1)
+        .arg(symbolList->analysisCacheBudget() / megabyte, 0, 'f', 1)
+        .arg(symbolList->analysisCacheFileCount()));
+}
+
 void MainWindow::onDebug0(){
     relationshipEngine->getModuleInstances(1);
 }
@@ -14,6 +14,7 @@ class ModeManager;
 class SymbolAnalyzer;
 class NavigationManager;
 class NavigationWidget;
+class QLabel;
 
 // 🚀 NEW: Forward declarations for relationship system
 class SymbolRelationshipEngine;
@@ -94,6 +95,10 @@ private:
     void showAnalysisProgress(const QStringList& files);
     void hideAnalysisProgress();
 
+    // 🚀 NEW: 工作区打开后等待符号分析完成再开始关系分析
+    QStringList pendingRelationshipFiles;
+    void startRelationshipAnalysis(const QStringList& svFiles);
+
     void setupNavigationPane();
     void connectNavigationSignals();
     void navigateToFileAndLine(const QString& filePath, int lineNumber = -1);
@@ -105,6 +110,11 @@ private:
 
     QPushButton* debugButton;
     void setupDebugButton();
+
+    // 🚀 NEW: 状态栏常驻显示增量分析缓存的占用/预算
+    QLabel* analysisCacheLabel = nullptr;
+    void setupAnalysisCacheStatus();
+    void updateAnalysisCacheStatus();
 };
 
 #endif // MAINWINDOW_H
@@ -68,6 +68,9 @@ void MyCodeEditor::initConnection()
     //blockCount
     connect(this,SIGNAL(blockCountChanged(int)),this,SLOT(updateLineNumberWidgetWidth()));
 
+    //contentsChange: 累积编辑区间，符号分析只重新解析改动的语句
+    connect(document(),SIGNAL(contentsChange(int,int,int)),this,SLOT(onContentsChange(int,int,int)));
+
     //updateRequest
     connect(this,SIGNAL(updateRequest(QRect,int)),this,SLOT(updateLineNumberWidget(QRect,int)));
 }
@@ -269,6 +272,17 @@ void MyCodeEditor::initAutoComplete()
     initCustomCommands();
 }
 
+void MyCodeEditor::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    editDelta.merge(position, charsRemoved, charsAdded);
+}
+
+void MyCodeEditor::markSymbolsAnalyzed(quint64 fileRevision)
+{
+    analyzedFileRevision = fileRevision;
+    editDelta.clear();
+}
+
 void MyCodeEditor::onTextChanged()
 {
     updateSaveState();
@@ -340,6 +354,7 @@ void MyCodeEditor::onTextChanged()
 void MyCodeEditor::hideAutoComplete()
 {
     completer->popup()->hide();
+    CompletionManager::getInstance()->endCompletionSession();
 
     if (isInCustomCommandMode) {
         clearCommandHighlight();
@@ -375,7 +390,8 @@ bool MyCodeEditor::isInCommentArea()
     QTextCursor cursor = textCursor();
     int position = cursor.position();
     sym_list* symbolList = sym_list::getInstance();
-    return symbolList->isPositionInComment(position);
+    // 🚀 按文件查询注释掩码，O(1)
+    return symbolList->isPositionInComment(getFileName(), position);
 }
 
 void MyCodeEditor::onCompletionActivated(const QModelIndex &index)
@@ -651,27 +667,9 @@ void MyCodeEditor::onAutoCompleteTimer()
         QString fileName = getFileName();
         QString currentModule = manager->getCurrentModule(fileName, cursorPosition);
 
-        QStringList symbolNames;
-        if (!currentModule.isEmpty()) {
-            symbolNames = manager->getModuleInternalVariablesByType(currentModule, currentCommandType, commandInput);
-        } else {
-            symbolNames = manager->getGlobalSymbolsByType(currentCommandType, commandInput);
-        }
-
-        // 转换为 SymbolInfo 列表
-        QList<sym_list::SymbolInfo> filteredSymbols;
-        sym_list* symbolList = sym_list::getInstance();
-
-        for (const QString &symbolName : symbolNames) {
-            QList<sym_list::SymbolInfo> matchingSymbols = symbolList->findSymbolsByName(symbolName);
-            for (const sym_list::SymbolInfo &symbol : matchingSymbols) {
-                if (symbol.symbolType == currentCommandType &&
-                    (currentModule.isEmpty() || symbol.moduleScope == currentModule)) {
-                    filteredSymbols.append(symbol);
-                    break;
-                }
-            }
-        }
+        // 🚀 模块内走 (作用域, 类型) 索引，结果直接是 SymbolInfo，不再按名称逐个回查
+        QList<sym_list::SymbolInfo> filteredSymbols =
+            manager->getCommandModeSymbols(currentModule, currentCommandType, commandInput);
 
         completionModel->updateSymbolCompletions(filteredSymbols, commandInput, currentCommandType);
         showAutoComplete();
@@ -692,6 +690,9 @@ void MyCodeEditor::onAutoCompleteTimer()
 
     QString prefix = getWordUnderCursor();
     if (prefix.length() >= 1) {
+        // 🚀 同一单词起点上的后续按键沿用会话，只收窄上一次的候选
+        CompletionManager::getInstance()->beginCompletionSession(getFileName(), wordStartPos);
+
         QStringList suggestions = getCompletionSuggestions(prefix);
         QList<sym_list::SymbolInfo> symbolInfoList;
         sym_list* symbolList = sym_list::getInstance();
@@ -38,6 +38,11 @@ public:
     void processAlternateModeInput(const QString &input);
     bool isSaved = false;
 
+    // 🚀 NEW: 自上次符号分析以来的编辑区间，供 sym_list 局部重新解析
+    const sym_list::EditDelta& pendingEdit() const { return editDelta; }
+    quint64 analyzedRevision() const { return analyzedFileRevision; }
+    void markSymbolsAnalyzed(quint64 fileRevision);
+
 private slots:
     void highlighCurrentLine();
     void updateLineNumberWidget(QRect rect, int dy);
@@ -47,6 +52,7 @@ private slots:
     void onTextChanged();
     void onAutoCompleteTimer();
     void onCompletionActivated(const QModelIndex &index);
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
 
 protected:
     void keyPressEvent(QKeyEvent *event) override;
@@ -73,6 +79,9 @@ private:
     LineNumberWidget *lineNumberWidget;
     QString mFileName;
 
+    sym_list::EditDelta editDelta;
+    quint64 analyzedFileRevision = 0;
+
     // Completion system
     QCompleter *completer;
     CompletionModel *completionModel;
@@ -1,7 +1,25 @@
 #include "myhighlighter.h"
+#include "textscanner.h"
 #include <QTextStream>
 //#include <QDebug>
 
+namespace {
+
+// 在 [from, text.length()) 内查找两字符序列 first second，找不到返回 -1
+int indexOfPair(const QString &text, int from, ushort first, ushort second)
+{
+    const QChar* data = text.constData();
+    const int size = text.length();
+    for (int pos = from; (pos = TextScanner::indexOf(data, pos, size, first)) < size; ++pos) {
+        if (pos + 1 < size && data[pos + 1].unicode() == second) {
+            return pos;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
 MyHighlighter::MyHighlighter(QTextDocument *parent): QSyntaxHighlighter(parent)
 {
     // Keep exact original order and logic
@@ -75,23 +93,18 @@ void MyHighlighter::addMultiLineCommentFormat(const QString &text)
 {
     setCurrentBlockState(0);
 
-    // /*
-    QRegExp commentStartRegExp("\\/\\*");
-
-    // */
-    QRegExp commentEndRegExp("\\*\\/");
-
     // hl
     QTextCharFormat multiLineCommentFormat;
     multiLineCommentFormat.setFont(QFont(mFontFamily,mFontSize));
     multiLineCommentFormat.setForeground(Qt::darkGreen);
 
+    // 🚀 /* 与 */ 用向量化扫描查找，不再为每个文本块构造 QRegExp
     int startIndex = 0;
     if(previousBlockState() != 1)
-        startIndex = commentStartRegExp.indexIn(text);
+        startIndex = indexOfPair(text, 0, '/', '*');
 
     while(startIndex>=0){
-        int endIndex = commentEndRegExp.indexIn(text,startIndex);
+        int endIndex = indexOfPair(text, startIndex, '*', '/');
         int commentLength = 0;
         if(endIndex == -1){
             setCurrentBlockState(1);
@@ -102,13 +115,13 @@ void MyHighlighter::addMultiLineCommentFormat(const QString &text)
                       multiLineCommentFormat);
         }
         else{
-            commentLength = endIndex - startIndex + commentEndRegExp.matchedLength();
+            commentLength = endIndex - startIndex + 2;
 
             setFormat(startIndex,
                       commentLength,
                       multiLineCommentFormat);
         }
-        startIndex = commentStartRegExp.indexIn(text,commentLength+startIndex);
+        startIndex = indexOfPair(text, commentLength+startIndex, '/', '*');
     }
 }
 
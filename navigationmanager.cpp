@@ -4,6 +4,8 @@
 #include "workspacemanager.h"
 #include "symbolanalyzer.h"
 #include "completionmanager.h"
+#include "symbolsnapshot.h"
+#include "symbolshard.h"
 //#include <QDebug>
 
 NavigationManager::NavigationManager(QObject *parent)
@@ -396,7 +398,10 @@ void NavigationManager::updateSymbolHierarchyData()
 {
     symbolsByTypeCache.clear();
 
-    sym_list* symbolList = sym_list::getInstance();
+    // 🚀 整个刷新过程使用同一个只读快照，后台分析发布新版本不会造成前后不一致
+    const std::shared_ptr<const SymbolSnapshot> snapshot = sym_list::getInstance()->getSnapshot();
+    const std::shared_ptr<const SymbolShard> fileShard =
+        currentFileName.isEmpty() ? nullptr : snapshot->fileShard(currentFileName);
 
     // 获取各种类型的符号
     static const QList<sym_list::sym_type_e> symbolTypes = {
@@ -413,15 +418,14 @@ void NavigationManager::updateSymbolHierarchyData()
 
         // 如果有当前文件，只显示当前文件的符号
         if (!currentFileName.isEmpty()) {
-            QList<sym_list::SymbolInfo> fileSymbols = symbolList->findSymbolsByFileName(currentFileName);
-            for (const sym_list::SymbolInfo& symbol : qAsConst(fileSymbols)) {
-                if (symbol.symbolType == symbolType) {
+            if (fileShard) {
+                for (const sym_list::SymbolInfo& symbol : fileShard->symbolsOfType(symbolType)) {
                     symbolNames.append(symbol.symbolName);
                 }
             }
         } else {
             // 否则显示所有符号
-            symbolNames = symbolList->getSymbolNamesByType(symbolType);
+            symbolNames = snapshot->symbolNamesOfType(symbolType);
         }
 
         // 应用搜索过滤器
@@ -0,0 +1,294 @@
+#include "scopetree.h"
+
+#include <QDataStream>
+#include <algorithm>
+#include <climits>
+
+bool ScopeTree::Span::isClosed() const
+{
+    return endPosition != INT_MAX;
+}
+
+void ScopeTree::clear()
+{
+    spans.clear();
+    openSpans.clear();
+    danglingCloses.clear();
+}
+
+void ScopeTree::open(Kind kind, const QString& name, int line, int position)
+{
+    // always/initial 之后的第一个作用域就是它的语句体
+    if (!openSpans.isEmpty() && openSpans.last().bodyPending) {
+        openSpans.last().bodyPending = false;
+        openSpans.last().closesWithBody = (kind == Block);
+    }
+
+    Span span;
+    span.kind = kind;
+    span.name = name;
+    span.startLine = line;
+    span.endLine = INT_MAX;
+    span.startPosition = position;
+    span.endPosition = INT_MAX;
+    span.parent = openSpans.isEmpty() ? -1 : openSpans.last().index;
+
+    OpenSpan entry;
+    entry.index = spans.size();
+    entry.bodyPending = (kind == Procedural);
+    entry.closesWithBody = false;
+
+    openSpans.append(entry);
+    spans.append(span);
+}
+
+void ScopeTree::close(Kind kind, int line, int position)
+{
+    closeSpan(kind, line, position);
+
+    // begin 块是 always/initial 的语句体时，两者一起结束
+    if (!openSpans.isEmpty() && openSpans.last().closesWithBody) {
+        closeSpan(Procedural, line, position);
+    }
+}
+
+void ScopeTree::endStatement(int line, int position)
+{
+    if (!openSpans.isEmpty() && openSpans.last().bodyPending) {
+        closeSpan(Procedural, line, position);
+    }
+}
+
+void ScopeTree::closeSpan(Kind kind, int line, int position)
+{
+    int depth = openSpans.size() - 1;
+    while (depth >= 0 && spans.at(openSpans.at(depth).index).kind != kind) {
+        --depth;
+    }
+
+    if (depth < 0) {
+        Event event;
+        event.position = position;
+        event.line = line;
+        event.opening = false;
+        event.kind = kind;
+        danglingCloses.append(event);
+        return;
+    }
+
+    // 其间未闭合的区间(如缺少 end 的块)在同一位置结束
+    while (openSpans.size() > depth) {
+        Span& span = spans[openSpans.last().index];
+        span.endLine = line;
+        span.endPosition = position;
+        openSpans.removeLast();
+    }
+}
+
+// 最后一个起点不晚于 position 的区间若不包含 position，则答案只可能是它的外层区间
+int ScopeTree::spanAtPosition(int position) const
+{
+    auto it = std::upper_bound(spans.constBegin(), spans.constEnd(), position,
+                               [](int pos, const Span& span) { return pos < span.startPosition; });
+
+    int index = static_cast<int>(it - spans.constBegin()) - 1;
+    while (index >= 0) {
+        const Span& span = spans.at(index);
+        if (position < span.endPosition) {
+            return index;
+        }
+        index = span.parent;
+    }
+    return -1;
+}
+
+int ScopeTree::spanAtLine(int line) const
+{
+    auto it = std::lower_bound(spans.constBegin(), spans.constEnd(), line,
+                               [](const Span& span, int l) { return span.startLine < l; });
+
+    int index = static_cast<int>(it - spans.constBegin()) - 1;
+    while (index >= 0) {
+        const Span& span = spans.at(index);
+        if (line < span.endLine) {
+            return index;
+        }
+        index = span.parent;
+    }
+    return -1;
+}
+
+int ScopeTree::spanStartingAt(int position) const
+{
+    auto it = std::lower_bound(spans.constBegin(), spans.constEnd(), position,
+                               [](const Span& span, int pos) { return span.startPosition < pos; });
+
+    if (it != spans.constEnd() && it->startPosition == position) {
+        return static_cast<int>(it - spans.constBegin());
+    }
+    return -1;
+}
+
+int ScopeTree::enclosing(int index, Kind kind) const
+{
+    while (index >= 0 && spans.at(index).kind != kind) {
+        index = spans.at(index).parent;
+    }
+    return index;
+}
+
+int ScopeTree::moduleSpanAtPosition(int position) const
+{
+    return enclosing(spanAtPosition(position), Module);
+}
+
+int ScopeTree::moduleSpanAtLine(int line) const
+{
+    return enclosing(spanAtLine(line), Module);
+}
+
+QString ScopeTree::moduleAtPosition(int position) const
+{
+    const int index = moduleSpanAtPosition(position);
+    return index >= 0 ? spans.at(index).name : QString();
+}
+
+QString ScopeTree::moduleAtLine(int line) const
+{
+    const int index = moduleSpanAtLine(line);
+    return index >= 0 ? spans.at(index).name : QString();
+}
+
+QStringList ScopeTree::modulesAtPosition(int position) const
+{
+    QStringList modules;
+    for (int index = moduleSpanAtPosition(position); index >= 0;
+         index = enclosing(spans.at(index).parent, Module)) {
+        modules.prepend(spans.at(index).name);
+    }
+    return modules;
+}
+
+QVector<int> ScopeTree::scopePathAtPosition(int position) const
+{
+    QVector<int> path;
+    for (int index = spanAtPosition(position); index >= 0; index = spans.at(index).parent) {
+        path.prepend(index);
+    }
+    return path;
+}
+
+// 起止事件按源码顺序追加。结束事件记录的是结束关键字之后的位置，按关键字本身的位置判断是否落在区间内；
+// keepFrom/keepTo 之间的事件丢弃，shiftFrom 及之后的事件坐标加上偏移
+void ScopeTree::appendEvents(QVector<Event>& events, int keepFrom, int keepTo, int shiftFrom,
+                             int positionDelta, int lineDelta) const
+{
+    auto dropped = [&](int tokenStart) { return tokenStart >= keepFrom && tokenStart < keepTo; };
+    auto append = [&](Event event, int tokenStart) {
+        if (tokenStart >= shiftFrom) {
+            event.position += positionDelta;
+            event.line += lineDelta;
+        }
+        events.append(event);
+    };
+
+    for (const Span& span : spans) {
+        if (!dropped(span.startPosition)) {
+            append(Event{ span.startPosition, span.startLine, true, span.kind, span.name }, span.startPosition);
+        }
+        if (span.isClosed() && !dropped(span.endPosition - 1)) {
+            append(Event{ span.endPosition, span.endLine, false, span.kind, QString() }, span.endPosition - 1);
+        }
+    }
+    for (const Event& event : danglingCloses) {
+        if (!dropped(event.position - 1)) {
+            append(event, event.position - 1);
+        }
+    }
+}
+
+void ScopeTree::splice(int regionStart, int oldRegionEnd, int positionDelta, int lineDelta,
+                       const ScopeTree& fragment, int fragmentPosition, int fragmentLine)
+{
+    QVector<Event> events;
+    events.reserve((spans.size() + fragment.spans.size()) * 2);
+    appendEvents(events, regionStart, oldRegionEnd, oldRegionEnd, positionDelta, lineDelta);
+    fragment.appendEvents(events, 0, 0, INT_MIN, fragmentPosition, fragmentLine);
+
+    // 同一位置先结束后开始；同时结束时内层(begin 块)先于外层(always)
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.position != b.position) {
+            return a.position < b.position;
+        }
+        if (a.opening != b.opening) {
+            return !a.opening;
+        }
+        return a.opening ? a.kind < b.kind : a.kind > b.kind;
+    });
+
+    // 按解析时的规则重新配对：片段中的 end 可能闭合区间之前打开的 begin，连带结束以它为语句体的 always
+    clear();
+    spans.reserve(events.size() / 2 + 1);
+    for (const Event& event : qAsConst(events)) {
+        if (event.opening) {
+            open(event.kind, event.name, event.line, event.position);
+        } else {
+            close(event.kind, event.line, event.position);
+        }
+    }
+    openSpans.clear();
+}
+
+bool ScopeTree::isWellFormed() const
+{
+    for (int i = 0; i < spans.size(); ++i) {
+        const Span &span = spans.at(i);
+        if (span.kind < Module || span.kind > Block) {
+            return false;
+        }
+        if (span.parent < -1 || span.parent >= i) {
+            return false;
+        }
+        if (i > 0 && span.startPosition < spans.at(i - 1).startPosition) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QDataStream &operator<<(QDataStream &out, const ScopeTree &table)
+{
+    out << qint32(table.spans.size());
+    for (const ScopeTree::Span &span : table.spans) {
+        out << qint8(span.kind) << span.name
+            << qint32(span.startLine) << qint32(span.endLine)
+            << qint32(span.startPosition) << qint32(span.endPosition)
+            << qint32(span.parent);
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, ScopeTree &table)
+{
+    table.clear();
+
+    qint32 spanCount = 0;
+    in >> spanCount;
+
+    table.spans.reserve(qBound(0, spanCount, 4096));     // 计数可能来自损坏的缓存
+    for (qint32 i = 0; i < spanCount && in.status() == QDataStream::Ok; ++i) {
+        ScopeTree::Span span;
+        qint8 kind = 0;
+        qint32 startLine = 0, endLine = 0, startPosition = 0, endPosition = 0, parent = -1;
+        in >> kind >> span.name >> startLine >> endLine >> startPosition >> endPosition >> parent;
+
+        span.kind = static_cast<ScopeTree::Kind>(kind);
+        span.startLine = startLine;
+        span.endLine = endLine;
+        span.startPosition = startPosition;
+        span.endPosition = endPosition;
+        span.parent = parent;
+        table.spans.append(span);
+    }
+    return in;
+}
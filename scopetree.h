@@ -0,0 +1,102 @@
+#ifndef SCOPETREE_H
+#define SCOPETREE_H
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+
+class QDataStream;
+
+// 🚀 每个文件的层次作用域树
+// module/interface/package > generate > always/initial > task/function > begin/end(fork/join)，
+// 由声明解析器在同一遍扫描中记录。区间按起始位置有序，嵌套区间完整包含在父区间内，
+// 位置/行 -> 最内层作用域 为二分查找 + 沿父区间回溯，开销 O(log n + 深度)。
+// 增量重解析时只替换被编辑区间内的起止事件，其余区间平移后重新配对，不必重新扫描整个文件。
+class ScopeTree
+{
+public:
+    enum Kind {
+        Module,
+        Interface,
+        Package,
+        Generate,
+        Subroutine,     // task / function
+        Procedural,     // always* / initial / final
+        Block           // begin/end、fork/join
+    };
+
+    struct Span {
+        Kind kind;
+        QString name;           // 模块/接口/包/task/function 名或 begin : label；无名块为空
+        int startLine;          // 名称所在行(无名称时为关键字所在行)
+        int endLine;            // 结束关键字所在行；未闭合时为 INT_MAX
+        int startPosition;      // 起始关键字位置(与对应符号的 position 一致)
+        int endPosition;        // 结束关键字之后的位置；未闭合时为 INT_MAX
+        int parent;             // 外层区间下标，-1 表示顶层
+
+        bool isClosed() const;
+        bool isModule() const { return kind == Module; }
+    };
+
+    void clear();
+    bool isEmpty() const { return spans.isEmpty(); }
+    int size() const { return spans.size(); }
+    const Span& at(int index) const { return spans.at(index); }
+
+    // 解析器使用：按源码顺序打开/闭合区间。close 闭合最内层的同类区间(其间未闭合的区间一并结束)，
+    // 没有可闭合的区间时记为悬空结束事件，供片段解析的结果拼接回整棵树
+    void open(Kind kind, const QString& name, int line, int position);
+    void close(Kind kind, int line, int position);
+    // always/initial 的语句体不是 begin 块时，在第一个 ; 处结束
+    void endStatement(int line, int position);
+
+    // 查询：返回最内层区间下标，没有时返回 -1
+    int spanAtPosition(int position) const;     // startPosition <= position < endPosition
+    int spanAtLine(int line) const;             // startLine < line < endLine
+    int spanStartingAt(int position) const;
+    int enclosing(int index, Kind kind) const;  // index 自身或最近的 kind 类外层区间
+
+    // 模块查询只看 module 区间
+    int moduleSpanAtPosition(int position) const;
+    int moduleSpanAtLine(int line) const;
+    QString moduleAtPosition(int position) const;
+    QString moduleAtLine(int line) const;
+    QStringList modulesAtPosition(int position) const;      // 由外到内
+    QVector<int> scopePathAtPosition(int position) const;   // 由外到内的全部区间下标
+
+    // 🚀 NEW: 增量重解析：删除起止位置落在旧区间 [start, end) 内的事件，其后的事件平移，
+    // 加入片段树(坐标相对于 fragmentPosition/fragmentLine)的事件后重新配对
+    void splice(int regionStart, int oldRegionEnd, int positionDelta, int lineDelta,
+                const ScopeTree& fragment, int fragmentPosition, int fragmentLine);
+
+    // 🚀 NEW: 写入/读出磁盘符号索引缓存(只保存区间，解析期的打开栈与悬空事件不保存)
+    friend QDataStream &operator<<(QDataStream &out, const ScopeTree &table);
+    friend QDataStream &operator>>(QDataStream &in, ScopeTree &table);
+    // 读出的区间满足查询的前提：种类合法、按起始位置有序、父区间下标为 -1 或小于自身
+    bool isWellFormed() const;
+
+private:
+    struct OpenSpan {
+        int index;
+        bool bodyPending;       // always/initial 之后还没遇到语句体
+        bool closesWithBody;    // 语句体是 begin 块，块结束时一起结束
+    };
+
+    struct Event {
+        int position;
+        int line;
+        bool opening;
+        Kind kind;
+        QString name;
+    };
+
+    QVector<Span> spans;
+    QVector<OpenSpan> openSpans;
+    QVector<Event> danglingCloses;
+
+    void closeSpan(Kind kind, int line, int position);
+    void appendEvents(QVector<Event>& events, int keepFrom, int keepTo, int shiftFrom,
+                      int positionDelta, int lineDelta) const;
+};
+
+#endif // SCOPETREE_H
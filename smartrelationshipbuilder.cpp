@@ -1,6 +1,6 @@
 #include "smartrelationshipbuilder.h"
 //#include <QDebug>
-#include <QRegExp>
+#include <QRegularExpression>
 #include <QApplication>
 
 SmartRelationshipBuilder::SmartRelationshipBuilder(SymbolRelationshipEngine* engine,
@@ -8,38 +8,12 @@ SmartRelationshipBuilder::SmartRelationshipBuilder(SymbolRelationshipEngine* eng
                                                  QObject *parent)
     : QObject(parent), relationshipEngine(engine), symbolDatabase(symbolDatabase)
 {
-    initializePatterns();
 }
 
 SmartRelationshipBuilder::~SmartRelationshipBuilder()
 {
 }
 
-// 🚀 初始化分析模式
-void SmartRelationshipBuilder::initializePatterns()
-{
-    // 🚀 模块实例化模式: module_name instance_name (
-    patterns.moduleInstantiation = QRegExp("([a-zA-Z_][a-zA-Z0-9_]*)\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(");
-
-    // 🚀 变量赋值模式: variable = expression
-    patterns.variableAssignment = QRegExp("([a-zA-Z_][a-zA-Z0-9_]*)\\s*=\\s*([^;]+);");
-
-    // 🚀 变量引用模式: 在表达式中的变量名
-    patterns.variableReference = QRegExp("\\b([a-zA-Z_][a-zA-Z0-9_]*)\\b");
-
-    // 🚀 task调用模式: task_name(args) 或 task_name;
-    patterns.taskCall = QRegExp("([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(.*\\)\\s*;|([a-zA-Z_][a-zA-Z0-9_]*)\\s*;");
-
-    // 🚀 function调用模式: function_name(args)
-    patterns.functionCall = QRegExp("([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(.*\\)");
-
-    // 🚀 always块模式
-    patterns.alwaysBlock = QRegExp("always\\s*(@.*)?\\s*begin");
-
-    // 🚀 generate块模式
-    patterns.generateBlock = QRegExp("generate\\s*begin");
-}
-
 // 🚀 主要分析接口实现
 void SmartRelationshipBuilder::analyzeFile(const QString& fileName, const QString& content)
 {
@@ -55,29 +29,29 @@ void SmartRelationshipBuilder::analyzeFile(const QString& fileName, const QStrin
 
     try {
         AnalysisContext context;
-        setupAnalysisContext(fileName, context);
+        setupAnalysisContext(fileName, content, context);
 
         // 🚀 在各个分析步骤中检查取消状态
-        analyzeModuleInstantiations(content, context);
+        analyzeModuleInstantiations(context);
         if (checkCancellation(fileName)) return;
 
-        analyzeVariableAssignments(content, context);
+        analyzeVariableAssignments(context);
         if (checkCancellation(fileName)) return;
 
-        analyzeVariableReferences(content, context);
+        analyzeVariableReferences(context);
         if (checkCancellation(fileName)) return;
 
-        analyzeTaskFunctionCalls(content, context);
+        analyzeTaskFunctionCalls(context);
         if (checkCancellation(fileName)) return;
 
         if (enableAdvancedAnalysis) {
-            analyzeAlwaysBlocks(content, context);
+            analyzeAlwaysBlocks(context);
             if (checkCancellation(fileName)) return;
 
             analyzeInterfaceRelationships(content, context);
             if (checkCancellation(fileName)) return;
 
-            analyzeClockResetRelationships(content, context);
+            analyzeClockResetRelationships(context);
             if (checkCancellation(fileName)) return;
         }
 
@@ -93,15 +67,17 @@ void SmartRelationshipBuilder::analyzeFile(const QString& fileName, const QStrin
 }
 
 // 🚀 设置分析上下文
-void SmartRelationshipBuilder::setupAnalysisContext(const QString& fileName, AnalysisContext& context)
+void SmartRelationshipBuilder::setupAnalysisContext(const QString& fileName, const QString& content,
+                                                    AnalysisContext& context)
 {
     context.currentFileName = fileName;
     context.fileSymbols = symbolDatabase->findSymbolsByFileName(fileName);
     context.localSymbolIds.clear();
 
-    // 🚀 构建本地符号映射
+    // 🚀 构建本地符号映射(符号名在入库时已登记为原子)
+    AtomTable* atoms = AtomTable::getInstance();
     for (const sym_list::SymbolInfo& symbol : qAsConst(context.fileSymbols)) {
-        context.localSymbolIds[symbol.symbolName] = symbol.symbolId;
+        context.localSymbolIds[atoms->intern(symbol.symbolName)] = symbol.symbolId;
 
         // 🚀 找到当前文件的主模块
         if (symbol.symbolType == sym_list::sym_module && context.currentModuleId == -1) {
@@ -109,23 +85,49 @@ void SmartRelationshipBuilder::setupAnalysisContext(const QString& fileName, Ana
             context.currentModuleId = symbol.symbolId;
         }
     }
+
+    scanCandidateLines(content, context);
 }
 
-// 🚀 分析模块实例化关系
-void SmartRelationshipBuilder::analyzeModuleInstantiations(const QString& content, AnalysisContext& context)
+// 🚀 整个文件只切分一次，每行用合成匹配器分类一次；不命中任何类别的行直接丢弃
+void SmartRelationshipBuilder::scanCandidateLines(const QString& content, AnalysisContext& context)
 {
-    QStringList lines = content.split('\n');
+    const SVPatternRegistry* registry = SVPatternRegistry::getInstance();
+    const QStringList lines = content.split('\n');
 
+    context.lines.clear();
     for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum].trimmed();
+        const SVPatternRegistry::KindMask kinds = registry->classify(lines[lineNum]);
+        if (kinds == 0) {
+            continue;
+        }
+
+        CandidateLine candidate;
+        candidate.lineNumber = lineNum;
+        candidate.kinds = kinds;
+        candidate.text = lines[lineNum];
+        context.lines.append(candidate);
+    }
+}
 
-        if (line.isEmpty() || line.startsWith("//")) continue;
+// 🚀 分析模块实例化关系
+void SmartRelationshipBuilder::analyzeModuleInstantiations(AnalysisContext& context)
+{
+    const QRegularExpression& pattern =
+        SVPatternRegistry::getInstance()->pattern(SVPatternRegistry::ModuleInstantiation);
+
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        if (!(candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::ModuleInstantiation))) continue;
+
+        const QString line = candidate.text.trimmed();
+        if (line.startsWith("//")) continue;
 
         // 🚀 查找模块实例化
-        int pos = 0;
-        while ((pos = patterns.moduleInstantiation.indexIn(line, pos)) != -1) {
-            QString moduleTypeName = patterns.moduleInstantiation.cap(1);
-            QString instanceName = patterns.moduleInstantiation.cap(2);
+        QRegularExpressionMatchIterator it = pattern.globalMatch(line);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            QString moduleTypeName = match.captured(1);
+            QString instanceName = match.captured(2);
 
             // 🚀 查找被实例化的模块
             int moduleTypeId = findSymbolIdByName(moduleTypeName, context);
@@ -135,31 +137,32 @@ void SmartRelationshipBuilder::analyzeModuleInstantiations(const QString& conten
                     context.currentModuleId,
                     moduleTypeId,
                     SymbolRelationshipEngine::INSTANTIATES,
-                    QString("Instance: %1 at line %2").arg(instanceName).arg(lineNum + 1),
+                    QString("Instance: %1 at line %2").arg(instanceName).arg(candidate.lineNumber + 1),
                     90
                 );
             }
-
-            pos += patterns.moduleInstantiation.matchedLength();
         }
     }
 }
 
 // 🚀 分析变量赋值关系
-void SmartRelationshipBuilder::analyzeVariableAssignments(const QString& content, AnalysisContext& context)
+void SmartRelationshipBuilder::analyzeVariableAssignments(AnalysisContext& context)
 {
-    QStringList lines = content.split('\n');
+    const QRegularExpression& pattern =
+        SVPatternRegistry::getInstance()->pattern(SVPatternRegistry::VariableAssignment);
 
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum].trimmed();
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        if (!(candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::VariableAssignment))) continue;
 
-        if (line.isEmpty() || line.startsWith("//")) continue;
+        const QString line = candidate.text.trimmed();
+        if (line.startsWith("//")) continue;
 
         // 🚀 查找赋值语句
-        int pos = 0;
-        while ((pos = patterns.variableAssignment.indexIn(line, pos)) != -1) {
-            QString leftVar = patterns.variableAssignment.cap(1);
-            QString rightExpr = patterns.variableAssignment.cap(2);
+        QRegularExpressionMatchIterator it = pattern.globalMatch(line);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            QString leftVar = match.captured(1);
+            QString rightExpr = match.captured(2);
 
             int leftVarId = findSymbolIdByName(leftVar, context);
             if (leftVarId != -1) {
@@ -174,7 +177,7 @@ void SmartRelationshipBuilder::analyzeVariableAssignments(const QString& content
                             leftVarId,
                             rightVarId,
                             SymbolRelationshipEngine::REFERENCES,
-                            QString("Assignment at line %1").arg(lineNum + 1),
+                            QString("Assignment at line %1").arg(candidate.lineNumber + 1),
                             85
                         );
 
@@ -183,52 +186,48 @@ void SmartRelationshipBuilder::analyzeVariableAssignments(const QString& content
                             rightVarId,
                             leftVarId,
                             SymbolRelationshipEngine::ASSIGNS_TO,
-                            QString("Assigned to %1 at line %2").arg(leftVar).arg(lineNum + 1),
+                            QString("Assigned to %1 at line %2").arg(leftVar).arg(candidate.lineNumber + 1),
                             85
                         );
                     }
                 }
             }
-
-            pos += patterns.variableAssignment.matchedLength();
         }
     }
 }
 
 // 🚀 分析变量引用关系
-void SmartRelationshipBuilder::analyzeVariableReferences(const QString& content, AnalysisContext& context)
+void SmartRelationshipBuilder::analyzeVariableReferences(AnalysisContext& context)
 {
     // 🚀 这是一个更复杂的分析，需要识别各种上下文中的变量引用
-    QStringList lines = content.split('\n');
-
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum].trimmed();
+    const QRegularExpression& conditionRegex = SVPatternRegistry::getInstance()->conditionExpression();
 
-        // 🚀 跳过声明行和注释
-        if (line.isEmpty() || line.startsWith("//") ||
-            line.contains(QRegExp("\\b(reg|wire|logic|input|output)\\b"))) {
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        // 🚀 在条件语句、case语句等中查找变量引用；跳过声明行
+        if (!(candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::Condition)) ||
+            (candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::Declaration))) {
             continue;
         }
 
-        // 🚀 在条件语句、case语句等中查找变量引用
-        if (line.contains(QRegExp("\\b(if|case|while)\\s*\\("))) {
-            // 提取条件表达式中的变量
-            QRegExp conditionRegex("\\b(if|case|while)\\s*\\(([^)]+)\\)");
-            if (conditionRegex.indexIn(line) != -1) {
-                QString condition = conditionRegex.cap(2);
-                QStringList referencedVars = extractVariablesFromExpression(condition);
-
-                for (const QString& varName : qAsConst(referencedVars)) {
-                    int varId = findSymbolIdByName(varName, context);
-                    if (varId != -1 && context.currentModuleId != -1) {
-                        addRelationshipWithContext(
-                            context.currentModuleId,
-                            varId,
-                            SymbolRelationshipEngine::READS_FROM,
-                            QString("Condition check at line %1").arg(lineNum + 1),
-                            70
-                        );
-                    }
+        const QString line = candidate.text.trimmed();
+        if (line.startsWith("//")) continue;
+
+        // 提取条件表达式中的变量
+        const QRegularExpressionMatch match = conditionRegex.match(line);
+        if (match.hasMatch()) {
+            QString condition = match.captured(2);
+            QStringList referencedVars = extractVariablesFromExpression(condition);
+
+            for (const QString& varName : qAsConst(referencedVars)) {
+                int varId = findSymbolIdByName(varName, context);
+                if (varId != -1 && context.currentModuleId != -1) {
+                    addRelationshipWithContext(
+                        context.currentModuleId,
+                        varId,
+                        SymbolRelationshipEngine::READS_FROM,
+                        QString("Condition check at line %1").arg(candidate.lineNumber + 1),
+                        70
+                    );
                 }
             }
         }
@@ -236,21 +235,24 @@ void SmartRelationshipBuilder::analyzeVariableReferences(const QString& content,
 }
 
 // 🚀 分析task和function调用关系
-void SmartRelationshipBuilder::analyzeTaskFunctionCalls(const QString& content, AnalysisContext& context)
+void SmartRelationshipBuilder::analyzeTaskFunctionCalls(AnalysisContext& context)
 {
-    QStringList lines = content.split('\n');
+    const QRegularExpression& pattern =
+        SVPatternRegistry::getInstance()->pattern(SVPatternRegistry::TaskCall);
 
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum].trimmed();
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        if (!(candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::TaskCall))) continue;
 
-        if (line.isEmpty() || line.startsWith("//")) continue;
+        const QString line = candidate.text.trimmed();
+        if (line.startsWith("//")) continue;
 
         // 🚀 查找task调用
-        int pos = 0;
-        while ((pos = patterns.taskCall.indexIn(line, pos)) != -1) {
-            QString taskName = patterns.taskCall.cap(1);
+        QRegularExpressionMatchIterator it = pattern.globalMatch(line);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            QString taskName = match.captured(1);
             if (taskName.isEmpty()) {
-                taskName = patterns.taskCall.cap(2);
+                taskName = match.captured(2);
             }
 
             // 🚀 验证这确实是一个task或function
@@ -265,44 +267,40 @@ void SmartRelationshipBuilder::analyzeTaskFunctionCalls(const QString& content,
                             context.currentModuleId,
                             taskId,
                             SymbolRelationshipEngine::CALLS,
-                            QString("Called at line %1").arg(lineNum + 1),
+                            QString("Called at line %1").arg(candidate.lineNumber + 1),
                             90
                         );
                     }
                 }
             }
-
-            pos += patterns.taskCall.matchedLength();
         }
     }
 }
 
 // 🚀 分析always块关系
-void SmartRelationshipBuilder::analyzeAlwaysBlocks(const QString& content, AnalysisContext& context)
+void SmartRelationshipBuilder::analyzeAlwaysBlocks(AnalysisContext& context)
 {
-    QStringList lines = content.split('\n');
+    const QRegularExpression& sensitivityRegex = SVPatternRegistry::getInstance()->sensitivityList();
 
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum];
-
-        if (patterns.alwaysBlock.indexIn(line) != -1) {
-            // 🚀 分析敏感信号列表
-            QRegExp sensitivityRegex("always\\s*@\\s*\\(([^)]+)\\)");
-            if (sensitivityRegex.indexIn(line) != -1) {
-                QString sensitivityList = sensitivityRegex.cap(1);
-                QStringList signalNames = extractVariablesFromExpression(sensitivityList); // 重命名避免与Qt宏冲突
-
-                for (const QString& signalName : qAsConst(signalNames)) { // 重命名避免与Qt宏冲突
-                    int signalId = findSymbolIdByName(signalName, context);
-                    if (signalId != -1 && context.currentModuleId != -1) {
-                        addRelationshipWithContext(
-                            context.currentModuleId,
-                            signalId,
-                            SymbolRelationshipEngine::READS_FROM,
-                            QString("Always block sensitivity at line %1").arg(lineNum + 1),
-                            80
-                        );
-                    }
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        if (!(candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::AlwaysBlock))) continue;
+
+        // 🚀 分析敏感信号列表
+        const QRegularExpressionMatch match = sensitivityRegex.match(candidate.text);
+        if (match.hasMatch()) {
+            QString sensitivityList = match.captured(1);
+            QStringList signalNames = extractVariablesFromExpression(sensitivityList); // 重命名避免与Qt宏冲突
+
+            for (const QString& signalName : qAsConst(signalNames)) { // 重命名避免与Qt宏冲突
+                int signalId = findSymbolIdByName(signalName, context);
+                if (signalId != -1 && context.currentModuleId != -1) {
+                    addRelationshipWithContext(
+                        context.currentModuleId,
+                        signalId,
+                        SymbolRelationshipEngine::READS_FROM,
+                        QString("Always block sensitivity at line %1").arg(candidate.lineNumber + 1),
+                        80
+                    );
                 }
             }
         }
@@ -310,20 +308,24 @@ void SmartRelationshipBuilder::analyzeAlwaysBlocks(const QString& content, Analy
 }
 
 // 🚀 分析时钟和复位关系
-void SmartRelationshipBuilder::analyzeClockResetRelationships(const QString& content, AnalysisContext& context)
+void SmartRelationshipBuilder::analyzeClockResetRelationships(AnalysisContext& context)
 {
-    QStringList lines = content.split('\n');
+    const SVPatternRegistry* registry = SVPatternRegistry::getInstance();
+    const SVPatternRegistry::KindMask clockKinds = SVPatternRegistry::bit(SVPatternRegistry::ClockName) |
+                                                   SVPatternRegistry::bit(SVPatternRegistry::ClockEdge);
 
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        const QString& line = lines[lineNum].toLower();
+    for (const CandidateLine& candidate : qAsConst(context.lines)) {
+        const bool hasClock = (candidate.kinds & clockKinds) == clockKinds;
+        const bool hasReset = candidate.kinds & SVPatternRegistry::bit(SVPatternRegistry::ResetSignal);
+        if (!hasClock && !hasReset) continue;
 
-        // 🚀 查找时钟信号
-        if (line.contains(QRegExp("\\b(clk|clock)\\b")) &&
-            line.contains(QRegExp("\\b(posedge|negedge)\\b"))) {
+        const QString line = candidate.text.toLower();
 
-            QRegExp clockRegex("(posedge|negedge)\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-            if (clockRegex.indexIn(line) != -1) {
-                QString clockName = clockRegex.cap(2);
+        // 🚀 查找时钟信号
+        if (hasClock) {
+            const QRegularExpressionMatch match = registry->clockSignal().match(line);
+            if (match.hasMatch()) {
+                QString clockName = match.captured(2);
                 int clockId = findSymbolIdByName(clockName, context);
 
                 if (clockId != -1 && context.currentModuleId != -1) {
@@ -331,7 +333,7 @@ void SmartRelationshipBuilder::analyzeClockResetRelationships(const QString& con
                         clockId,
                         context.currentModuleId,
                         SymbolRelationshipEngine::CLOCKS,
-                        QString("Clock domain at line %1").arg(lineNum + 1),
+                        QString("Clock domain at line %1").arg(candidate.lineNumber + 1),
                         95
                     );
                 }
@@ -339,11 +341,10 @@ void SmartRelationshipBuilder::analyzeClockResetRelationships(const QString& con
         }
 
         // 🚀 查找复位信号
-        if (line.contains(QRegExp("\\b(rst|reset|rstn)\\b"))) {
-            QRegExp resetRegex("\\b(rst|reset|rstn|rst_n)\\b");
-            int pos = 0;
-            while ((pos = resetRegex.indexIn(line, pos)) != -1) {
-                QString resetName = resetRegex.cap(1);
+        if (hasReset) {
+            QRegularExpressionMatchIterator it = registry->resetName().globalMatch(line);
+            while (it.hasNext()) {
+                QString resetName = it.next().captured(1);
                 int resetId = findSymbolIdByName(resetName, context);
 
                 if (resetId != -1 && context.currentModuleId != -1) {
@@ -351,12 +352,10 @@ void SmartRelationshipBuilder::analyzeClockResetRelationships(const QString& con
                         resetId,
                         context.currentModuleId,
                         SymbolRelationshipEngine::RESETS,
-                        QString("Reset signal at line %1").arg(lineNum + 1),
+                        QString("Reset signal at line %1").arg(candidate.lineNumber + 1),
                         90
                     );
                 }
-
-                pos += resetRegex.matchedLength();
             }
         }
     }
@@ -369,26 +368,22 @@ QStringList SmartRelationshipBuilder::extractVariablesFromExpression(const QStri
     QStringList variables;
     QSet<QString> uniqueVars; // 避免重复
 
-    // 🚀 使用正则表达式提取标识符
-    QRegExp identifierRegex("\\b([a-zA-Z_][a-zA-Z0-9_]*)\\b");
-    int pos = 0;
-
-    while ((pos = identifierRegex.indexIn(expression, pos)) != -1) {
-        QString identifier = identifierRegex.cap(1);
+    // 🚀 过滤掉SystemVerilog关键字
+    static const QSet<QString> svKeywords = {
+        "and", "or", "not", "begin", "end", "if", "else", "case", "default",
+        "posedge", "negedge", "assign", "always", "initial", "reg", "wire",
+        "logic", "input", "output", "inout", "module", "endmodule"
+    };
 
-        // 🚀 过滤掉SystemVerilog关键字
-        static QSet<QString> svKeywords = {
-            "and", "or", "not", "begin", "end", "if", "else", "case", "default",
-            "posedge", "negedge", "assign", "always", "initial", "reg", "wire",
-            "logic", "input", "output", "inout", "module", "endmodule"
-        };
+    // 🚀 使用预编译的标识符模式提取标识符
+    QRegularExpressionMatchIterator it = SVPatternRegistry::getInstance()->identifier().globalMatch(expression);
+    while (it.hasNext()) {
+        QString identifier = it.next().captured(1);
 
         if (!svKeywords.contains(identifier.toLower()) && !uniqueVars.contains(identifier)) {
             uniqueVars.insert(identifier);
             variables.append(identifier);
         }
-
-        pos += identifierRegex.matchedLength();
     }
 
     return variables;
@@ -396,18 +391,20 @@ QStringList SmartRelationshipBuilder::extractVariablesFromExpression(const QStri
 
 int SmartRelationshipBuilder::findSymbolIdByName(const QString& symbolName, const AnalysisContext& context)
 {
-    // 🚀 首先在本地符号映射中查找
-    if (context.localSymbolIds.contains(symbolName)) {
-        return context.localSymbolIds[symbolName];
+    // 🚀 从未登记过的标识符(关键字、字面量等)不可能是已知符号，直接返回
+    const AtomTable::Atom name = AtomTable::find(symbolName);
+    if (name == AtomTable::NoAtom) {
+        return -1;
     }
 
-    // 🚀 如果没找到，在全局符号数据库中查找
-    QList<sym_list::SymbolInfo> symbols = symbolDatabase->findSymbolsByName(symbolName);
-    if (!symbols.isEmpty()) {
-        return symbols.first().symbolId;
+    // 🚀 首先在本地符号映射中查找
+    auto it = context.localSymbolIds.constFind(name);
+    if (it != context.localSymbolIds.constEnd()) {
+        return it.value();
     }
 
-    return -1; // 未找到
+    // 🚀 如果没找到，在全局符号数据库中查找
+    return symbolDatabase->findSymbolIdByName(symbolName);
 }
 
 void SmartRelationshipBuilder::addRelationshipWithContext(int fromId, int toId,
@@ -459,37 +456,37 @@ void SmartRelationshipBuilder::analyzeFileIncremental(const QString& fileName, c
 void SmartRelationshipBuilder::analyzeModuleRelationships(const QString& fileName, const QString& content)
 {
     AnalysisContext context;
-    setupAnalysisContext(fileName, context);
-    analyzeModuleInstantiations(content, context);
+    setupAnalysisContext(fileName, content, context);
+    analyzeModuleInstantiations(context);
 }
 
 void SmartRelationshipBuilder::analyzeVariableRelationships(const QString& fileName, const QString& content)
 {
     AnalysisContext context;
-    setupAnalysisContext(fileName, context);
-    analyzeVariableAssignments(content, context);
-    analyzeVariableReferences(content, context);
+    setupAnalysisContext(fileName, content, context);
+    analyzeVariableAssignments(context);
+    analyzeVariableReferences(context);
 }
 
 void SmartRelationshipBuilder::analyzeTaskFunctionRelationships(const QString& fileName, const QString& content)
 {
     AnalysisContext context;
-    setupAnalysisContext(fileName, context);
-    analyzeTaskFunctionCalls(content, context);
+    setupAnalysisContext(fileName, content, context);
+    analyzeTaskFunctionCalls(context);
 }
 
 void SmartRelationshipBuilder::analyzeAssignmentRelationships(const QString& fileName, const QString& content)
 {
     AnalysisContext context;
-    setupAnalysisContext(fileName, context);
-    analyzeVariableAssignments(content, context);
+    setupAnalysisContext(fileName, content, context);
+    analyzeVariableAssignments(context);
 }
 
 void SmartRelationshipBuilder::analyzeInstantiationRelationships(const QString& fileName, const QString& content)
 {
     AnalysisContext context;
-    setupAnalysisContext(fileName, context);
-    analyzeModuleInstantiations(content, context);
+    setupAnalysisContext(fileName, content, context);
+    analyzeModuleInstantiations(context);
 }
 
 void SmartRelationshipBuilder::cancelAnalysis()
@@ -4,11 +4,13 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
-#include <QRegExp>
+#include <QVector>
 #include <QHash>
 #include <QList>
 #include "symbolrelationshipengine.h"
 #include "syminfo.h"
+#include "atomtable.h"
+#include "svpatternregistry.h"
 
 class SmartRelationshipBuilder : public QObject
 {
@@ -62,38 +64,34 @@ private:
     std::atomic<bool> cancelled{false};  // 线程安全的取消标志
     bool checkCancellation(const QString& currentFile = "");
 
-    // 🚀 缓存的正则表达式
-    struct AnalysisPatterns {
-        QRegExp moduleInstantiation;     // module实例化模式
-        QRegExp variableAssignment;      // 变量赋值模式
-        QRegExp variableReference;       // 变量引用模式
-        QRegExp taskCall;               // task调用模式
-        QRegExp functionCall;           // function调用模式
-        QRegExp alwaysBlock;            // always块模式
-        QRegExp generateBlock;          // generate块模式
+    // 🚀 预筛选后的候选行：整个文件只切分、分类一次，各分析步骤只遍历带有对应类别的行
+    struct CandidateLine {
+        int lineNumber = 0;
+        SVPatternRegistry::KindMask kinds = 0;
+        QString text;
     };
-    AnalysisPatterns patterns;
 
     // 🚀 分析上下文
     struct AnalysisContext {
         QString currentFileName;
         QString currentModuleName;
         int currentModuleId = -1;
-        QHash<QString, int> localSymbolIds;  // 当前文件的符号名到ID映射
+        QHash<AtomTable::Atom, int> localSymbolIds;  // 当前文件的符号名原子到ID映射
         QList<sym_list::SymbolInfo> fileSymbols;
+        QVector<CandidateLine> lines;
     };
 
     // 🚀 初始化方法
-    void initializePatterns();
-    void setupAnalysisContext(const QString& fileName, AnalysisContext& context);
+    void setupAnalysisContext(const QString& fileName, const QString& content, AnalysisContext& context);
+    void scanCandidateLines(const QString& content, AnalysisContext& context);
 
     // 🚀 核心分析方法
-    void analyzeModuleInstantiations(const QString& content, AnalysisContext& context);
-    void analyzeVariableAssignments(const QString& content, AnalysisContext& context);
-    void analyzeVariableReferences(const QString& content, AnalysisContext& context);
-    void analyzeTaskFunctionCalls(const QString& content, AnalysisContext& context);
-    void analyzeAlwaysBlocks(const QString& content, AnalysisContext& context);
-    void analyzeGenerateBlocks(const QString& content, AnalysisContext& context);
+    void analyzeModuleInstantiations(AnalysisContext& context);
+    void analyzeVariableAssignments(AnalysisContext& context);
+    void analyzeVariableReferences(AnalysisContext& context);
+    void analyzeTaskFunctionCalls(AnalysisContext& context);
+    void analyzeAlwaysBlocks(AnalysisContext& context);
+    void analyzeGenerateBlocks(AnalysisContext& context);
 
     // 🚀 辅助分析方法
     QStringList extractVariablesFromExpression(const QString& expression);
@@ -111,7 +109,7 @@ private:
     void analyzeInterfaceRelationships(const QString& content, AnalysisContext& context);
     void analyzeParameterRelationships(const QString& content, AnalysisContext& context);
     void analyzeConstraintRelationships(const QString& content, AnalysisContext& context);
-    void analyzeClockResetRelationships(const QString& content, AnalysisContext& context);
+    void analyzeClockResetRelationships(AnalysisContext& context);
 };
 
 #endif // SMARTRELATIONSHIPBUILDER_H
@@ -0,0 +1,82 @@
+#include "snapshottables.h"
+
+const int SymbolOwnerTable::PageBits;
+const int SymbolOwnerTable::PageSize;
+const int ScopeTypeFileTable::BucketCount;
+
+// 页只被本表引用时原地修改；仍被某个快照引用时先复制该页
+void SymbolOwnerTable::assign(int symbolId, AtomTable::Atom file)
+{
+    if (symbolId < 0) {
+        return;
+    }
+
+    const int pageIndex = symbolId >> PageBits;
+    if (pages.size() <= pageIndex) {
+        pages.resize(pageIndex + 1);
+    }
+
+    std::shared_ptr<Page>& page = pages[pageIndex];
+    if (!page) {
+        page = std::make_shared<Page>(PageSize, AtomTable::NoAtom);
+    } else if (page.use_count() > 1) {
+        page = std::make_shared<Page>(*page);
+    }
+    (*page)[symbolId & (PageSize - 1)] = file;
+}
+
+AtomTable::Atom SymbolOwnerTable::owner(int symbolId) const
+{
+    if (symbolId < 0) {
+        return AtomTable::NoAtom;
+    }
+
+    const int pageIndex = symbolId >> PageBits;
+    if (pageIndex >= pages.size() || !pages.at(pageIndex)) {
+        return AtomTable::NoAtom;
+    }
+    return pages.at(pageIndex)->at(symbolId & (PageSize - 1));
+}
+
+ScopeTypeFileTable::Bucket& ScopeTypeFileTable::mutableBucket(int index)
+{
+    std::shared_ptr<Bucket>& bucket = buckets[index];
+    if (!bucket) {
+        bucket = std::make_shared<Bucket>();
+    } else if (bucket.use_count() > 1) {
+        bucket = std::make_shared<Bucket>(*bucket);
+    }
+    return *bucket;
+}
+
+void ScopeTypeFileTable::add(quint64 key, const QString& fileName)
+{
+    const int index = bucketOf(key);
+    const std::shared_ptr<Bucket>& current = buckets.at(index);
+    if (current && current->value(key).contains(fileName)) {
+        return;     // 已登记，不必复制桶
+    }
+    mutableBucket(index)[key].append(fileName);
+}
+
+void ScopeTypeFileTable::remove(quint64 key, const QString& fileName)
+{
+    const int index = bucketOf(key);
+    const std::shared_ptr<Bucket>& current = buckets.at(index);
+    if (!current || !current->value(key).contains(fileName)) {
+        return;
+    }
+
+    Bucket& bucket = mutableBucket(index);
+    auto it = bucket.find(key);
+    it.value().removeOne(fileName);
+    if (it.value().isEmpty()) {
+        bucket.erase(it);
+    }
+}
+
+QStringList ScopeTypeFileTable::files(quint64 key) const
+{
+    const std::shared_ptr<Bucket>& bucket = buckets.at(bucketOf(key));
+    return bucket ? bucket->value(key) : QStringList();
+}
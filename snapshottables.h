@@ -0,0 +1,54 @@
+#ifndef SNAPSHOTTABLES_H
+#define SNAPSHOTTABLES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <memory>
+
+#include "atomtable.h"
+
+// 🚀 快照与写入方共享的分页表
+// 每次发布快照时快照复制的只是页指针数组；写入方之后修改某一页时，只有该页被其他快照引用才复制这一页。
+// 单个文件重新分析的开销因此与该文件触及的页数成正比，而不是与整个工作区的符号数成正比。
+// 写入只在 sym_list 持锁的线程进行；快照中的副本只读，可在任意线程查询。
+
+// 符号ID -> 所属文件原子。ID 由 sym_list 顺序预留、从不复用，按 4096 个一页稠密存放；
+// 分片被替换后旧ID仍指向原文件，由查询方再用分片确认
+class SymbolOwnerTable
+{
+public:
+    void assign(int symbolId, AtomTable::Atom file);
+    AtomTable::Atom owner(int symbolId) const;     // 未登记时返回 NoAtom
+    void clear() { pages.clear(); }
+
+private:
+    static const int PageBits = 12;
+    static const int PageSize = 1 << PageBits;
+
+    typedef QVector<AtomTable::Atom> Page;
+    QVector<std::shared_ptr<Page>> pages;
+};
+
+// (作用域, 类型) 组合键 -> 含有该组合的文件，按键散列到固定数目的桶，修改时只复制所在的桶
+class ScopeTypeFileTable
+{
+public:
+    ScopeTypeFileTable() : buckets(BucketCount) {}
+
+    void add(quint64 key, const QString& fileName);
+    void remove(quint64 key, const QString& fileName);
+    QStringList files(quint64 key) const;
+
+private:
+    static const int BucketCount = 256;
+
+    typedef QHash<quint64, QStringList> Bucket;
+    QVector<std::shared_ptr<Bucket>> buckets;
+
+    static int bucketOf(quint64 key) { return int(qHash(key) % BucketCount); }
+    Bucket& mutableBucket(int index);
+};
+
+#endif // SNAPSHOTTABLES_H
@@ -0,0 +1,747 @@
+#include "svdeclarationparser.h"
+
+SVDeclarationParser::SVDeclarationParser(const QString& fileName, const QString& text)
+    : fileName(fileName)
+    , text(text)
+    , lexer(text)
+    , tokens(lexer.tokens())
+{
+}
+
+void SVDeclarationParser::setKnownStructTypes(const QHash<QString, bool>& structTypes)
+{
+    knownStructTypes = structTypes;
+}
+
+void SVDeclarationParser::setKnownEnumTypes(const QSet<QString>& enumTypes)
+{
+    knownEnumTypes = enumTypes;
+}
+
+void SVDeclarationParser::setEnclosingModules(const QStringList& modules)
+{
+    enclosingModules = modules;
+}
+
+QList<sym_list::SymbolInfo> SVDeclarationParser::parse()
+{
+    results.clear();
+    moduleStack = enclosingModules;
+    scopes.clear();
+    boundaries.clear();
+    moduleBoundarySeen = false;
+
+    const int tokenCount = tokens.size();
+    bool statementStart = true;
+    int i = 0;
+
+    while (i < tokenCount) {
+        const Token& token = tokens.at(i);
+
+        // 预处理指令与宏体不影响语句边界的判断
+        if (token.kind == SVLexer::Directive) {
+            i = parseDirective(i);
+            continue;
+        }
+        if (token.kind == SVLexer::MacroBody) {
+            ++i;
+            continue;
+        }
+
+        int next = i + 1;
+        bool nextStatementStart = false;
+
+        if (token.kind == SVLexer::Punctuation) {
+            if (isPunct(i, ';')) {
+                nextStatementStart = true;
+                boundaries.append(token.end());
+                scopes.endStatement(token.line, token.end());
+            } else if (isPunct(i, '(') && isPunct(i + 1, '*') &&
+                       tokens.at(i + 1).position == token.position + 1) {
+                next = parseConstraint(i);
+            }
+        } else if (token.kind == SVLexer::Identifier) {
+            switch (token.keyword) {
+            case SVLexer::KwModule:
+            case SVLexer::KwMacromodule:
+                next = parseModule(i);
+                break;
+            case SVLexer::KwEndmodule:
+                moduleBoundarySeen = true;
+                if (!moduleStack.isEmpty()) {
+                    moduleStack.removeLast();
+                    scopes.close(ScopeTree::Module, token.line, token.end());
+                }
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwInterface:
+                next = parseInterface(i);
+                break;
+            case SVLexer::KwModport:
+                next = parseModport(i);
+                break;
+            case SVLexer::KwPackage:
+                next = parsePackage(i);
+                break;
+            case SVLexer::KwReg:
+            case SVLexer::KwWire:
+            case SVLexer::KwLogic:
+                next = parseNetDeclaration(i);
+                break;
+            case SVLexer::KwTask:
+            case SVLexer::KwFunction:
+                next = parseSubroutine(i);
+                break;
+            case SVLexer::KwTypedef:
+                next = parseTypedef(i);
+                break;
+            case SVLexer::KwEnum:
+                next = parseAnonymousEnum(i);
+                break;
+            case SVLexer::KwStruct:
+            case SVLexer::KwUnion:
+                next = parseAnonymousStruct(i);
+                break;
+            case SVLexer::KwParameter:
+            case SVLexer::KwLocalparam:
+                next = parseParameters(i);
+                break;
+            case SVLexer::KwInput:
+            case SVLexer::KwOutput:
+            case SVLexer::KwInout:
+            case SVLexer::KwRef:
+            case SVLexer::KwVar:
+            case SVLexer::KwConst:
+            case SVLexer::KwAutomatic:
+            case SVLexer::KwStatic:
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwBegin:
+            case SVLexer::KwFork:
+                next = openBlock(i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwGenerate:
+                scopes.open(ScopeTree::Generate, QString(), token.line, token.position);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwAlways:
+            case SVLexer::KwInitial:
+            case SVLexer::KwFinal:
+                scopes.open(ScopeTree::Procedural, QString(), token.line, token.position);
+                break;
+            case SVLexer::KwEnd:
+            case SVLexer::KwJoin:
+                closeScope(ScopeTree::Block, i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwEndgenerate:
+                closeScope(ScopeTree::Generate, i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwEndtask:
+            case SVLexer::KwEndfunction:
+                closeScope(ScopeTree::Subroutine, i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwEndinterface:
+                closeScope(ScopeTree::Interface, i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwEndpackage:
+                closeScope(ScopeTree::Package, i);
+                nextStatementStart = true;
+                break;
+            case SVLexer::KwNone:
+                // 语句开头的 "已知类型 变量名" 形式
+                if (statementStart) {
+                    next = parseTypedVariables(i);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        statementStart = nextStatementStart;
+        i = qMax(next, i + 1);
+    }
+
+    return results;
+}
+
+bool SVDeclarationParser::isPunct(int index, char c) const
+{
+    return index >= 0 && index < tokens.size() &&
+           tokens.at(index).kind == SVLexer::Punctuation &&
+           text.at(tokens.at(index).position) == QLatin1Char(c);
+}
+
+bool SVDeclarationParser::isKeyword(int index, SVLexer::Keyword keyword) const
+{
+    return index >= 0 && index < tokens.size() &&
+           tokens.at(index).kind == SVLexer::Identifier &&
+           tokens.at(index).keyword == keyword;
+}
+
+bool SVDeclarationParser::isPlainIdentifier(int index) const
+{
+    return index >= 0 && index < tokens.size() &&
+           tokens.at(index).kind == SVLexer::Identifier &&
+           tokens.at(index).keyword == SVLexer::KwNone &&
+           text.at(tokens.at(index).position) != QLatin1Char('$');
+}
+
+// 不复制字符数据的临时字符串，仅用于哈希查找
+QString SVDeclarationParser::rawText(int index) const
+{
+    const Token& token = tokens.at(index);
+    return QString::fromRawData(text.constData() + token.position, token.length);
+}
+
+QString SVDeclarationParser::tokenString(int index) const
+{
+    return lexer.tokenString(tokens.at(index));
+}
+
+// index处为 ( [ { 之一，返回与之匹配的闭括号之后的下标
+int SVDeclarationParser::skipBalanced(int index) const
+{
+    const int tokenCount = tokens.size();
+    int depth = 0;
+
+    for (int j = index; j < tokenCount; ++j) {
+        if (tokens.at(j).kind != SVLexer::Punctuation) {
+            continue;
+        }
+        const QChar c = text.at(tokens.at(j).position);
+        if (c == QLatin1Char('(') || c == QLatin1Char('[') || c == QLatin1Char('{')) {
+            ++depth;
+        } else if (c == QLatin1Char(')') || c == QLatin1Char(']') || c == QLatin1Char('}')) {
+            if (--depth <= 0) {
+                return j + 1;
+            }
+        }
+    }
+    return tokenCount;
+}
+
+// 跳过表达式，停在同层的 , ; 或闭括号处
+int SVDeclarationParser::skipExpression(int index) const
+{
+    const int tokenCount = tokens.size();
+    int j = index;
+
+    while (j < tokenCount) {
+        if (isPunct(j, '(') || isPunct(j, '[') || isPunct(j, '{')) {
+            j = skipBalanced(j);
+            continue;
+        }
+        if (isPunct(j, ',') || isPunct(j, ';') ||
+            isPunct(j, ')') || isPunct(j, ']') || isPunct(j, '}')) {
+            return j;
+        }
+        ++j;
+    }
+    return j;
+}
+
+int SVDeclarationParser::skipDimensions(int index) const
+{
+    int j = index;
+    while (isPunct(j, '[')) {
+        j = skipBalanced(j);
+    }
+    return j;
+}
+
+QString SVDeclarationParser::currentModule() const
+{
+    return moduleStack.isEmpty() ? QString() : moduleStack.last();
+}
+
+// task/function 关键字前面(可隔一个 "DPI-C" 或 virtual)是 extern/pure/import/export 时只是原型声明
+bool SVDeclarationParser::isPrototype(int index) const
+{
+    for (int j = index - 1; j >= 0 && j >= index - 2; --j) {
+        const Token& token = tokens.at(j);
+        if (token.kind != SVLexer::Identifier && token.kind != SVLexer::StringLiteral) {
+            return false;
+        }
+        const QString word = rawText(j);
+        if (word == QLatin1String("extern") || word == QLatin1String("pure") ||
+            word == QLatin1String("import") || word == QLatin1String("export")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// begin/fork [: label]，返回标签之后的下标
+int SVDeclarationParser::openBlock(int index)
+{
+    const Token& token = tokens.at(index);
+    if (isPunct(index + 1, ':') && isPlainIdentifier(index + 2)) {
+        scopes.open(ScopeTree::Block, tokenString(index + 2), token.line, token.position);
+        return index + 3;
+    }
+    scopes.open(ScopeTree::Block, QString(), token.line, token.position);
+    return index + 1;
+}
+
+void SVDeclarationParser::closeScope(ScopeTree::Kind kind, int index)
+{
+    const Token& token = tokens.at(index);
+    scopes.close(kind, token.line, token.end());
+}
+
+void SVDeclarationParser::emitSymbol(sym_list::sym_type_e type, int anchorIndex, int nameIndex,
+                                     const QString& scope)
+{
+    const Token& anchor = tokens.at(anchorIndex);
+    const Token& name = tokens.at(nameIndex);
+
+    sym_list::SymbolInfo symbol;
+    symbol.fileName = fileName;
+    symbol.symbolName = tokenString(nameIndex);
+    symbol.symbolType = type;
+    symbol.position = anchor.position;
+    symbol.length = name.end() - anchor.position;
+    symbol.startLine = name.line;
+    symbol.startColumn = name.column;
+    symbol.endLine = name.line;
+    symbol.endColumn = name.column + name.length;
+    symbol.symbolId = 0;
+    symbol.moduleScope = scope;
+    symbol.scopeLevel = moduleStack.isEmpty() ? 0 : 1;
+
+    results.append(symbol);
+}
+
+// 逗号分隔的声明列表: a [3:0] = 0, b, c;
+int SVDeclarationParser::parseDeclarators(int index, sym_list::sym_type_e type, int anchorIndex,
+                                          const QString& scope)
+{
+    int j = index;
+
+    while (j < tokens.size()) {
+        j = skipDimensions(j);
+        if (!isPlainIdentifier(j)) {
+            break;
+        }
+        emitSymbol(type, anchorIndex, j, scope);
+
+        j = skipDimensions(j + 1);
+        if (isPunct(j, '=')) {
+            j = skipExpression(j + 1);
+        }
+        if (!isPunct(j, ',')) {
+            break;
+        }
+        ++j;
+    }
+    return j;
+}
+
+int SVDeclarationParser::parseModule(int index)
+{
+    int j = index + 1;
+    while (isKeyword(j, SVLexer::KwAutomatic) || isKeyword(j, SVLexer::KwStatic)) {
+        ++j;
+    }
+    if (!isPlainIdentifier(j)) {
+        return j;
+    }
+
+    emitSymbol(sym_list::sym_module, index, j, QString());
+    moduleBoundarySeen = true;
+    moduleStack.append(tokenString(j));
+    scopes.open(ScopeTree::Module, moduleStack.last(), tokens.at(j).line, tokens.at(index).position);
+    return j + 1;
+}
+
+int SVDeclarationParser::parseInterface(int index)
+{
+    const int j = index + 1;
+    // "virtual interface bus vif;" 之类的用法后面不是 ; ( #
+    if (isPlainIdentifier(j) &&
+        (isPunct(j + 1, ';') || isPunct(j + 1, '(') || isPunct(j + 1, '#'))) {
+        emitSymbol(sym_list::sym_interface, index, j, currentModule());
+        scopes.open(ScopeTree::Interface, tokenString(j), tokens.at(j).line, tokens.at(index).position);
+        return j + 1;
+    }
+    return j;
+}
+
+int SVDeclarationParser::parseModport(int index)
+{
+    int j = index + 1;
+    while (isPlainIdentifier(j) && isPunct(j + 1, '(')) {
+        emitSymbol(sym_list::sym_interface_modport, index, j, currentModule());
+        j = skipBalanced(j + 1);
+        if (!isPunct(j, ',')) {
+            break;
+        }
+        ++j;
+    }
+    return j;
+}
+
+int SVDeclarationParser::parsePackage(int index)
+{
+    int j = index + 1;
+    while (isKeyword(j, SVLexer::KwAutomatic) || isKeyword(j, SVLexer::KwStatic)) {
+        ++j;
+    }
+    if (!isPlainIdentifier(j)) {
+        return j;
+    }
+    emitSymbol(sym_list::sym_package, index, j, QString());
+    scopes.open(ScopeTree::Package, tokenString(j), tokens.at(j).line, tokens.at(index).position);
+    return j + 1;
+}
+
+int SVDeclarationParser::parseNetDeclaration(int index)
+{
+    sym_list::sym_type_e type = sym_list::sym_logic;
+    if (isKeyword(index, SVLexer::KwReg)) {
+        type = sym_list::sym_reg;
+    } else if (isKeyword(index, SVLexer::KwWire)) {
+        type = sym_list::sym_wire;
+    }
+
+    // 跳过 wire logic / signed / 位宽 / #延时 等修饰
+    int j = index + 1;
+    for (;;) {
+        if (isKeyword(j, SVLexer::KwLogic) || isKeyword(j, SVLexer::KwReg) ||
+            isKeyword(j, SVLexer::KwSigned) || isKeyword(j, SVLexer::KwUnsigned)) {
+            ++j;
+        } else if (isPunct(j, '[')) {
+            j = skipBalanced(j);
+        } else if (isPunct(j, '#')) {
+            ++j;
+            j = isPunct(j, '(') ? skipBalanced(j) : j + 1;
+        } else {
+            break;
+        }
+    }
+
+    return parseDeclarators(j, type, index, currentModule());
+}
+
+int SVDeclarationParser::parseSubroutine(int index)
+{
+    const sym_list::sym_type_e type = isKeyword(index, SVLexer::KwTask) ? sym_list::sym_task
+                                                                        : sym_list::sym_function;
+    // 名称是 ( 或 ; 之前的最后一个标识符: function automatic logic [3:0] calc(...)
+    const int limit = qMin(tokens.size(), index + 64);
+    int nameIndex = -1;
+    int j = index + 1;
+
+    while (j < limit && !isPunct(j, '(') && !isPunct(j, ';')) {
+        if (isPunct(j, '[')) {
+            j = skipBalanced(j);
+            continue;
+        }
+        if (isPlainIdentifier(j)) {
+            nameIndex = j;
+        }
+        ++j;
+    }
+
+    if (nameIndex >= 0 && (isPunct(j, '(') || isPunct(j, ';'))) {
+        emitSymbol(type, index, nameIndex, currentModule());
+        // extern/pure virtual/DPI import 只有原型，没有 endtask/endfunction
+        if (!isPrototype(index)) {
+            scopes.open(ScopeTree::Subroutine, tokenString(nameIndex), tokens.at(nameIndex).line,
+                        tokens.at(index).position);
+        }
+    }
+    return j;
+}
+
+int SVDeclarationParser::parseTypedef(int index)
+{
+    const QString scope = currentModule();
+    int j = index + 1;
+
+    // typedef enum [base] { A, B = 2 } name_t;
+    if (isKeyword(j, SVLexer::KwEnum)) {
+        QList<int> valueIndexes;
+        j = parseEnumBody(j, valueIndexes);
+        if (j < 0) {
+            return index + 1;
+        }
+        if (!isPlainIdentifier(j)) {
+            return j;
+        }
+
+        const QString typeName = tokenString(j);
+        emitSymbol(sym_list::sym_enum, index, j, scope);
+        for (int valueIndex : qAsConst(valueIndexes)) {
+            emitSymbol(sym_list::sym_enum_value, valueIndex, valueIndex, typeName); // moduleScope存储所属枚举类型
+        }
+        knownEnumTypes.insert(typeName);
+        return j + 1;
+    }
+
+    // typedef struct [packed] { ... } name_t;
+    if (isKeyword(j, SVLexer::KwStruct) || isKeyword(j, SVLexer::KwUnion)) {
+        bool packed = false;
+        ++j;
+        while (j < tokens.size() && !isPunct(j, '{') && !isPunct(j, ';')) {
+            if (isKeyword(j, SVLexer::KwPacked)) {
+                packed = true;
+            }
+            ++j;
+        }
+        if (!isPunct(j, '{')) {
+            return j;
+        }
+
+        QList<int> memberIndexes;
+        j = parseStructBody(j, memberIndexes);
+        if (!isPlainIdentifier(j)) {
+            return j;
+        }
+
+        const QString typeName = tokenString(j);
+        emitSymbol(packed ? sym_list::sym_packed_struct : sym_list::sym_unpacked_struct, index, j, scope);
+        for (int memberIndex : qAsConst(memberIndexes)) {
+            emitSymbol(sym_list::sym_struct_member, memberIndex, memberIndex, typeName); // moduleScope存储所属结构体
+        }
+        knownStructTypes.insert(typeName, packed);
+        return j + 1;
+    }
+
+    // typedef existing_t [dims] new_t;  名称为 ; 之前的最后一个标识符
+    int nameIndex = -1;
+    while (j < tokens.size() && !isPunct(j, ';')) {
+        if (isPunct(j, '[') || isPunct(j, '(') || isPunct(j, '{')) {
+            j = skipBalanced(j);
+            continue;
+        }
+        // 缺少分号时不要越过下一个声明
+        if (isKeyword(j, SVLexer::KwTypedef) || isKeyword(j, SVLexer::KwModule) ||
+            isKeyword(j, SVLexer::KwEndmodule) || isKeyword(j, SVLexer::KwEndpackage)) {
+            break;
+        }
+        if (isPlainIdentifier(j)) {
+            nameIndex = j;
+        }
+        ++j;
+    }
+
+    if (nameIndex >= 0 && isPunct(j, ';')) {
+        emitSymbol(sym_list::sym_typedef, index, nameIndex, scope);
+    }
+    return j;
+}
+
+// index处为enum关键字，返回 } 之后的下标；没有枚举体时返回-1
+int SVDeclarationParser::parseEnumBody(int index, QList<int>& valueIndexes) const
+{
+    int j = index + 1;
+    while (j < tokens.size() && !isPunct(j, '{') && !isPunct(j, ';')) {
+        j = isPunct(j, '[') ? skipBalanced(j) : j + 1;
+    }
+    if (!isPunct(j, '{')) {
+        return -1;
+    }
+
+    const int bodyEnd = skipBalanced(j) - 1; // 指向 }
+    int k = j + 1;
+    while (k < bodyEnd) {
+        if (isPlainIdentifier(k)) {
+            valueIndexes.append(k);
+        }
+        k = skipDimensions(k + 1);
+        if (isPunct(k, '=')) {
+            k = skipExpression(k + 1);
+        }
+        if (!isPunct(k, ',')) {
+            break;
+        }
+        ++k;
+    }
+    return bodyEnd + 1;
+}
+
+// index处为 {，逐条成员声明收集成员名，返回 } 之后的下标
+int SVDeclarationParser::parseStructBody(int index, QList<int>& memberIndexes) const
+{
+    const int bodyEnd = skipBalanced(index) - 1;
+    int j = index + 1;
+
+    while (j < bodyEnd) {
+        const int statementBegin = j;
+        while (j < bodyEnd && !isPunct(j, ';')) {
+            if (isPunct(j, '{') || isPunct(j, '[') || isPunct(j, '(')) {
+                j = skipBalanced(j);
+                continue;
+            }
+            if (isPunct(j, '=')) {
+                j = skipExpression(j + 1);
+                continue;
+            }
+            // 语句首个标识符是类型名，其后紧跟 ; , [ = 的标识符才是成员名
+            if (j > statementBegin && isPlainIdentifier(j) &&
+                (isPunct(j + 1, ';') || isPunct(j + 1, ',') ||
+                 isPunct(j + 1, '[') || isPunct(j + 1, '='))) {
+                memberIndexes.append(j);
+            }
+            ++j;
+        }
+        ++j;
+    }
+    return bodyEnd + 1;
+}
+
+int SVDeclarationParser::parseAnonymousEnum(int index)
+{
+    QList<int> valueIndexes;
+    const int j = parseEnumBody(index, valueIndexes);
+    if (j < 0) {
+        return index + 1;
+    }
+
+    for (int valueIndex : qAsConst(valueIndexes)) {
+        emitSymbol(sym_list::sym_enum_value, valueIndex, valueIndex, QString());
+    }
+    return parseDeclarators(j, sym_list::sym_enum_var, index, QString());
+}
+
+int SVDeclarationParser::parseAnonymousStruct(int index)
+{
+    bool packed = false;
+    int j = index + 1;
+    while (j < tokens.size() && !isPunct(j, '{') && !isPunct(j, ';')) {
+        if (isKeyword(j, SVLexer::KwPacked)) {
+            packed = true;
+        }
+        ++j;
+    }
+    if (!isPunct(j, '{')) {
+        return j;
+    }
+
+    j = skipBalanced(j);
+    return parseDeclarators(j, packed ? sym_list::sym_packed_struct_var : sym_list::sym_unpacked_struct_var,
+                            index, QString());
+}
+
+int SVDeclarationParser::parseParameters(int index)
+{
+    const sym_list::sym_type_e type = isKeyword(index, SVLexer::KwLocalparam) ? sym_list::sym_localparam
+                                                                              : sym_list::sym_parameter;
+    const QString scope = currentModule();
+    int j = index + 1;
+
+    while (j < tokens.size()) {
+        // 跳过类型部分: parameter int unsigned [7:0] WIDTH = 8 / parameter my_t CFG = ...
+        for (;;) {
+            if (isPunct(j, '[')) {
+                j = skipBalanced(j);
+            } else if (j < tokens.size() && tokens.at(j).kind == SVLexer::Identifier &&
+                       tokens.at(j).keyword != SVLexer::KwNone &&
+                       !isKeyword(j, SVLexer::KwParameter) && !isKeyword(j, SVLexer::KwLocalparam)) {
+                ++j;
+            } else if (isPlainIdentifier(j) && isPlainIdentifier(j + 1)) {
+                ++j;
+            } else {
+                break;
+            }
+        }
+
+        if (!isPlainIdentifier(j)) {
+            break;
+        }
+        emitSymbol(type, index, j, scope);
+
+        j = skipDimensions(j + 1);
+        if (isPunct(j, '=')) {
+            j = skipExpression(j + 1);
+        }
+        if (!isPunct(j, ',')) {
+            break;
+        }
+        ++j;
+        // #(parameter A = 1, parameter B = 2) 交给主循环处理下一个关键字
+        if (isKeyword(j, SVLexer::KwParameter) || isKeyword(j, SVLexer::KwLocalparam)) {
+            break;
+        }
+    }
+    return j;
+}
+
+int SVDeclarationParser::parseDirective(int index)
+{
+    sym_list::sym_type_e type;
+    switch (tokens.at(index).keyword) {
+    case SVLexer::KwDefine:
+        type = sym_list::sym_def_define;
+        break;
+    case SVLexer::KwIfdef:
+        type = sym_list::sym_def_ifdef;
+        break;
+    case SVLexer::KwIfndef:
+        type = sym_list::sym_def_ifndef;
+        break;
+    default:
+        return index + 1;
+    }
+
+    const int j = index + 1;
+    if (j < tokens.size() && tokens.at(j).kind == SVLexer::Identifier &&
+        tokens.at(j).line == tokens.at(index).line) {
+        // 宏定义是全局的，不归属任何模块
+        emitSymbol(type, index, j, type == sym_list::sym_def_define ? QString() : currentModule());
+        return j + 1;
+    }
+    return j;
+}
+
+// (* KEEP = "TRUE" *) 形式的综合约束属性
+int SVDeclarationParser::parseConstraint(int index)
+{
+    const int j = index + 2;
+    if (j >= tokens.size() || tokens.at(j).kind != SVLexer::Identifier || !isPunct(j + 1, '=')) {
+        return j;
+    }
+
+    const QStringRef name = lexer.tokenText(tokens.at(j));
+    for (const QChar c : name) {
+        if (!(c >= QLatin1Char('A') && c <= QLatin1Char('Z')) && c != QLatin1Char('_')) {
+            return j;
+        }
+    }
+
+    emitSymbol(sym_list::sym_xilinx_constraint, index, j, currentModule());
+    return j + 1;
+}
+
+// my_struct_t a, b;  state_t state = IDLE;
+int SVDeclarationParser::parseTypedVariables(int index)
+{
+    const QString typeName = rawText(index);
+    sym_list::sym_type_e type;
+
+    auto structIt = knownStructTypes.constFind(typeName);
+    if (structIt != knownStructTypes.constEnd()) {
+        type = structIt.value() ? sym_list::sym_packed_struct_var : sym_list::sym_unpacked_struct_var;
+    } else if (knownEnumTypes.contains(typeName)) {
+        type = sym_list::sym_enum_var;
+    } else {
+        return index + 1;
+    }
+
+    const int j = skipDimensions(index + 1);
+    if (!isPlainIdentifier(j) ||
+        !(isPunct(j + 1, ';') || isPunct(j + 1, ',') || isPunct(j + 1, '=') ||
+          isPunct(j + 1, '[') || isPunct(j + 1, ')'))) {
+        return index + 1;
+    }
+
+    // moduleScope存储变量的类型名，供成员/枚举值补全使用
+    return parseDeclarators(j, type, index, tokenString(index));
+}
@@ -0,0 +1,95 @@
+#ifndef SVDECLARATIONPARSER_H
+#define SVDECLARATIONPARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSet>
+
+#include "svlexer.h"
+#include "syminfo.h"
+#include "scopetree.h"
+
+// 🚀 基于SVLexer词法单元的声明解析器
+// 一次遍历词法单元即可提取 module/interface/变量/task/function/typedef/enum/struct/
+// parameter/预处理/约束 等全部符号，取代原先按符号种类逐个QRegExp全文扫描的做法。
+// 解析器不访问sym_list单例，只返回符号列表，由调用方决定如何合并。
+class SVDeclarationParser
+{
+public:
+    SVDeclarationParser(const QString& fileName, const QString& text);
+
+    // 其他文件中已知的struct/enum类型，用于识别 "my_struct_t var;" 形式的变量声明
+    void setKnownStructTypes(const QHash<QString, bool>& structTypes); // 类型名 -> 是否packed
+    void setKnownEnumTypes(const QSet<QString>& enumTypes);
+
+    // 🚀 NEW: 只解析文件的一段(从语句边界开始)时，传入该位置所在的模块(由外到内)
+    void setEnclosingModules(const QStringList& modules);
+
+    QList<sym_list::SymbolInfo> parse();
+
+    // parse() 期间记录的作用域树(module/generate/always/task/function/begin 等区间)
+    const ScopeTree& scopeTree() const { return scopes; }
+
+    // 🚀 NEW: 主循环经过的 ; 之后的位置(升序)，增量重解析从这些位置开始/结束可与全文解析结果一致
+    const QVector<int>& statementBoundaries() const { return boundaries; }
+
+    // 是否遇到了 module/endmodule(片段解析时意味着模块区间结构变化)
+    bool sawModuleBoundary() const { return moduleBoundarySeen; }
+
+private:
+    typedef SVLexer::Token Token;
+
+    QString fileName;
+    QString text;
+    SVLexer lexer;
+    const QVector<Token>& tokens;
+
+    QHash<QString, bool> knownStructTypes;
+    QSet<QString> knownEnumTypes;
+
+    QStringList enclosingModules;
+    QStringList moduleStack;
+    ScopeTree scopes;
+    QVector<int> boundaries;
+    bool moduleBoundarySeen = false;
+    QList<sym_list::SymbolInfo> results;
+
+    // 词法单元辅助判断
+    bool isPunct(int index, char c) const;
+    bool isKeyword(int index, SVLexer::Keyword keyword) const;
+    bool isPlainIdentifier(int index) const;
+    QString rawText(int index) const;
+    QString tokenString(int index) const;
+
+    int skipBalanced(int index) const;
+    int skipExpression(int index) const;
+    int skipDimensions(int index) const;
+    QString currentModule() const;
+    bool isPrototype(int index) const;
+    int openBlock(int index);
+    void closeScope(ScopeTree::Kind kind, int index);
+
+    void emitSymbol(sym_list::sym_type_e type, int anchorIndex, int nameIndex, const QString& scope);
+
+    // 各类声明的解析，返回解析结束后的词法单元下标
+    int parseModule(int index);
+    int parseInterface(int index);
+    int parseModport(int index);
+    int parsePackage(int index);
+    int parseNetDeclaration(int index);
+    int parseSubroutine(int index);
+    int parseTypedef(int index);
+    int parseEnumBody(int index, QList<int>& valueIndexes) const;
+    int parseStructBody(int index, QList<int>& memberIndexes) const;
+    int parseAnonymousEnum(int index);
+    int parseAnonymousStruct(int index);
+    int parseParameters(int index);
+    int parseDirective(int index);
+    int parseConstraint(int index);
+    int parseTypedVariables(int index);
+    int parseDeclarators(int index, sym_list::sym_type_e type, int anchorIndex, const QString& scope);
+};
+
+#endif // SVDECLARATIONPARSER_H
@@ -0,0 +1,357 @@
+#include "svlexer.h"
+#include "textscanner.h"
+
+#include <QHash>
+
+namespace {
+
+inline bool isIdentifierStart(ushort c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+           (c > 127 && QChar(c).isLetter());
+}
+
+inline bool isIdentifierChar(ushort c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c == '$' ||
+           (c > 127 && QChar(c).isLetterOrNumber());
+}
+
+inline bool isDigit(ushort c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isNumberChar(ushort c)
+{
+    // 覆盖十进制/十六进制/x/z/?以及下划线分隔
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+           (c >= 'A' && c <= 'Z') || c == '_' || c == '?';
+}
+
+inline bool isBaseChar(ushort c)
+{
+    return c == 'b' || c == 'B' || c == 'o' || c == 'O' ||
+           c == 'd' || c == 'D' || c == 'h' || c == 'H' ||
+           c == 's' || c == 'S';
+}
+
+// '0 / '1 / 'x / 'z 以及 'h 'b 'sd 等无位宽字面量；'{ 和 int'(x) 类型转换不属于数字
+inline bool isUnsizedLiteralChar(ushort c)
+{
+    return isBaseChar(c) || c == '0' || c == '1' ||
+           c == 'x' || c == 'X' || c == 'z' || c == 'Z';
+}
+
+inline bool isHorizontalSpace(ushort c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+const QHash<QString, SVLexer::Keyword>& keywordTable()
+{
+    static const QHash<QString, SVLexer::Keyword> table = [] {
+        QHash<QString, SVLexer::Keyword> t;
+        t.reserve(128);
+
+        t.insert("module", SVLexer::KwModule);
+        t.insert("macromodule", SVLexer::KwMacromodule);
+        t.insert("endmodule", SVLexer::KwEndmodule);
+        t.insert("interface", SVLexer::KwInterface);
+        t.insert("endinterface", SVLexer::KwEndinterface);
+        t.insert("modport", SVLexer::KwModport);
+        t.insert("package", SVLexer::KwPackage);
+        t.insert("endpackage", SVLexer::KwEndpackage);
+        t.insert("reg", SVLexer::KwReg);
+        t.insert("wire", SVLexer::KwWire);
+        t.insert("logic", SVLexer::KwLogic);
+        t.insert("task", SVLexer::KwTask);
+        t.insert("endtask", SVLexer::KwEndtask);
+        t.insert("function", SVLexer::KwFunction);
+        t.insert("endfunction", SVLexer::KwEndfunction);
+        t.insert("typedef", SVLexer::KwTypedef);
+        t.insert("struct", SVLexer::KwStruct);
+        t.insert("union", SVLexer::KwUnion);
+        t.insert("enum", SVLexer::KwEnum);
+        t.insert("packed", SVLexer::KwPacked);
+        t.insert("parameter", SVLexer::KwParameter);
+        t.insert("localparam", SVLexer::KwLocalparam);
+        t.insert("type", SVLexer::KwType);
+        t.insert("signed", SVLexer::KwSigned);
+        t.insert("unsigned", SVLexer::KwUnsigned);
+        t.insert("automatic", SVLexer::KwAutomatic);
+        t.insert("static", SVLexer::KwStatic);
+        t.insert("input", SVLexer::KwInput);
+        t.insert("output", SVLexer::KwOutput);
+        t.insert("inout", SVLexer::KwInout);
+        t.insert("ref", SVLexer::KwRef);
+        t.insert("var", SVLexer::KwVar);
+        t.insert("const", SVLexer::KwConst);
+        t.insert("begin", SVLexer::KwBegin);
+        t.insert("end", SVLexer::KwEnd);
+        t.insert("generate", SVLexer::KwGenerate);
+        t.insert("endgenerate", SVLexer::KwEndgenerate);
+        t.insert("fork", SVLexer::KwFork);
+        t.insert("join", SVLexer::KwJoin);
+        t.insert("join_any", SVLexer::KwJoin);
+        t.insert("join_none", SVLexer::KwJoin);
+        t.insert("always", SVLexer::KwAlways);
+        t.insert("always_ff", SVLexer::KwAlways);
+        t.insert("always_comb", SVLexer::KwAlways);
+        t.insert("always_latch", SVLexer::KwAlways);
+        t.insert("initial", SVLexer::KwInitial);
+        t.insert("final", SVLexer::KwFinal);
+
+        // 预处理指令(去掉反引号后查找)
+        t.insert("define", SVLexer::KwDefine);
+        t.insert("ifdef", SVLexer::KwIfdef);
+        t.insert("ifndef", SVLexer::KwIfndef);
+        t.insert("elsif", SVLexer::KwElsif);
+        t.insert("else", SVLexer::KwElse);
+        t.insert("endif", SVLexer::KwEndif);
+
+        static const char* const otherKeywords[] = {
+            "always", "always_ff", "always_comb", "always_latch", "assign", "initial", "final",
+            "if", "case", "casex", "casez", "endcase", "default", "unique", "priority",
+            "for", "while", "repeat", "forever", "do", "foreach", "return", "break", "continue",
+            "posedge", "negedge", "edge", "or", "and", "not", "xor", "nand", "nor", "xnor",
+            "bit", "byte", "shortint", "int", "longint", "integer", "time", "real", "shortreal",
+            "realtime", "string", "chandle", "event", "void", "genvar", "tri", "supply0", "supply1",
+            "class", "endclass", "extends", "implements", "virtual", "pure", "extern", "import", "export",
+            "new", "null", "this", "super", "local", "protected", "rand", "randc", "constraint",
+            "program", "endprogram", "clocking", "endclocking", "property", "endproperty",
+            "sequence", "endsequence", "assert", "assume", "cover", "fork", "join", "join_any",
+            "join_none", "wait", "disable", "force", "release", "deassign", "specify", "endspecify",
+            "primitive", "endprimitive", "table", "endtable", "include", "timescale", "undef"
+        };
+        for (const char* keyword : otherKeywords) {
+            if (!t.contains(QLatin1String(keyword))) {
+                t.insert(QLatin1String(keyword), SVLexer::KwOther);
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+} // namespace
+
+SVLexer::SVLexer(const QString& text)
+    : source(text)
+{
+    tokenize();
+}
+
+SVLexer::Keyword SVLexer::lookupKeyword(const QChar* data, int length)
+{
+    // fromRawData不复制字符数据，关键字查找不产生内存分配
+    const QString word = QString::fromRawData(data, length);
+    return keywordTable().value(word, KwNone);
+}
+
+void SVLexer::tokenize()
+{
+    tokenList.clear();
+    tokenList.reserve(source.size() / 4 + 16);
+
+    const QChar* data = source.constData();
+    const int size = source.size();
+
+    int pos = 0;
+    int line = 0;
+    int lineStart = 0;
+
+    while (pos < size) {
+        const ushort c = data[pos].unicode();
+
+        if (c == '\n') {
+            ++line;
+            lineStart = ++pos;
+            continue;
+        }
+
+        if (isHorizontalSpace(c)) {
+            ++pos;
+            continue;
+        }
+
+        // 注释：直接跳过，不产生词法单元
+        if (c == '/' && pos + 1 < size) {
+            const ushort next = data[pos + 1].unicode();
+            if (next == '/') {
+                pos = TextScanner::indexOf(data, pos + 2, size, '\n');
+                continue;
+            }
+            if (next == '*') {
+                // 🚀 注释体内只关心 * 与换行，向量化跳过其余字符
+                pos += 2;
+                while ((pos = TextScanner::indexOfAny(data, pos, size, '*', '\n')) < size) {
+                    if (data[pos].unicode() == '\n') {
+                        ++line;
+                        lineStart = ++pos;
+                        continue;
+                    }
+                    if (pos + 1 < size && data[pos + 1].unicode() == '/') {
+                        pos += 2;
+                        break;
+                    }
+                    ++pos;
+                }
+                continue;
+            }
+        }
+
+        Token token;
+        token.kind = Punctuation;
+        token.keyword = KwNone;
+        token.position = pos;
+        token.line = line;
+        token.column = pos - lineStart;
+
+        if (isIdentifierStart(c)) {
+            int end = pos + 1;
+            while (end < size && isIdentifierChar(data[end].unicode())) {
+                ++end;
+            }
+            token.kind = Identifier;
+            token.keyword = lookupKeyword(data + pos, end - pos);
+            pos = end;
+        } else if (c == '$' || c == '\\') {
+            // 系统任务($display)与转义标识符(\bus[0] )
+            int end = pos + 1;
+            if (c == '$') {
+                while (end < size && isIdentifierChar(data[end].unicode())) {
+                    ++end;
+                }
+            } else {
+                while (end < size && !data[end].isSpace()) {
+                    ++end;
+                }
+            }
+            token.kind = Identifier;
+            token.keyword = (c == '$') ? KwOther : KwNone;
+            pos = end;
+        } else if (isDigit(c) || (c == '\'' && pos + 1 < size && isUnsizedLiteralChar(data[pos + 1].unicode()))) {
+            int end = pos;
+            if (c != '\'') {
+                while (end < size && (isDigit(data[end].unicode()) || data[end].unicode() == '_' ||
+                                      data[end].unicode() == '.')) {
+                    ++end;
+                }
+            }
+            // 基数形式: 'h / 'sb 等
+            if (end < size && data[end].unicode() == '\'') {
+                ++end;
+                while (end < size && isNumberChar(data[end].unicode())) {
+                    ++end;
+                }
+            }
+            token.kind = Number;
+            pos = qMax(end, pos + 1);
+        } else if (c == '"') {
+            int end = pos + 1;
+            while ((end = TextScanner::indexOfAny(data, end, size, '\\', '"', '\n')) < size) {
+                const ushort ch = data[end].unicode();
+                if (ch == '\\' && end + 1 < size) {
+                    if (data[end + 1].unicode() == '\n') {
+                        ++line;
+                        lineStart = end + 2;
+                    }
+                    end += 2;
+                    continue;
+                }
+                if (ch == '"') {
+                    ++end;
+                    break;
+                }
+                if (ch == '\n') {
+                    break; // 未闭合的字符串到行尾为止
+                }
+                ++end;      // 末尾的单个反斜杠
+            }
+            token.kind = StringLiteral;
+            pos = end;
+        } else if (c == '`') {
+            int end = pos + 1;
+            while (end < size && isIdentifierChar(data[end].unicode())) {
+                ++end;
+            }
+            token.kind = Directive;
+            token.keyword = (end > pos + 1) ? lookupKeyword(data + pos + 1, end - pos - 1) : KwNone;
+            token.length = end - pos;
+            tokenList.append(token);
+            pos = end;
+
+            if (token.keyword == KwDefine) {
+                pos = lexMacroBody(pos, line, lineStart);
+            }
+            continue;
+        } else {
+            pos = pos + 1;
+        }
+
+        token.length = pos - token.position;
+        tokenList.append(token);
+    }
+}
+
+// `define NAME 之后的宏体作为单个词法单元，避免其中的文本被误识别为声明
+int SVLexer::lexMacroBody(int pos, int& line, int& lineStart)
+{
+    const QChar* data = source.constData();
+    const int size = source.size();
+
+    while (pos < size && isHorizontalSpace(data[pos].unicode())) {
+        ++pos;
+    }
+
+    // 宏名
+    if (pos < size && isIdentifierStart(data[pos].unicode())) {
+        Token nameToken;
+        nameToken.kind = Identifier;
+        nameToken.keyword = KwNone;
+        nameToken.position = pos;
+        nameToken.line = line;
+        nameToken.column = pos - lineStart;
+        int end = pos + 1;
+        while (end < size && isIdentifierChar(data[end].unicode())) {
+            ++end;
+        }
+        nameToken.length = end - pos;
+        tokenList.append(nameToken);
+        pos = end;
+    }
+
+    Token body;
+    body.kind = MacroBody;
+    body.keyword = KwNone;
+    body.position = pos;
+    body.line = line;
+    body.column = pos - lineStart;
+
+    // 宏体到逻辑行尾：反斜杠续行，遇到注释时停止，交由主循环跳过注释
+    while ((pos = TextScanner::indexOfAny(data, pos, size, '\\', '\n', '/')) < size) {
+        const ushort ch = data[pos].unicode();
+        if (ch == '\\' && pos + 1 < size && data[pos + 1].unicode() == '\n') {
+            pos += 2;
+            ++line;
+            lineStart = pos;
+            continue;
+        }
+        if (ch == '\n') {
+            break;
+        }
+        if (ch == '/' && pos + 1 < size &&
+            (data[pos + 1].unicode() == '/' || data[pos + 1].unicode() == '*')) {
+            break;
+        }
+        ++pos;
+    }
+
+    body.length = pos - body.position;
+    if (body.length > 0) {
+        tokenList.append(body);
+    }
+    return pos;
+}
@@ -0,0 +1,73 @@
+#ifndef SVLEXER_H
+#define SVLEXER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+// 🚀 单遍SystemVerilog词法分析器
+// 一次扫描完成标识符/数字/字符串/预处理指令的切分，同时跳过 // 与 /* */ 注释，
+// 并为每个词法单元记录行列号，供声明解析器直接使用
+class SVLexer
+{
+public:
+    enum TokenKind {
+        Identifier,      // 标识符或关键字
+        Number,          // 数字字面量 (含 8'hFF 形式)
+        StringLiteral,   // "..." 字符串
+        Directive,       // `define / `ifdef 等预处理指令
+        MacroBody,       // `define 的宏体(直到逻辑行尾)
+        Punctuation      // 单字符标点
+    };
+
+    enum Keyword {
+        KwNone = 0,
+
+        // 声明相关关键字
+        KwModule, KwMacromodule, KwEndmodule,
+        KwInterface, KwEndinterface, KwModport,
+        KwPackage, KwEndpackage,
+        KwReg, KwWire, KwLogic,
+        KwTask, KwEndtask, KwFunction, KwEndfunction,
+        KwTypedef, KwStruct, KwUnion, KwEnum, KwPacked,
+        KwParameter, KwLocalparam, KwType,
+        KwSigned, KwUnsigned, KwAutomatic, KwStatic,
+        KwInput, KwOutput, KwInout, KwRef, KwVar, KwConst,
+        KwBegin, KwEnd, KwGenerate, KwEndgenerate,
+        KwFork, KwJoin,                         // join / join_any / join_none
+        KwAlways, KwInitial, KwFinal,           // always / always_ff / always_comb / always_latch
+
+        // 预处理指令 (仅用于Directive词法单元)
+        KwDefine, KwIfdef, KwIfndef, KwElsif, KwElse, KwEndif,
+
+        KwOther          // 其他保留字，不能作为声明名称
+    };
+
+    struct Token {
+        TokenKind kind;
+        Keyword keyword;
+        int position;
+        int length;
+        int line;
+        int column;
+
+        int end() const { return position + length; }
+    };
+
+    explicit SVLexer(const QString& text);
+
+    const QVector<Token>& tokens() const { return tokenList; }
+    QStringRef tokenText(const Token& token) const { return source.midRef(token.position, token.length); }
+    QString tokenString(const Token& token) const { return source.mid(token.position, token.length); }
+
+    static Keyword lookupKeyword(const QChar* data, int length);
+
+private:
+    QString source;
+    QVector<Token> tokenList;
+
+    void tokenize();
+    int lexMacroBody(int pos, int& line, int& lineStart);
+};
+
+#endif // SVLEXER_H
@@ -0,0 +1,95 @@
+#include "svpatternregistry.h"
+
+#include <QStringList>
+
+namespace {
+
+struct PatternSource {
+    SVPatternRegistry::PatternKind kind;
+    const char* source;
+    bool caseInsensitive;
+};
+
+const PatternSource patternSources[] = {
+    { SVPatternRegistry::ModuleInstantiation, "([a-zA-Z_][a-zA-Z0-9_]*)\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(", false },
+    { SVPatternRegistry::VariableAssignment,  "([a-zA-Z_][a-zA-Z0-9_]*)\\s*=\\s*([^;]+);", false },
+    { SVPatternRegistry::Condition,           "\\b(if|case|while)\\s*\\(", false },
+    { SVPatternRegistry::TaskCall,            "([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(.*\\)\\s*;|([a-zA-Z_][a-zA-Z0-9_]*)\\s*;", false },
+    { SVPatternRegistry::FunctionCall,        "([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(.*\\)", false },
+    { SVPatternRegistry::AlwaysBlock,         "always\\s*(@.*)?\\s*begin", false },
+    { SVPatternRegistry::GenerateBlock,       "generate\\s*begin", false },
+    { SVPatternRegistry::Declaration,         "\\b(reg|wire|logic|input|output)\\b", false },
+    { SVPatternRegistry::ClockName,           "\\b(clk|clock)\\b", true },
+    { SVPatternRegistry::ClockEdge,           "\\b(posedge|negedge)\\b", true },
+    { SVPatternRegistry::ResetSignal,         "\\b(rst|reset|rstn)\\b", true }
+};
+
+QRegularExpression compiled(const QString& source,
+                            QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption)
+{
+    QRegularExpression regex(source, options);
+    regex.optimize();
+    return regex;
+}
+
+} // namespace
+
+const SVPatternRegistry* SVPatternRegistry::getInstance()
+{
+    // 构造一次，之后只读
+    static const SVPatternRegistry registry;
+    return &registry;
+}
+
+SVPatternRegistry::SVPatternRegistry()
+{
+    Q_STATIC_ASSERT(sizeof(patternSources) / sizeof(patternSources[0]) == PatternKindCount);
+
+    // 合成匹配器：\A(?=(?:.*?(?<k0>模式0))?)(?=(?:.*?(?<k1>模式1))?)...
+    // 每个前瞻都从行首出发且总能成功，命中的类别在对应命名组里留下捕获
+    QString combinedSource = QStringLiteral("\\A");
+    for (const PatternSource& source : patternSources) {
+        const QString text = QString::fromLatin1(source.source);
+        patterns[source.kind] = compiled(text, source.caseInsensitive
+                                                   ? QRegularExpression::CaseInsensitiveOption
+                                                   : QRegularExpression::NoPatternOption);
+
+        combinedSource += QStringLiteral("(?=(?:.*?(?<k") + QString::number(int(source.kind)) + QLatin1Char('>')
+                        + (source.caseInsensitive ? QStringLiteral("(?i:") : QStringLiteral("(?:"))
+                        + text + QStringLiteral(")))?)");
+    }
+    combined = compiled(combinedSource);
+
+    const QStringList groupNames = combined.namedCaptureGroups();
+    combinedGroups.resize(PatternKindCount);
+    for (int kind = 0; kind < PatternKindCount; ++kind) {
+        combinedGroups[kind] = groupNames.indexOf(QStringLiteral("k%1").arg(kind));
+    }
+
+    conditionRegex = compiled(QStringLiteral("\\b(if|case|while)\\s*\\(([^)]+)\\)"));
+    sensitivityRegex = compiled(QStringLiteral("always\\s*@\\s*\\(([^)]+)\\)"));
+    clockRegex = compiled(QStringLiteral("(posedge|negedge)\\s+([a-zA-Z_][a-zA-Z0-9_]*)"));
+    resetRegex = compiled(QStringLiteral("\\b(rst|reset|rstn|rst_n)\\b"));
+    identifierRegex = compiled(QStringLiteral("\\b([a-zA-Z_][a-zA-Z0-9_]*)\\b"));
+}
+
+SVPatternRegistry::KindMask SVPatternRegistry::classify(const QString& line) const
+{
+    if (line.isEmpty()) {
+        return 0;
+    }
+
+    const QRegularExpressionMatch match = combined.match(line);
+    if (!match.hasMatch()) {
+        return 0;
+    }
+
+    KindMask kinds = 0;
+    for (int kind = 0; kind < PatternKindCount; ++kind) {
+        const int group = combinedGroups[kind];
+        if (group > 0 && match.capturedStart(group) >= 0) {
+            kinds |= bit(PatternKind(kind));
+        }
+    }
+    return kinds;
+}
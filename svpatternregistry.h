@@ -0,0 +1,63 @@
+#ifndef SVPATTERNREGISTRY_H
+#define SVPATTERNREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QRegularExpression>
+
+// 🚀 行级分析模式注册表
+// 关系分析用到的全部模式在进程内只编译一次(QRegularExpression + optimize()，Qt支持时走PCRE2 JIT)，
+// 取代每次调用、每一行都重新构造 QRegExp 的做法。
+// 另外把所有类别合成一个匹配器：每个类别占一个"可选前瞻"命名组，对一行只调用一次 match，
+// 就能得到该行可能命中的全部类别(位掩码)。该掩码只作预筛选，命中后仍由各类别的模式取捕获组。
+// 注册表构造后不再修改，可在任意线程并发使用。
+class SVPatternRegistry
+{
+public:
+    enum PatternKind {
+        ModuleInstantiation = 0,    // module_name instance_name (
+        VariableAssignment,         // variable = expression;
+        Condition,                  // if/case/while (
+        TaskCall,                   // task_name(args); 或 task_name;
+        FunctionCall,               // function_name(args)
+        AlwaysBlock,                // always @(...) begin
+        GenerateBlock,              // generate begin
+        Declaration,                // reg/wire/logic/input/output
+        ClockName,                  // clk/clock，不区分大小写
+        ClockEdge,                  // posedge/negedge，不区分大小写
+        ResetSignal,                // rst/reset/rstn，不区分大小写
+        PatternKindCount
+    };
+
+    typedef quint32 KindMask;
+    static KindMask bit(PatternKind kind) { return KindMask(1) << kind; }
+
+    static const SVPatternRegistry* getInstance();
+
+    const QRegularExpression& pattern(PatternKind kind) const { return patterns[kind]; }
+
+    // 只在已预筛选的行上使用的辅助模式
+    const QRegularExpression& conditionExpression() const { return conditionRegex; }     // cap(2) = 条件表达式
+    const QRegularExpression& sensitivityList() const { return sensitivityRegex; }       // cap(1) = 敏感列表
+    const QRegularExpression& clockSignal() const { return clockRegex; }                 // cap(2) = 时钟名(小写行)
+    const QRegularExpression& resetName() const { return resetRegex; }                   // cap(1) = 复位名(小写行)
+    const QRegularExpression& identifier() const { return identifierRegex; }
+
+    // 一次匹配返回该行可能命中的全部类别
+    KindMask classify(const QString& line) const;
+
+private:
+    SVPatternRegistry();
+
+    QRegularExpression patterns[PatternKindCount];
+    QRegularExpression combined;
+    QVector<int> combinedGroups;        // 类别 -> 合成匹配器中的捕获组序号
+
+    QRegularExpression conditionRegex;
+    QRegularExpression sensitivityRegex;
+    QRegularExpression clockRegex;
+    QRegularExpression resetRegex;
+    QRegularExpression identifierRegex;
+};
+
+#endif // SVPATTERNREGISTRY_H
@@ -3,6 +3,8 @@
 #include "workspacemanager.h"
 #include "mycodeeditor.h"
 #include "completionmanager.h"
+#include "workspaceindexer.h"
+#include "symbolindexcache.h"
 //#include <QDebug>
 #include <QFile>
 #include <QTextStream>
@@ -10,7 +12,18 @@
 
 SymbolAnalyzer::SymbolAnalyzer(QObject *parent)
     : QObject(parent)
+    , compactionTimer(new QTimer(this))
+    , workspaceIndexer(new WorkspaceIndexer(this))
 {
+    // 🚀 符号存储压缩放在编辑停顿之后进行，不占用保存/分析的热路径
+    compactionTimer->setSingleShot(true);
+    compactionTimer->setInterval(5000);
+    connect(compactionTimer, &QTimer::timeout, this, &SymbolAnalyzer::onCompactionTimer);
+
+    connect(workspaceIndexer, &WorkspaceIndexer::progressChanged,
+            this, &SymbolAnalyzer::analysisProgress);
+    connect(workspaceIndexer, &WorkspaceIndexer::finished,
+            this, &SymbolAnalyzer::onWorkspaceIndexingFinished);
 }
 
 SymbolAnalyzer::~SymbolAnalyzer()
@@ -40,6 +53,9 @@ void SymbolAnalyzer::analyzeOpenTabs(TabManager* tabManager)
     QStringList openFileNames = tabManager->getAllOpenFileNames();
     QStringList svFiles = tabManager->getOpenSystemVerilogFiles();
 
+    // 🚀 整批替换打开文件的分片：只发布一次快照、失效一次补全缓存
+    symbolList->beginBatch();
+
     // Clear existing symbols for these files
     for (const QString& fileName : qAsConst(openFileNames)) {
         symbolList->clearSymbolsForFile(fileName);
@@ -60,14 +76,13 @@ void SymbolAnalyzer::analyzeOpenTabs(TabManager* tabManager)
         }
     }
 
+    symbolList->commitBatch();
+
     // Get final symbol count
-    QList<sym_list::SymbolInfo> allSymbols = symbolList->getAllSymbols();
     int symbolsFromOpenFiles = 0;
 
-    for (const sym_list::SymbolInfo& symbol : qAsConst(allSymbols)) {
-        if (openFileNames.contains(symbol.fileName)) {
-            symbolsFromOpenFiles++;
-        }
+    for (const QString& fileName : qAsConst(openFileNames)) {
+        symbolsFromOpenFiles += symbolList->findSymbolsByFileName(fileName).size();
     }
 
     emit analysisCompleted("open_tabs", symbolsFromOpenFiles);
@@ -77,31 +92,40 @@ void SymbolAnalyzer::analyzeWorkspace(WorkspaceManager* workspaceManager)
 {
     if (!workspaceManager || !workspaceManager->isWorkspaceOpen()) return;
 
-    emit analysisStarted(workspaceManager->getWorkspacePath());
+    indexedWorkspacePath = workspaceManager->getWorkspacePath();
+    emit analysisStarted(indexedWorkspacePath);
 
-    QStringList svFiles = workspaceManager->getSystemVerilogFiles();
-
-    sym_list* symbolList = sym_list::getInstance();
-    int totalSymbolsFound = 0;
+    // 🚀 各文件在线程池上并行解析，结果回到主线程分批合并；正在进行的上一轮会被取消后重新开始
+    // 未变化的文件从工作区的磁盘索引缓存恢复
+    workspaceIndexer->start(workspaceManager->getSystemVerilogFiles(),
+                            SymbolIndexCache::cachePathForWorkspace(indexedWorkspacePath));
+}
 
-    for (const QString& filePath : qAsConst(svFiles)) {
-        auto tempEditor = createBackgroundEditor(filePath);
-        if (!tempEditor) {
-            continue;
-        }
+void SymbolAnalyzer::cancelWorkspaceAnalysis()
+{
+    workspaceIndexer->cancel();
+}
 
-        int symbolsBefore = symbolList->getAllSymbols().size();
-        symbolList->setCodeEditorIncremental(tempEditor.get());
-        int symbolsAfter = symbolList->getAllSymbols().size();
+bool SymbolAnalyzer::isWorkspaceAnalysisRunning() const
+{
+    return workspaceIndexer->isRunning();
+}
 
-        totalSymbolsFound += (symbolsAfter - symbolsBefore);
-    }
+void SymbolAnalyzer::onWorkspaceIndexingFinished(int filesIndexed, int symbolsFound, bool cancelled)
+{
+    // 批量分析结束，直接清理失效句柄
+    sym_list::getInstance()->compactStorage();
 
     // Force refresh completion caches
     CompletionManager::getInstance()->forceRefreshSymbolCaches();
 
-    emit batchAnalysisCompleted(svFiles.size(), totalSymbolsFound);
-    emit analysisCompleted(workspaceManager->getWorkspacePath(), totalSymbolsFound);
+    if (cancelled) {
+        emit batchAnalysisCancelled(filesIndexed, symbolsFound);
+        return;
+    }
+
+    emit batchAnalysisCompleted(filesIndexed, symbolsFound);
+    emit analysisCompleted(indexedWorkspacePath, symbolsFound);
 }
 
 void SymbolAnalyzer::analyzeFile(const QString& filePath)
@@ -110,19 +134,22 @@ void SymbolAnalyzer::analyzeFile(const QString& filePath)
 
     emit analysisStarted(filePath);
 
-    auto tempEditor = createBackgroundEditor(filePath);
-    if (!tempEditor) {
+    // 🚀 直接分析文件文本，不再为此构造隐藏的编辑器控件
+    QString content;
+    if (!readFileText(filePath, content)) {
         return;
     }
 
     sym_list* symbolList = sym_list::getInstance();
-    int symbolsBefore = symbolList->getAllSymbols().size();
+    int symbolsBefore = symbolList->getSymbolCount();
 
-    symbolList->setCodeEditorIncremental(tempEditor.get());
+    symbolList->analyzeTextIncremental(filePath, content);
 
-    int symbolsAfter = symbolList->getAllSymbols().size();
+    int symbolsAfter = symbolList->getSymbolCount();
     int symbolsFound = symbolsAfter - symbolsBefore;
 
+    scheduleStorageCompaction();
+
     emit analysisCompleted(filePath, symbolsFound);
 }
 
@@ -138,7 +165,7 @@ void SymbolAnalyzer::analyzeEditor(MyCodeEditor* editor, bool incremental)
     emit analysisStarted(fileName);
 
     sym_list* symbolList = sym_list::getInstance();
-    int symbolsBefore = symbolList->getAllSymbols().size();
+    int symbolsBefore = symbolList->getSymbolCount();
 
     if (incremental) {
         symbolList->setCodeEditorIncremental(editor);
@@ -146,9 +173,11 @@ void SymbolAnalyzer::analyzeEditor(MyCodeEditor* editor, bool incremental)
         symbolList->setCodeEditor(editor);
     }
 
-    int symbolsAfter = symbolList->getAllSymbols().size();
+    int symbolsAfter = symbolList->getSymbolCount();
     int symbolsFound = symbolsAfter - symbolsBefore;
 
+    scheduleStorageCompaction();
+
     emit analysisCompleted(fileName, symbolsFound);
 }
 
@@ -221,17 +250,27 @@ void SymbolAnalyzer::cancelScheduledAnalysis(MyCodeEditor* editor)
 
 bool SymbolAnalyzer::isAnalysisNeeded(const QString& fileName, const QString& content) const
 {
-    if (!lastAnalyzedContent.contains(fileName)) return true;
-
-    return lastAnalyzedContent[fileName] != content;
+    // 🔧 FIX: 不再为每个文件保存一份上次分析的全文，按 sym_list 记录的内容哈希判断
+    return sym_list::getInstance()->needsAnalysis(fileName, content);
 }
 
 void SymbolAnalyzer::invalidateCache()
 {
-    lastAnalyzedContent.clear();
     CompletionManager::getInstance()->invalidateAllCaches();
 }
 
+void SymbolAnalyzer::scheduleStorageCompaction()
+{
+    if (sym_list::getInstance()->needsCompaction()) {
+        compactionTimer->start();   // 重新计时，持续编辑时不会触发
+    }
+}
+
+void SymbolAnalyzer::onCompactionTimer()
+{
+    sym_list::getInstance()->compactStorage();
+}
+
 void SymbolAnalyzer::onIncrementalAnalysisTimer()
 {
     QTimer* timer = qobject_cast<QTimer*>(sender());
@@ -268,25 +307,19 @@ void SymbolAnalyzer::onSignificantAnalysisTimer()
     }
 }
 
-std::unique_ptr<MyCodeEditor> SymbolAnalyzer::createBackgroundEditor(const QString& filePath)
+bool SymbolAnalyzer::readFileText(const QString& filePath, QString& content) const
 {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QFile::Text)) {
-        return nullptr;
+        return false;
     }
 
-    // Create editor with smart pointer
-    auto tempEditor = std::unique_ptr<MyCodeEditor>(new MyCodeEditor());
-    tempEditor->setVisible(false);
-
-    // Load content efficiently
     QTextStream in(&file);
-    tempEditor->setPlainText(in.readAll());
-    tempEditor->setFileName(filePath);
+    content = in.readAll();
 
     file.close();
 
-    return tempEditor;
+    return true;
 }
 
 QStringList SymbolAnalyzer::filterSystemVerilogFiles(const QStringList& files) const
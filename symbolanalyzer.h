@@ -9,6 +9,7 @@
 class MyCodeEditor;
 class TabManager;
 class WorkspaceManager;
+class WorkspaceIndexer;
 
 class SymbolAnalyzer : public QObject
 {
@@ -24,6 +25,10 @@ public:
     void analyzeFile(const QString& filePath);
     void analyzeEditor(MyCodeEditor* editor, bool incremental = false);
 
+    // 🚀 NEW: 工作区分析在线程池上异步进行，完成时发出 batchAnalysisCompleted
+    void cancelWorkspaceAnalysis();
+    bool isWorkspaceAnalysisRunning() const;
+
     // Analysis control
     void scheduleIncrementalAnalysis(MyCodeEditor* editor, int delay = 1000);
     void scheduleSignificantAnalysis(MyCodeEditor* editor, int delay = 2000);
@@ -37,23 +42,30 @@ signals:
     void analysisStarted(const QString& fileName);
     void analysisCompleted(const QString& fileName, int symbolsFound);
     void batchAnalysisCompleted(int filesAnalyzed, int totalSymbols);
+    void analysisProgress(int filesAnalyzed, int totalFiles, const QString& currentFile);
+    void batchAnalysisCancelled(int filesAnalyzed, int totalSymbols);
 
 private slots:
     void onIncrementalAnalysisTimer();
     void onSignificantAnalysisTimer();
+    void onCompactionTimer();
+    void onWorkspaceIndexingFinished(int filesIndexed, int symbolsFound, bool cancelled);
 
 private:
     // Timers for delayed analysis
     QHash<MyCodeEditor*, QTimer*> incrementalTimers;
     QHash<MyCodeEditor*, QTimer*> significantTimers;
 
-    // Analysis state tracking
-    QHash<QString, QString> lastAnalyzedContent;
+    QTimer* compactionTimer;
+
+    WorkspaceIndexer* workspaceIndexer;
+    QString indexedWorkspacePath;
 
     // Helper methods
-    std::unique_ptr<MyCodeEditor> createBackgroundEditor(const QString& filePath);
+    bool readFileText(const QString& filePath, QString& content) const;
     QStringList filterSystemVerilogFiles(const QStringList& files) const;
     void cleanupTimer(MyCodeEditor* editor);
+    void scheduleStorageCompaction();
     bool hasSignificantChanges(const QString& oldContent, const QString& newContent) const;
     bool isSystemVerilogFile(const QString &fileName) const;
 };
@@ -0,0 +1,288 @@
+#include "symbolindexcache.h"
+#include "symbolsnapshot.h"
+#include "symbolshard.h"
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <limits>
+
+SymbolIndexCache::SymbolIndexCache()
+{
+}
+
+SymbolIndexCache::~SymbolIndexCache()
+{
+    close();
+}
+
+QString SymbolIndexCache::cachePathForWorkspace(const QString& workspacePath)
+{
+    if (workspacePath.isEmpty()) {
+        return QString();
+    }
+    return QDir(workspacePath).filePath(".zeroslack/symbols.idx");
+}
+
+SymbolIndexCache::FileStamp SymbolIndexCache::stampOf(const QString& filePath)
+{
+    FileStamp stamp;
+    const QFileInfo info(filePath);
+    if (info.exists()) {
+        stamp.modifiedTime = info.lastModified().toMSecsSinceEpoch();
+        stamp.size = info.size();
+    }
+    return stamp;
+}
+
+bool SymbolIndexCache::open(const QString& cacheFilePath)
+{
+    close();
+
+    if (cacheFilePath.isEmpty()) {
+        return false;
+    }
+
+    cacheFile.setFileName(cacheFilePath);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // 🔧 FIX: 记录以 QByteArray::fromRawData(int 长度) 解码，2GB 以上的缓存视为不支持，当作空缓存
+    mappedSize = cacheFile.size();
+    if (mappedSize > std::numeric_limits<int>::max()) {
+        cacheFile.close();
+        mappedSize = 0;
+        return false;
+    }
+    mappedData = mappedSize > 0 ? cacheFile.map(0, mappedSize) : nullptr;
+    if (!mappedData) {
+        cacheFile.close();
+        return false;
+    }
+
+    // 目录紧跟在文件头之后；各文件的记录留在映射内存中，用到时再解码
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData),
+                                                     static_cast<int>(mappedSize));
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 entryCount = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != FormatVersion) {
+        close();
+        return false;
+    }
+
+    in >> entryCount;
+    entries.reserve(static_cast<int>(entryCount));
+    for (quint32 i = 0; i < entryCount && in.status() == QDataStream::Ok; ++i) {
+        QString filePath;
+        Entry entry;
+        in >> filePath
+           >> entry.stamp.modifiedTime >> entry.stamp.size >> entry.stamp.contentHash >> entry.stamp.knownTypes
+           >> entry.offset >> entry.length;
+        entries.insert(filePath, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        close();
+        return false;
+    }
+
+    dataStart = in.device()->pos();
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (dataStart + it.value().offset + it.value().length > static_cast<quint64>(mappedSize)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SymbolIndexCache::close()
+{
+    if (mappedData) {
+        cacheFile.unmap(const_cast<uchar*>(mappedData));
+        mappedData = nullptr;
+    }
+    if (cacheFile.isOpen()) {
+        cacheFile.close();
+    }
+
+    mappedSize = 0;
+    dataStart = 0;
+    entries.clear();
+}
+
+bool SymbolIndexCache::lookup(const QString& filePath, const FileStamp& current, FileStamp& cached) const
+{
+    auto it = entries.constFind(filePath);
+    if (it == entries.constEnd() || !it.value().stamp.matches(current)) {
+        return false;
+    }
+
+    cached = it.value().stamp;
+    return true;
+}
+
+bool SymbolIndexCache::load(const QString& filePath, CachedFile& cachedFile) const
+{
+    auto it = entries.constFind(filePath);
+    if (it == entries.constEnd()) {
+        return false;
+    }
+
+    // 直接在映射内存上解码，不复制记录
+    const Entry& entry = it.value();
+    const QByteArray bytes = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(mappedData + dataStart + entry.offset), static_cast<int>(entry.length));
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    qint32 symbolCount = 0;
+    in >> symbolCount;
+
+    // 记录可能已损坏：预留量不超过记录本身所能容纳的符号数
+    cachedFile.symbols.clear();
+    cachedFile.symbols.reserve(qBound(0, symbolCount, static_cast<int>(entry.length / 4)));
+    for (qint32 i = 0; i < symbolCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 symbolType = 0, startLine = 0, startColumn = 0, endLine = 0, endColumn = 0;
+        qint32 position = 0, length = 0, scopeLevel = 0;
+
+        sym_list::SymbolInfo symbol;
+        in >> symbol.symbolName >> symbolType
+           >> startLine >> startColumn >> endLine >> endColumn >> position >> length
+           >> symbol.moduleScope >> scopeLevel;
+
+        symbol.fileName = filePath;
+        symbol.symbolType = static_cast<sym_list::sym_type_e>(symbolType);
+        symbol.startLine = startLine;
+        symbol.startColumn = startColumn;
+        symbol.endLine = endLine;
+        symbol.endColumn = endColumn;
+        symbol.position = position;
+        symbol.length = length;
+        symbol.symbolId = -1;
+        symbol.scopeLevel = scopeLevel;
+        cachedFile.symbols.append(symbol);
+    }
+
+    in >> cachedFile.commentMask >> cachedFile.lineOffsets >> cachedFile.scopeTree
+       >> cachedFile.statementBoundaries;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // 🔧 FIX: 能完整解码不代表内容可用(损坏或手工修改的缓存)；不一致的记录当作未命中，重新解析
+    return isWellFormed(cachedFile);
+}
+
+// 只检查查询所依赖的前提：下标/移位不会越界，各表描述的是同一段文本
+bool SymbolIndexCache::isWellFormed(const CachedFile& cachedFile)
+{
+    if (!cachedFile.commentMask.isWellFormed() || !cachedFile.lineOffsets.isWellFormed() ||
+        !cachedFile.scopeTree.isWellFormed()) {
+        return false;
+    }
+
+    const int textLength = cachedFile.lineOffsets.length();
+    if (cachedFile.commentMask.length() != textLength) {
+        return false;
+    }
+
+    // 类型用作64位掩码的移位量(SymbolNameTrie::typeBit)
+    for (const sym_list::SymbolInfo& symbol : cachedFile.symbols) {
+        if (int(symbol.symbolType) < 0 || int(symbol.symbolType) >= 64 ||
+            symbol.position < 0 || symbol.position > textLength) {
+            return false;
+        }
+    }
+
+    int previous = 0;
+    for (int boundary : cachedFile.statementBoundaries) {
+        if (boundary < previous || boundary > textLength) {
+            return false;
+        }
+        previous = boundary;
+    }
+    return true;
+}
+
+QByteArray SymbolIndexCache::encodeFile(const QString& filePath, const SymbolSnapshot& snapshot)
+{
+    QByteArray block;
+    const std::shared_ptr<const SymbolShard> shard = snapshot.fileShard(filePath);
+    if (!shard) {
+        return block;
+    }
+
+    QDataStream out(&block, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+
+    const QList<sym_list::SymbolInfo> symbols = shard->symbols();
+    out << qint32(symbols.size());
+    for (const sym_list::SymbolInfo& symbol : symbols) {
+        out << symbol.symbolName << qint32(symbol.symbolType)
+            << qint32(symbol.startLine) << qint32(symbol.startColumn)
+            << qint32(symbol.endLine) << qint32(symbol.endColumn)
+            << qint32(symbol.position) << qint32(symbol.length)
+            << symbol.moduleScope << qint32(symbol.scopeLevel);
+    }
+
+    out << shard->commentMask() << shard->lineOffsets() << shard->scopeTree()
+        << shard->statementBoundaries();
+    return block;
+}
+
+bool SymbolIndexCache::save(const QString& cacheFilePath, const QHash<QString, FileStamp>& stamps,
+                            const SymbolSnapshot& snapshot)
+{
+    if (cacheFilePath.isEmpty()) {
+        return false;
+    }
+
+    // 先编码各文件记录，才能在目录中写出偏移
+    QStringList filePaths;
+    QList<QByteArray> blocks;
+    for (auto it = stamps.constBegin(); it != stamps.constEnd(); ++it) {
+        if (it.value().size < 0 || !snapshot.fileShard(it.key())) {
+            continue;
+        }
+        filePaths.append(it.key());
+        blocks.append(encodeFile(it.key(), snapshot));
+    }
+
+    QDir().mkpath(QFileInfo(cacheFilePath).absolutePath());
+
+    QSaveFile file(cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << Magic << FormatVersion << quint32(filePaths.size());
+
+    quint64 offset = 0;
+    for (int i = 0; i < filePaths.size(); ++i) {
+        const FileStamp stamp = stamps.value(filePaths.at(i));
+        out << filePaths.at(i)
+            << stamp.modifiedTime << stamp.size << stamp.contentHash << stamp.knownTypes
+            << offset << quint32(blocks.at(i).size());
+        offset += blocks.at(i).size();
+    }
+
+    for (const QByteArray& block : qAsConst(blocks)) {
+        out.writeRawData(block.constData(), block.size());
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -0,0 +1,83 @@
+#ifndef SYMBOLINDEXCACHE_H
+#define SYMBOLINDEXCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QFile>
+#include <memory>
+
+#include "syminfo.h"
+
+class SymbolSnapshot;
+
+// 🚀 工作区符号索引的磁盘缓存
+// 位于 <工作区>/.zeroslack/symbols.idx，带格式版本号；每个文件以 路径 + 修改时间 + 大小 + 内容哈希 为键，
+// 记录解析时的已知类型摘要、符号以及注释掩码/行偏移/作用域树。打开时整体内存映射，只读入目录，
+// 各文件的记录在工作线程中按需直接从映射内存解码，未变化的文件只需读取源文件求哈希，无需重新解析。
+class SymbolIndexCache
+{
+public:
+    struct FileStamp {
+        qint64 modifiedTime = 0;        // 毫秒时间戳
+        qint64 size = -1;
+        QString contentHash;
+        quint64 knownTypes = 0;         // 解析时已知struct/enum类型集合的摘要
+
+        bool matches(const FileStamp& other) const {
+            return modifiedTime == other.modifiedTime && size == other.size;
+        }
+    };
+
+    struct CachedFile {
+        QList<sym_list::SymbolInfo> symbols;
+        CommentMask commentMask;
+        LineOffsetTable lineOffsets;
+        ScopeTree scopeTree;
+        QVector<int> statementBoundaries;
+    };
+
+    SymbolIndexCache();
+    ~SymbolIndexCache();
+
+    static QString cachePathForWorkspace(const QString& workspacePath);
+    static FileStamp stampOf(const QString& filePath);     // 只取修改时间和大小
+
+    // 映射缓存文件并读入目录；文件不存在、版本不符或已损坏时返回false(当作空缓存)
+    bool open(const QString& cacheFilePath);
+    void close();
+    bool isOpen() const { return mappedData != nullptr; }
+    int entryCount() const { return entries.size(); }
+
+    // 以下查询在 open() 之后只读，可在多个工作线程并发调用。
+    // lookup 只比较修改时间/大小，调用方还须确认 cached.contentHash 与当前内容一致
+    bool lookup(const QString& filePath, const FileStamp& current, FileStamp& cached) const;
+    bool load(const QString& filePath, CachedFile& cachedFile) const;     // 记录损坏或前后不一致时返回false
+
+    // 把快照中的文件写成新的缓存文件(先写临时文件再替换)；写之前应先 close()。
+    // stamps 只应包含快照分片确实由该磁盘内容解析而来的文件
+    static bool save(const QString& cacheFilePath, const QHash<QString, FileStamp>& stamps,
+                     const SymbolSnapshot& snapshot);
+
+private:
+    static const quint32 Magic = 0x5A534958;        // "ZSIX"
+    static const quint32 FormatVersion = 4;         // 2: 增加语句边界 3: 模块区间表扩展为作用域树 4: 记录已知类型摘要
+
+    struct Entry {
+        FileStamp stamp;
+        quint64 offset = 0;                         // 相对数据区起点
+        quint32 length = 0;
+    };
+
+    QFile cacheFile;
+    const uchar* mappedData = nullptr;
+    qint64 mappedSize = 0;
+    qint64 dataStart = 0;
+    QHash<QString, Entry> entries;
+
+    static QByteArray encodeFile(const QString& filePath, const SymbolSnapshot& snapshot);
+    static bool isWellFormed(const CachedFile& cachedFile);
+};
+
+#endif // SYMBOLINDEXCACHE_H
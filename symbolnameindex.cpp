@@ -0,0 +1,67 @@
+#include "symbolnameindex.h"
+
+#include <algorithm>
+
+SymbolNameIndex::SymbolNameIndex(const QVector<std::shared_ptr<const SymbolNameTrie>>& tries)
+    : tries(tries)
+{
+    for (const std::shared_ptr<const SymbolNameTrie>& trie : tries) {
+        entries += trie->size();
+    }
+}
+
+QStringList SymbolNameIndex::namesWithPrefix(const QString& prefix, TypeMask types, int limit) const
+{
+    QVector<QStringList> parts;
+    for (const std::shared_ptr<const SymbolNameTrie>& trie : tries) {
+        const QStringList names = trie->namesWithPrefix(prefix, types, limit);
+        if (!names.isEmpty()) {
+            parts.append(names);
+        }
+    }
+    return merge(parts, limit);
+}
+
+QStringList SymbolNameIndex::namesWithPrefixInScope(const QString& prefix, TypeMask types, AtomTable::Atom scope,
+                                                    int limit) const
+{
+    QVector<QStringList> parts;
+    for (const std::shared_ptr<const SymbolNameTrie>& trie : tries) {
+        const QStringList names = trie->namesWithPrefixInScope(prefix, types, scope, limit);
+        if (!names.isEmpty()) {
+            parts.append(names);
+        }
+    }
+    return merge(parts, limit);
+}
+
+// 各部分已按 (折叠名, 原名) 排序且各自截断到 limit，全局前 limit 个必然在这些部分之中
+QStringList SymbolNameIndex::merge(const QVector<QStringList>& parts, int limit)
+{
+    if (parts.isEmpty()) {
+        return QStringList();
+    }
+    if (parts.size() == 1) {
+        return parts.first();
+    }
+
+    QVector<QPair<QString, QString>> items;     // (折叠名, 原名)
+    for (const QStringList& names : parts) {
+        for (const QString& name : names) {
+            items.append(qMakePair(name.toCaseFolded(), name));
+        }
+    }
+    std::sort(items.begin(), items.end());
+
+    QStringList result;
+    for (const QPair<QString, QString>& item : qAsConst(items)) {
+        if (!result.isEmpty() && result.last() == item.second) {
+            continue;
+        }
+        result.append(item.second);
+        if (result.size() == limit) {
+            break;
+        }
+    }
+    return result;
+}
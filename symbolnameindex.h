@@ -0,0 +1,42 @@
+#ifndef SYMBOLNAMEINDEX_H
+#define SYMBOLNAMEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "atomtable.h"
+#include "symbolnametrie.h"
+
+// 🚀 工作区符号名索引：各文件分片名称前缀树的集合
+// 每个分片发布时建立自己的前缀树，快照之间随分片共享；本索引只持有这些树的引用，建立开销与文件数成正比，
+// 重新分析一个文件后下一次查询不再为整个工作区重建名称表。
+// 前缀查询在各树上分别剪枝、取前 limit 个，再归并去重(同名符号可出现在多个文件中)。
+// 全量扫描按 (树, 条目) 遍历，同一名称可能被访问多次，调用方按名称原子去重。
+class SymbolNameIndex
+{
+public:
+    typedef SymbolNameTrie::TypeMask TypeMask;
+
+    SymbolNameIndex() {}
+    explicit SymbolNameIndex(const QVector<std::shared_ptr<const SymbolNameTrie>>& tries);
+
+    int trieCount() const { return tries.size(); }
+    const SymbolNameTrie& trieAt(int index) const { return *tries.at(index); }
+    int entryCount() const { return entries; }      // 各树条目数之和(含跨文件重名)
+
+    // 语义同 SymbolNameTrie：结果按不区分大小写的顺序、名称唯一；limit < 0 表示不限
+    QStringList namesWithPrefix(const QString& prefix, TypeMask types = SymbolNameTrie::AllTypes,
+                                int limit = -1) const;
+    QStringList namesWithPrefixInScope(const QString& prefix, TypeMask types, AtomTable::Atom scope,
+                                       int limit = -1) const;
+
+private:
+    QVector<std::shared_ptr<const SymbolNameTrie>> tries;
+    int entries = 0;
+
+    static QStringList merge(const QVector<QStringList>& parts, int limit);
+};
+
+#endif // SYMBOLNAMEINDEX_H
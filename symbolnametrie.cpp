@@ -0,0 +1,243 @@
+#include "symbolnametrie.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+
+SymbolNameTrie::TypeMask SymbolNameTrie::typeBits(std::initializer_list<sym_list::sym_type_e> symbolTypes)
+{
+    TypeMask mask = 0;
+    for (sym_list::sym_type_e symbolType : symbolTypes) {
+        mask |= typeBit(symbolType);
+    }
+    return mask;
+}
+
+void SymbolNameTrie::add(AtomTable::Atom name, sym_list::sym_type_e symbolType, AtomTable::Atom scope)
+{
+    if (name == AtomTable::EmptyAtom) {
+        return;
+    }
+
+    // 类型位掩码只有64位
+    Q_ASSERT(int(symbolType) < 64);
+
+    Pending& entry = pending[name];
+    entry.types |= typeBit(symbolType);
+    entry.keys.append((quint64(scope) << 32) | quint64(quint32(symbolType)));
+}
+
+void SymbolNameTrie::finish()
+{
+    const AtomTable* atoms = AtomTable::getInstance();
+
+    entries.clear();
+    entries.reserve(pending.size());
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        Entry entry;
+        entry.atom = it.key();
+        entry.name = atoms->string(it.key());
+        entry.folded = entry.name.toCaseFolded();
+        entry.signature = AbbreviationMatcher::signatureOf(entry.name);
+        entry.types = it.value().types;
+        entry.scopes = 0;
+        entry.keysBegin = 0;
+        entry.keysEnd = 0;
+        entries.append(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.folded != b.folded) {
+            return a.folded < b.folded;
+        }
+        return a.name < b.name;
+    });
+
+    // 组合键按条目顺序排成一张表，同一作用域的键相邻
+    scopeKeys.clear();
+    for (Entry& entry : entries) {
+        QVector<quint64> keys = pending.value(entry.atom).keys;
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        entry.keysBegin = scopeKeys.size();
+        for (quint64 key : qAsConst(keys)) {
+            entry.scopes |= scopeBit(AtomTable::Atom(key >> 32));
+            scopeKeys.append(key);
+        }
+        entry.keysEnd = scopeKeys.size();
+    }
+    pending.clear();
+
+    nodes.clear();
+    nodes.resize(1);
+    buildNode(0, 0, entries.size(), 0);
+}
+
+// 子节点在 nodes 中连续存放，按入边首字符有序；子树的掩码在子节点建好后汇总
+void SymbolNameTrie::buildNode(int index, int entryBegin, int entryEnd, int depth)
+{
+    Node node;
+    node.depth = depth;
+    node.entryBegin = entryBegin;
+    node.entryEnd = entryEnd;
+    node.terminalEnd = entryBegin;
+    node.types = 0;
+    node.scopes = 0;
+
+    while (node.terminalEnd < entryEnd && entries.at(node.terminalEnd).folded.size() == depth) {
+        node.types |= entries.at(node.terminalEnd).types;
+        node.scopes |= entries.at(node.terminalEnd).scopes;
+        ++node.terminalEnd;
+    }
+
+    QVarLengthArray<QPair<int, int>, 32> groups;
+    for (int first = node.terminalEnd; first < entryEnd;) {
+        const QChar c = entries.at(first).folded.at(depth);
+        int last = first + 1;
+        while (last < entryEnd && entries.at(last).folded.at(depth) == c) {
+            ++last;
+        }
+        groups.append(qMakePair(first, last));
+        first = last;
+    }
+
+    node.firstChild = nodes.size();
+    node.childCount = groups.size();
+    nodes[index] = node;
+    nodes.resize(nodes.size() + groups.size());
+
+    for (int g = 0; g < groups.size(); ++g) {
+        // 有序区间的公共前缀就是首尾两项的公共前缀，单分支链压缩成一条边
+        const QString& first = entries.at(groups[g].first).folded;
+        const QString& last = entries.at(groups[g].second - 1).folded;
+        const int limit = qMin(first.size(), last.size());
+        int childDepth = depth + 1;
+        while (childDepth < limit && first.at(childDepth) == last.at(childDepth)) {
+            ++childDepth;
+        }
+
+        const int child = node.firstChild + g;
+        buildNode(child, groups[g].first, groups[g].second, childDepth);
+        nodes[index].types |= nodes.at(child).types;
+        nodes[index].scopes |= nodes.at(child).scopes;
+    }
+}
+
+// 返回覆盖 foldedPrefix 全部条目的最浅节点，没有时返回 -1
+int SymbolNameTrie::findNode(const QString& foldedPrefix) const
+{
+    if (nodes.isEmpty()) {
+        return -1;
+    }
+
+    int index = 0;
+    forever {
+        const Node& node = nodes.at(index);
+        if (foldedPrefix.size() <= node.depth) {
+            return index;
+        }
+
+        const QChar c = foldedPrefix.at(node.depth);
+        int low = node.firstChild;
+        int high = node.firstChild + node.childCount;
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            if (entries.at(nodes.at(middle).entryBegin).folded.at(node.depth) < c) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low == node.firstChild + node.childCount ||
+            entries.at(nodes.at(low).entryBegin).folded.at(node.depth) != c) {
+            return -1;
+        }
+
+        const Node& child = nodes.at(low);
+        const QString& label = entries.at(child.entryBegin).folded;
+        const int stop = qMin(child.depth, foldedPrefix.size());
+        for (int i = node.depth + 1; i < stop; ++i) {
+            if (label.at(i) != foldedPrefix.at(i)) {
+                return -1;
+            }
+        }
+        index = low;
+    }
+}
+
+bool SymbolNameTrie::entryMatches(const Entry& entry, TypeMask types, AtomTable::Atom scope, bool scoped) const
+{
+    if (!(entry.types & types)) {
+        return false;
+    }
+    if (!scoped) {
+        return true;
+    }
+    if (!(entry.scopes & scopeBit(scope))) {
+        return false;
+    }
+
+    const quint64 scopeStart = quint64(scope) << 32;
+    auto it = std::lower_bound(scopeKeys.constBegin() + entry.keysBegin, scopeKeys.constBegin() + entry.keysEnd,
+                               scopeStart);
+    for (; it != scopeKeys.constBegin() + entry.keysEnd && (*it >> 32) == scope; ++it) {
+        if (typeBit(sym_list::sym_type_e(quint32(*it))) & types) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 先序遍历：本节点的完整名称排在子节点之前，与排序顺序一致；掩码不相交的子树整体跳过
+QStringList SymbolNameTrie::collect(const QString& prefix, TypeMask types, AtomTable::Atom scope, bool scoped,
+                                    int limit) const
+{
+    QStringList result;
+    if (limit == 0) {
+        return result;
+    }
+
+    const int start = findNode(prefix.toCaseFolded());
+    if (start < 0) {
+        return result;
+    }
+
+    const quint64 scopeMask = scoped ? scopeBit(scope) : ~quint64(0);
+    QVarLengthArray<int, 64> stack;
+    stack.append(start);
+
+    while (!stack.isEmpty()) {
+        const Node& node = nodes.at(stack.last());
+        stack.removeLast();
+
+        if (!(node.types & types) || !(node.scopes & scopeMask)) {
+            continue;
+        }
+
+        for (int i = node.entryBegin; i < node.terminalEnd; ++i) {
+            const Entry& entry = entries.at(i);
+            if (entryMatches(entry, types, scope, scoped)) {
+                result.append(entry.name);
+                if (result.size() == limit) {
+                    return result;
+                }
+            }
+        }
+
+        for (int child = node.firstChild + node.childCount - 1; child >= node.firstChild; --child) {
+            stack.append(child);
+        }
+    }
+    return result;
+}
+
+QStringList SymbolNameTrie::namesWithPrefix(const QString& prefix, TypeMask types, int limit) const
+{
+    return collect(prefix, types, AtomTable::EmptyAtom, false, limit);
+}
+
+QStringList SymbolNameTrie::namesWithPrefixInScope(const QString& prefix, TypeMask types, AtomTable::Atom scope,
+                                                   int limit) const
+{
+    return collect(prefix, types, scope, true, limit);
+}
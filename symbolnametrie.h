@@ -0,0 +1,88 @@
+#ifndef SYMBOLNAMETRIE_H
+#define SYMBOLNAMETRIE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <initializer_list>
+
+#include "syminfo.h"
+#include "atomtable.h"
+#include "abbreviationmatcher.h"
+
+// 🚀 符号名前缀树(压缩基数树)
+// 每个唯一名称原子一个条目，按折叠大小写后的名称排序(相同时按原文)，每个节点的子树对应条目表中的连续区间。
+// 节点记录子树内出现过的符号类型位掩码和作用域布隆掩码，不可能命中的子树整体跳过；
+// 前缀查询沿边下降后按序遍历子树，结果天然有序且已按类型/作用域过滤，开销与结果数成正比。
+// 每个条目同时带有缩写匹配签名，全量模糊打分时不必再逐个折叠名称。
+// 每个文件分片发布前构建一棵，之后只读；工作区范围的查询由 SymbolNameIndex 在各分片的树上归并。
+class SymbolNameTrie
+{
+public:
+    typedef quint64 TypeMask;
+
+    static TypeMask typeBit(sym_list::sym_type_e symbolType) { return TypeMask(1) << int(symbolType); }
+    static TypeMask typeBits(std::initializer_list<sym_list::sym_type_e> symbolTypes);
+    static const TypeMask AllTypes = ~TypeMask(0);
+
+    // 构建：逐个符号登记后调用 finish；finish 之前不能查询
+    void add(AtomTable::Atom name, sym_list::sym_type_e symbolType, AtomTable::Atom scope);
+    void finish();
+
+    bool isEmpty() const { return entries.isEmpty(); }
+    int size() const { return entries.size(); }
+    const QString& nameAt(int index) const { return entries.at(index).name; }
+    AtomTable::Atom atomAt(int index) const { return entries.at(index).atom; }
+    TypeMask typesAt(int index) const { return entries.at(index).types; }
+    const AbbreviationMatcher::Signature& signatureAt(int index) const { return entries.at(index).signature; }
+
+    // 以 prefix 开头(不区分大小写)且含有 types 中任一类型符号的名称，按不区分大小写的顺序；limit < 0 表示不限
+    QStringList namesWithPrefix(const QString& prefix, TypeMask types = AllTypes, int limit = -1) const;
+    // 同上，且该类型的符号属于模块 scope
+    QStringList namesWithPrefixInScope(const QString& prefix, TypeMask types, AtomTable::Atom scope,
+                                       int limit = -1) const;
+
+private:
+    struct Entry {
+        AtomTable::Atom atom;
+        QString name;
+        QString folded;
+        AbbreviationMatcher::Signature signature;
+        TypeMask types;
+        quint64 scopes;         // 作用域布隆掩码
+        int keysBegin;          // scopeKeys 中 [keysBegin, keysEnd) 为该名称的 (作用域, 类型) 组合
+        int keysEnd;
+    };
+
+    struct Node {
+        int depth;              // 到本节点为止的折叠前缀长度；入边标签取自子树第一个条目
+        int entryBegin;         // 子树覆盖的条目区间
+        int entryEnd;
+        int terminalEnd;        // [entryBegin, terminalEnd) 的折叠名恰好等于本节点前缀
+        int firstChild;
+        int childCount;
+        TypeMask types;
+        quint64 scopes;
+    };
+
+    struct Pending {
+        TypeMask types = 0;
+        QVector<quint64> keys;
+    };
+
+    QHash<AtomTable::Atom, Pending> pending;
+    QVector<Entry> entries;
+    QVector<quint64> scopeKeys;
+    QVector<Node> nodes;
+
+    static quint64 scopeBit(AtomTable::Atom scope) { return quint64(1) << (scope & 63); }
+
+    void buildNode(int index, int entryBegin, int entryEnd, int depth);
+    int findNode(const QString& foldedPrefix) const;
+    bool entryMatches(const Entry& entry, TypeMask types, AtomTable::Atom scope, bool scoped) const;
+    QStringList collect(const QString& prefix, TypeMask types, AtomTable::Atom scope, bool scoped,
+                        int limit) const;
+};
+
+#endif // SYMBOLNAMETRIE_H
@@ -1,5 +1,6 @@
 #include "symbolrelationshipengine.h"
 #include "syminfo.h"
+#include "symbolshard.h"
 //#include <QDebug>
 #include <algorithm>
 
@@ -134,6 +135,22 @@ void SymbolRelationshipEngine::clearAllRelationships()
 
 // 🚀 基本查询API实现
 
+bool SymbolRelationshipEngine::hasRelationships(int symbolId, RelationType type, bool outgoing) const
+{
+    auto it = relationshipGraph.constFind(symbolId);
+    if (it == relationshipGraph.constEnd()) {
+        return false;
+    }
+
+    const QList<RelationshipEdge>& edges = outgoing ? it.value().outgoingEdges : it.value().incomingEdges;
+    for (const RelationshipEdge& edge : edges) {
+        if (edge.type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QList<int> SymbolRelationshipEngine::getRelatedSymbols(int symbolId, RelationType type, bool outgoing) const
 {
     // 检查缓存
@@ -349,28 +366,39 @@ void SymbolRelationshipEngine::buildFileRelationships(const QString& fileName)
     // 先清除该文件的现有关系
     invalidateFileRelationships(fileName);
 
-    sym_list* symbolList = sym_list::getInstance();
-    QList<sym_list::SymbolInfo> fileSymbols = symbolList->findSymbolsByFileName(fileName);
-
-    // 🚀 构建模块包含关系
-    for (const sym_list::SymbolInfo& symbol : qAsConst(fileSymbols)) {
-        if (symbol.symbolType == sym_list::sym_module) {
-            int moduleId = symbol.symbolId;
-            symbolsByFile[fileName].insert(moduleId);
+    std::shared_ptr<const SymbolShard> shard = sym_list::getInstance()->getFileShard(fileName);
+    if (!shard) {
+        return;
+    }
 
-            // 查找该模块包含的所有符号
-            for (const sym_list::SymbolInfo& otherSymbol : qAsConst(fileSymbols)) {
-                if (otherSymbol.symbolId != moduleId &&
-                    isSymbolInModule(otherSymbol, symbol)) {
+    // 模块区间起点(module 关键字位置) -> 模块符号ID
+    const ScopeTree& scopes = shard->scopeTree();
+    QHash<int, int> moduleIdsByPosition;
+    shard->forEachOfType(sym_list::sym_module, [&](const SymbolRef& module) {
+        moduleIdsByPosition.insert(module.position(), module.symbolId());
+    });
+
+    // 🚀 构建模块包含关系：每个符号在作用域树中查找最内层模块，O(n (log n + 深度))，不再是 模块数 x 符号数
+    QSet<int>& fileSymbolIds = symbolsByFile[fileName];
+    shard->forEachSymbol([&](const SymbolRef& symbol) {
+        const int symbolId = symbol.symbolId();
+        const int position = symbol.position();
+        fileSymbolIds.insert(symbolId);
+
+        // 模块符号的锚点就是自身区间的起点，从外层区间开始找
+        int spanIndex = scopes.moduleSpanAtPosition(position);
+        if (spanIndex >= 0 && scopes.at(spanIndex).startPosition == position) {
+            spanIndex = scopes.enclosing(scopes.at(spanIndex).parent, ScopeTree::Module);
+        }
+        if (spanIndex < 0) {
+            return;
+        }
 
-                    addRelationship(moduleId, otherSymbol.symbolId, CONTAINS);
-                    symbolsByFile[fileName].insert(otherSymbol.symbolId);
-                }
-            }
-        } else {
-            symbolsByFile[fileName].insert(symbol.symbolId);
+        auto moduleIt = moduleIdsByPosition.constFind(scopes.at(spanIndex).startPosition);
+        if (moduleIt != moduleIdsByPosition.constEnd() && moduleIt.value() != symbolId) {
+            addRelationship(moduleIt.value(), symbolId, CONTAINS);
         }
-    }
+    });
 
     // 🚀 TODO: 分析变量引用关系，task调用关系等
     // 这需要更复杂的代码解析，可以后续实现
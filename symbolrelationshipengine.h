@@ -45,6 +45,7 @@ public:
     QList<int> getRelatedSymbols(int symbolId, RelationType type, bool outgoing = true) const;
     QList<int> getAllRelatedSymbols(int symbolId, bool outgoing = true) const;
     bool hasRelationship(int fromSymbolId, int toSymbolId, RelationType type) const;
+    bool hasRelationships(int symbolId, RelationType type, bool outgoing = true) const;   // 不构造结果列表
 
     // 🚀 高频查询API (针对SV特化)
     QList<int> getModuleChildren(int moduleId) const;              // 获取module包含的所有符号
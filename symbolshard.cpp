@@ -0,0 +1,374 @@
+#include "symbolshard.h"
+
+#include <algorithm>
+
+SymbolShard::SymbolShard(const QString& fileName)
+    : file(fileName)
+{
+}
+
+QList<sym_list::SymbolInfo> SymbolShard::symbols() const
+{
+    QList<sym_list::SymbolInfo> result;
+    result.reserve(store.liveCount());
+
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (store.isLiveSlot(slot)) {
+            result.append(store.at(store.handleAt(slot)));
+        }
+    }
+    return result;
+}
+
+QList<sym_list::SymbolInfo> SymbolShard::symbolsOfType(sym_list::sym_type_e symbolType) const
+{
+    auto it = typeIndex.constFind(symbolType);
+    if (it == typeIndex.constEnd()) {
+        return QList<sym_list::SymbolInfo>();
+    }
+    return materialize(it.value());
+}
+
+// 类型 + 作用域过滤：直接取组合索引中的句柄，开销与该作用域内该类型的符号数成正比
+QList<sym_list::SymbolInfo> SymbolShard::symbolsOfTypeInScope(sym_list::sym_type_e symbolType,
+                                                              AtomTable::Atom scope) const
+{
+    QList<sym_list::SymbolInfo> result;
+    forEachOfTypeInScope(symbolType, scope, [&result](const SymbolRef& symbol) {
+        result.append(symbol.toSymbolInfo());
+    });
+    return result;
+}
+
+QList<sym_list::SymbolInfo> SymbolShard::symbolsNamed(AtomTable::Atom symbolName) const
+{
+    auto it = nameIndex.constFind(symbolName);
+    if (it == nameIndex.constEnd()) {
+        return QList<sym_list::SymbolInfo>();
+    }
+    return materialize(it.value());
+}
+
+int SymbolShard::firstSymbolIdNamed(AtomTable::Atom symbolName) const
+{
+    auto it = nameIndex.constFind(symbolName);
+    if (it == nameIndex.constEnd()) {
+        return -1;
+    }
+
+    for (Handle handle : it.value()) {
+        if (store.isValid(handle)) {
+            return store.symbolId(handle);
+        }
+    }
+    return -1;
+}
+
+QVector<AtomTable::Atom> SymbolShard::nameAtomsOfType(sym_list::sym_type_e symbolType) const
+{
+    QVector<AtomTable::Atom> names;
+
+    auto it = typeIndex.constFind(symbolType);
+    if (it == typeIndex.constEnd()) {
+        return names;
+    }
+
+    names.reserve(it.value().size());
+    for (Handle handle : it.value()) {
+        if (store.isValid(handle)) {
+            names.append(store.nameAtom(handle));
+        }
+    }
+    return names;
+}
+
+void SymbolShard::collectSymbolScopes(QHash<AtomTable::Atom, AtomTable::Atom>& scopes) const
+{
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (!store.isLiveSlot(slot)) {
+            continue;
+        }
+
+        const Handle handle = store.handleAt(slot);
+        const AtomTable::Atom scope = store.scopeAtom(handle);
+        if (scope != AtomTable::EmptyAtom) {
+            scopes.insert(store.nameAtom(handle), scope);
+        }
+    }
+}
+
+int SymbolShard::countOfType(sym_list::sym_type_e symbolType) const
+{
+    auto it = typeIndex.constFind(symbolType);
+    if (it == typeIndex.constEnd()) {
+        return 0;
+    }
+
+    int count = 0;
+    for (Handle handle : it.value()) {
+        if (store.isValid(handle)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool SymbolShard::containsSymbol(int symbolId) const
+{
+    return idIndex.contains(symbolId);
+}
+
+sym_list::SymbolInfo SymbolShard::symbolById(int symbolId) const
+{
+    auto it = idIndex.constFind(symbolId);
+    if (it != idIndex.constEnd() && store.isValid(it.value())) {
+        return store.at(it.value());
+    }
+
+    sym_list::SymbolInfo emptySymbol;
+    emptySymbol.symbolId = -1;
+    return emptySymbol;
+}
+
+void SymbolShard::reserve(int count)
+{
+    store.reserve(store.slotCount() + count);
+    idIndex.reserve(idIndex.size() + count);
+    nameIndex.reserve(nameIndex.size() + count);
+}
+
+void SymbolShard::addSymbol(const sym_list::SymbolInfo& symbol)
+{
+    const Handle handle = store.insert(symbol);
+
+    typeIndex[symbol.symbolType].append(handle);
+    nameIndex[store.nameAtom(handle)].append(handle);
+    idIndex.insert(symbol.symbolId, handle);
+    indexScope(handle);
+}
+
+void SymbolShard::addSymbols(const QList<sym_list::SymbolInfo>& symbols)
+{
+    reserve(symbols.size());
+
+    // 同类型的符号通常成片出现，沿用上一个类型的句柄列表，省去逐个哈希查找
+    QList<Handle>* typeHandles = nullptr;
+    sym_list::sym_type_e lastType = sym_list::sym_reg;
+    for (const sym_list::SymbolInfo& symbol : symbols) {
+        const Handle handle = store.insert(symbol);
+
+        if (!typeHandles || symbol.symbolType != lastType) {
+            typeHandles = &typeIndex[symbol.symbolType];
+            lastType = symbol.symbolType;
+        }
+        typeHandles->append(handle);
+        nameIndex[store.nameAtom(handle)].append(handle);
+        idIndex.insert(symbol.symbolId, handle);
+        indexScope(handle);
+    }
+}
+
+// 删除锚点位置落在 [start, end) 内的符号：槽位留下墓碑，ID索引立即更新，类型/名称/作用域索引留待 compact()
+int SymbolShard::removeSymbolsInRange(int startPosition, int endPosition)
+{
+    int removed = 0;
+
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (!store.isLiveSlot(slot)) {
+            continue;
+        }
+
+        const Handle handle = store.handleAt(slot);
+        const int position = store.position(handle);
+        if (position < startPosition || position >= endPosition) {
+            continue;
+        }
+
+        auto it = idIndex.find(store.symbolId(handle));
+        if (it != idIndex.end() && it.value() == handle) {
+            idIndex.erase(it);
+        }
+
+        store.remove(handle);
+        staleEntries += 3;
+        ++removed;
+    }
+    return removed;
+}
+
+// 坐标平移不改变类型/名称/ID，也不改变平移区段内符号的相对顺序，索引中的句柄保持有效且有序
+void SymbolShard::shiftSymbols(int fromPosition, int positionDelta, int lineDelta, int columnLine, int columnDelta)
+{
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (!store.isLiveSlot(slot)) {
+            continue;
+        }
+
+        const Handle handle = store.handleAt(slot);
+        if (store.position(handle) < fromPosition) {
+            continue;
+        }
+
+        const int columnShift = (store.startLine(handle) == columnLine) ? columnDelta : 0;
+        store.shiftCoordinates(handle, positionDelta, lineDelta, columnShift);
+    }
+}
+
+bool SymbolShard::setSymbolScope(int symbolId, AtomTable::Atom scope, int scopeLevel)
+{
+    auto it = idIndex.constFind(symbolId);
+    if (it == idIndex.constEnd() || !store.isValid(it.value())) {
+        return false;
+    }
+
+    const Handle handle = it.value();
+    if (store.scopeAtom(handle) == scope) {
+        store.setScope(handle, scope, scopeLevel);
+        return true;
+    }
+
+    // 旧键下的句柄不立即删除(避免逐个线性查找)，读取时按作用域过滤，compact() 时清理
+    store.setScope(handle, scope, scopeLevel);
+    indexScope(handle);
+    ++staleEntries;
+    return true;
+}
+
+// 每个符号按锚点位置归入最内层作用域；module/task 等声明作用域的符号锚点就是区间起点，归入外层
+void SymbolShard::buildScopeMembers()
+{
+    scopeMembers.clear();
+    scopeMembers.resize(scopes.size() + 1);
+
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (!store.isLiveSlot(slot)) {
+            continue;
+        }
+
+        const Handle handle = store.handleAt(slot);
+        const int position = store.position(handle);
+        int spanIndex = scopes.spanAtPosition(position);
+        if (spanIndex >= 0 && scopes.at(spanIndex).startPosition == position) {
+            spanIndex = scopes.at(spanIndex).parent;
+        }
+        scopeMembers[spanIndex + 1].append(handle);
+    }
+}
+
+// 开销与本文件符号数成正比；compact() 不改变名称、类型和作用域，压缩后的分片沿用同一棵树
+void SymbolShard::buildNameTrie()
+{
+    auto trie = std::make_shared<SymbolNameTrie>();
+    forEachSymbol([&trie](const SymbolRef& symbol) {
+        trie->add(symbol.nameAtom(), symbol.type(), symbol.scopeAtom());
+    });
+    trie->finish();
+    names = std::move(trie);
+}
+
+bool SymbolShard::needsCompaction() const
+{
+    // 失效句柄超过存活符号数的四分之一时才值得清理
+    return staleEntries > qMax(64, store.liveCount() / 4);
+}
+
+void SymbolShard::compact()
+{
+    if (staleEntries == 0) {
+        return;
+    }
+
+    auto typeIt = typeIndex.begin();
+    while (typeIt != typeIndex.end()) {
+        purgeStaleHandles(typeIt.value(), store);
+        if (typeIt.value().isEmpty()) {
+            typeIt = typeIndex.erase(typeIt);
+        } else {
+            ++typeIt;
+        }
+    }
+    auto nameIt = nameIndex.begin();
+    while (nameIt != nameIndex.end()) {
+        purgeStaleHandles(nameIt.value(), store);
+        if (nameIt.value().isEmpty()) {
+            nameIt = nameIndex.erase(nameIt);
+        } else {
+            ++nameIt;
+        }
+    }
+    auto scopeIt = scopeTypeIndex.begin();
+    while (scopeIt != scopeTypeIndex.end()) {
+        const ScopeTypeKey key = scopeIt.key();
+        QList<Handle>& handles = scopeIt.value();
+        handles.erase(std::remove_if(handles.begin(), handles.end(),
+                                     [this, key](Handle handle) { return !isIndexedUnder(handle, key); }),
+                      handles.end());
+        if (handles.isEmpty()) {
+            scopeIt = scopeTypeIndex.erase(scopeIt);
+        } else {
+            ++scopeIt;
+        }
+    }
+
+    for (QList<Handle>& members : scopeMembers) {
+        purgeStaleHandles(members, store);
+    }
+
+    // 此时索引中已无指向空槽位的句柄，可以回收末尾槽位
+    store.shrinkToFit();
+    staleEntries = 0;
+}
+
+QList<sym_list::SymbolInfo> SymbolShard::materialize(const QList<Handle>& handles) const
+{
+    QList<sym_list::SymbolInfo> result;
+    result.reserve(handles.size());
+
+    for (Handle handle : handles) {
+        if (store.isValid(handle)) {
+            result.append(store.at(handle));
+        }
+    }
+    return result;
+}
+
+// 把句柄登记到它当前的 (作用域, 类型) 键下。解析顺序即源码顺序，绝大多数情况直接追加；
+// 位置不在末尾时(增量拼接、作用域改回原值)先清掉该列表的失效句柄(其位置列已不可信)，再二分插入。
+// 列表中有效句柄始终按位置有序，所以末尾句柄位置更小时，本句柄不可能已在列表中
+void SymbolShard::indexScope(Handle handle)
+{
+    const ScopeTypeKey key = scopeTypeKey(store.scopeAtom(handle), store.type(handle));
+    QList<Handle>& handles = scopeTypeIndex[key];
+
+    const int position = store.position(handle);
+    if (handles.isEmpty() || (isIndexedUnder(handles.last(), key) && store.position(handles.last()) < position)) {
+        handles.append(handle);
+        return;
+    }
+
+    handles.erase(std::remove_if(handles.begin(), handles.end(),
+                                 [this, key](Handle indexed) { return !isIndexedUnder(indexed, key); }),
+                  handles.end());
+    auto range = std::equal_range(handles.begin(), handles.end(), position,
+                                  PositionOrder{ &store });
+    if (std::find(range.first, range.second, handle) == range.second) {
+        handles.insert(range.second, handle);
+    }
+}
+
+bool SymbolShard::isIndexedUnder(Handle handle, ScopeTypeKey key) const
+{
+    return store.isValid(handle) && scopeTypeKey(store.scopeAtom(handle), store.type(handle)) == key;
+}
+
+void SymbolShard::purgeStaleHandles(QList<Handle>& handles, const SymbolStore& store)
+{
+    handles.erase(std::remove_if(handles.begin(), handles.end(),
+                                 [&store](Handle handle) { return !store.isValid(handle); }),
+                  handles.end());
+}
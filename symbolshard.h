@@ -0,0 +1,200 @@
+#ifndef SYMBOLSHARD_H
+#define SYMBOLSHARD_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <memory>
+
+#include "syminfo.h"
+#include "symbolstore.h"
+#include "atomtable.h"
+#include "commentmask.h"
+#include "lineoffsettable.h"
+#include "scopetree.h"
+#include "symbolnametrie.h"
+
+// 🚀 单个文件的符号分片
+// 持有该文件的列式符号存储、本地 类型/名称/ID 索引、注释掩码、行偏移表和作用域树。
+// 分片发布到 sym_list 之后只读；重新分析时构建新分片整体替换旧分片。
+// 需要在旧分片基础上修改时先复制再修改(Qt容器隐式共享，复制本身为O(1))。
+class SymbolShard
+{
+public:
+    typedef sym_list::SymbolHandle Handle;
+    typedef quint64 ScopeTypeKey;
+
+    // (作用域原子, 符号类型) 组合键，作用域占高32位
+    static ScopeTypeKey scopeTypeKey(AtomTable::Atom scope, sym_list::sym_type_e symbolType)
+    {
+        return (ScopeTypeKey(scope) << 32) | ScopeTypeKey(quint32(symbolType));
+    }
+
+    explicit SymbolShard(const QString& fileName);
+
+    const QString& fileName() const { return file; }
+    int symbolCount() const { return store.liveCount(); }
+    bool isEmpty() const { return store.isEmpty(); }
+
+    // 查询
+    QList<sym_list::SymbolInfo> symbols() const;
+    QList<sym_list::SymbolInfo> symbolsOfType(sym_list::sym_type_e symbolType) const;
+    QList<sym_list::SymbolInfo> symbolsOfTypeInScope(sym_list::sym_type_e symbolType, AtomTable::Atom scope) const;
+    QList<sym_list::SymbolInfo> symbolsNamed(AtomTable::Atom symbolName) const;
+    int firstSymbolIdNamed(AtomTable::Atom symbolName) const;     // 没有时返回 -1
+    QVector<AtomTable::Atom> nameAtomsOfType(sym_list::sym_type_e symbolType) const;
+    void collectSymbolScopes(QHash<AtomTable::Atom, AtomTable::Atom>& scopes) const;   // 名称 -> 非空作用域
+    QList<sym_list::sym_type_e> types() const { return typeIndex.keys(); }
+    int countOfType(sym_list::sym_type_e symbolType) const;
+    QList<ScopeTypeKey> scopeTypeKeys() const { return scopeTypeIndex.keys(); }   // 可能含已清空的键
+
+    // 🚀 NEW: 零拷贝遍历，visit(const SymbolRef&)；只物化回调真正需要的列
+    template <typename Visitor> void forEachSymbol(Visitor&& visit) const;
+    template <typename Visitor> void forEachOfType(sym_list::sym_type_e symbolType, Visitor&& visit) const;
+    template <typename Visitor> void forEachOfTypeInScope(sym_list::sym_type_e symbolType, AtomTable::Atom scope,
+                                                          Visitor&& visit) const;
+    template <typename Visitor> void forEachNamed(AtomTable::Atom symbolName, Visitor&& visit) const;
+    // 🚀 NEW: position 处可见的符号，沿作用域树由内到外访问各层直接声明的符号(需先 buildScopeMembers)
+    template <typename Visitor> void forEachVisibleAt(int position, Visitor&& visit) const;
+
+    bool containsSymbol(int symbolId) const;
+    sym_list::SymbolInfo symbolById(int symbolId) const;   // 不存在时 symbolId 为 -1
+    QList<int> symbolIds() const { return idIndex.keys(); }
+
+    const CommentMask& commentMask() const { return mask; }
+    const LineOffsetTable& lineOffsets() const { return offsets; }
+    const ScopeTree& scopeTree() const { return scopes; }
+    const QVector<int>& statementBoundaries() const { return boundaries; }
+    // 🚀 本文件符号名的前缀树(需先 buildNameTrie)；分片复制时共享，快照之间随分片复用
+    std::shared_ptr<const SymbolNameTrie> nameTrie() const { return names; }
+
+    // 构建/修改：只用于尚未发布的分片
+    void reserve(int count);                                         // 为再写入 count 个符号预留存储与索引
+    void addSymbol(const sym_list::SymbolInfo& symbol);
+    void addSymbols(const QList<sym_list::SymbolInfo>& symbols);    // 整批写入，容量只预留一次
+    int removeSymbolsInRange(int startPosition, int endPosition);        // 锚点位置在 [start, end) 内
+    void shiftSymbols(int fromPosition, int positionDelta, int lineDelta, int columnLine, int columnDelta);
+    bool setSymbolScope(int symbolId, AtomTable::Atom scope, int scopeLevel);
+    void setCommentMask(const CommentMask& commentMask) { mask = commentMask; }
+    void setLineOffsets(const LineOffsetTable& lineOffsets) { offsets = lineOffsets; }
+    void setScopeTree(const ScopeTree& scopeTree) { scopes = scopeTree; scopeMembers.clear(); }
+    void buildScopeMembers();                                        // 发布前按当前作用域树归类符号
+    void buildNameTrie();                                            // 发布前按当前名称/类型/作用域建立前缀树
+    void setStatementBoundaries(const QVector<int>& statementBoundaries) { boundaries = statementBoundaries; }
+
+    bool needsCompaction() const;
+    void compact();
+
+private:
+    QString file;
+    SymbolStore store;
+
+    QHash<sym_list::sym_type_e, QList<Handle>> typeIndex;
+    QHash<AtomTable::Atom, QList<Handle>> nameIndex;
+    QHash<int, Handle> idIndex;
+    // 🚀 NEW: (作用域, 类型) -> 句柄，每个列表按源码位置排序；作用域改变后旧键下的句柄留待 compact()
+    QHash<ScopeTypeKey, QList<Handle>> scopeTypeIndex;
+    int staleEntries = 0;               // 类型/名称/作用域索引中的失效句柄数
+
+    CommentMask mask;
+    LineOffsetTable offsets;
+    ScopeTree scopes;
+    QVector<QList<Handle>> scopeMembers;    // 作用域下标 + 1 -> 直接声明在该作用域中的符号，0 为文件顶层
+    QVector<int> boundaries;            // 声明解析器记录的语句边界，增量重解析的切分点
+    std::shared_ptr<const SymbolNameTrie> names;
+
+    QList<sym_list::SymbolInfo> materialize(const QList<Handle>& handles) const;
+    void indexScope(Handle handle);
+
+    // 句柄与源码位置的比较，用于在有序句柄列表中二分查找
+    struct PositionOrder {
+        const SymbolStore* store;
+        bool operator()(Handle handle, int position) const { return store->position(handle) < position; }
+        bool operator()(int position, Handle handle) const { return position < store->position(handle); }
+    };
+    bool isIndexedUnder(Handle handle, ScopeTypeKey key) const;
+    static void purgeStaleHandles(QList<Handle>& handles, const SymbolStore& store);
+};
+
+template <typename Visitor>
+void SymbolShard::forEachSymbol(Visitor&& visit) const
+{
+    const int slotCount = store.slotCount();
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (store.isLiveSlot(slot)) {
+            visit(SymbolRef(store, store.handleAt(slot)));
+        }
+    }
+}
+
+template <typename Visitor>
+void SymbolShard::forEachOfType(sym_list::sym_type_e symbolType, Visitor&& visit) const
+{
+    auto it = typeIndex.constFind(symbolType);
+    if (it == typeIndex.constEnd()) {
+        return;
+    }
+    for (Handle handle : it.value()) {
+        if (store.isValid(handle)) {
+            visit(SymbolRef(store, handle));
+        }
+    }
+}
+
+template <typename Visitor>
+void SymbolShard::forEachOfTypeInScope(sym_list::sym_type_e symbolType, AtomTable::Atom scope,
+                                       Visitor&& visit) const
+{
+    if (scope == AtomTable::NoAtom) {
+        return;
+    }
+    const ScopeTypeKey key = scopeTypeKey(scope, symbolType);
+    auto it = scopeTypeIndex.constFind(key);
+    if (it == scopeTypeIndex.constEnd()) {
+        return;
+    }
+    for (Handle handle : it.value()) {
+        if (isIndexedUnder(handle, key)) {
+            visit(SymbolRef(store, handle));
+        }
+    }
+}
+
+template <typename Visitor>
+void SymbolShard::forEachNamed(AtomTable::Atom symbolName, Visitor&& visit) const
+{
+    auto it = nameIndex.constFind(symbolName);
+    if (it == nameIndex.constEnd()) {
+        return;
+    }
+    for (Handle handle : it.value()) {
+        if (store.isValid(handle)) {
+            visit(SymbolRef(store, handle));
+        }
+    }
+}
+
+template <typename Visitor>
+void SymbolShard::forEachVisibleAt(int position, Visitor&& visit) const
+{
+    // 成员表与当前作用域树不对应(尚未建立)时不返回任何符号
+    if (scopeMembers.size() != scopes.size() + 1) {
+        return;
+    }
+
+    auto visitMembers = [&](int spanIndex) {
+        for (Handle handle : scopeMembers.at(spanIndex + 1)) {
+            if (store.isValid(handle)) {
+                visit(SymbolRef(store, handle));
+            }
+        }
+    };
+    for (int index = scopes.spanAtPosition(position); index >= 0; index = scopes.at(index).parent) {
+        visitMembers(index);
+    }
+    visitMembers(-1);
+}
+
+#endif // SYMBOLSHARD_H
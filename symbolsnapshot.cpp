@@ -0,0 +1,213 @@
+#include "symbolsnapshot.h"
+#include "symbolshard.h"
+
+SymbolSnapshot::SymbolSnapshot()
+{
+}
+
+SymbolSnapshot::SymbolSnapshot(const ShardMap& shards, const SymbolOwnerTable& symbolIdOwners,
+                               const ScopeTypeFileTable& scopeTypeFiles, int symbolCount, quint64 version)
+    : shards(shards)
+    , owners(symbolIdOwners)
+    , scopeTypeFiles(scopeTypeFiles)
+    , totalSymbolCount(symbolCount)
+    , snapshotVersion(version)
+{
+}
+
+std::shared_ptr<const SymbolShard> SymbolSnapshot::fileShard(const QString& fileName) const
+{
+    return shards.value(fileName);
+}
+
+QList<sym_list::SymbolInfo> SymbolSnapshot::symbolsInFile(const QString& fileName) const
+{
+    auto it = shards.constFind(fileName);
+    if (it == shards.constEnd()) {
+        return QList<sym_list::SymbolInfo>();
+    }
+    return it.value()->symbols();
+}
+
+QList<sym_list::SymbolInfo> SymbolSnapshot::symbolsNamed(const QString& symbolName) const
+{
+    QList<sym_list::SymbolInfo> result;
+
+    // 未登记的标识符直接返回，不必遍历分片
+    const AtomTable::Atom name = AtomTable::find(symbolName);
+    if (name == AtomTable::NoAtom) {
+        return result;
+    }
+
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        result.append(it.value()->symbolsNamed(name));
+    }
+    return result;
+}
+
+QList<sym_list::SymbolInfo> SymbolSnapshot::symbolsOfType(sym_list::sym_type_e symbolType) const
+{
+    QList<sym_list::SymbolInfo> result;
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        result.append(it.value()->symbolsOfType(symbolType));
+    }
+    return result;
+}
+
+// 类型 + 作用域过滤，经组合索引只访问含有该模块符号的分片
+QList<sym_list::SymbolInfo> SymbolSnapshot::symbolsOfTypeInScope(sym_list::sym_type_e symbolType,
+                                                                 const QString& scope) const
+{
+    QList<sym_list::SymbolInfo> result;
+    forEachOfTypeInScope(symbolType, scope, [&result](const SymbolRef& symbol) {
+        result.append(symbol.toSymbolInfo());
+    });
+    return result;
+}
+
+QList<sym_list::SymbolInfo> SymbolSnapshot::allSymbols() const
+{
+    // 物化全部符号，开销与符号总数成正比；按类型/名称/作用域过滤请用对应的查询接口
+    QList<sym_list::SymbolInfo> result;
+    result.reserve(totalSymbolCount);
+
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        result.append(it.value()->symbols());
+    }
+    return result;
+}
+
+int SymbolSnapshot::countOfType(sym_list::sym_type_e symbolType) const
+{
+    int count = 0;
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        count += it.value()->countOfType(symbolType);
+    }
+    return count;
+}
+
+sym_list::SymbolInfo SymbolSnapshot::symbolById(int symbolId) const
+{
+    // ID -> 文件 -> 分片本地ID索引；文件被替换/删除后旧ID自然失效
+    const AtomTable::Atom owner = owners.owner(symbolId);
+    if (owner != AtomTable::NoAtom) {
+        auto shardIt = shards.constFind(AtomTable::text(owner));
+        if (shardIt != shards.constEnd()) {
+            return shardIt.value()->symbolById(symbolId);
+        }
+    }
+
+    sym_list::SymbolInfo emptySymbol;
+    emptySymbol.symbolId = -1;
+    return emptySymbol;
+}
+
+bool SymbolSnapshot::containsSymbol(int symbolId) const
+{
+    const AtomTable::Atom owner = owners.owner(symbolId);
+    if (owner == AtomTable::NoAtom) {
+        return false;
+    }
+    auto shardIt = shards.constFind(AtomTable::text(owner));
+    return shardIt != shards.constEnd() && shardIt.value()->containsSymbol(symbolId);
+}
+
+int SymbolSnapshot::findSymbolIdByName(const QString& symbolName) const
+{
+    const AtomTable::Atom name = AtomTable::find(symbolName);
+    if (name == AtomTable::NoAtom) {
+        return -1;
+    }
+
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        const int symbolId = it.value()->firstSymbolIdNamed(name);
+        if (symbolId != -1) {
+            return symbolId;
+        }
+    }
+    return -1;
+}
+
+QHash<AtomTable::Atom, AtomTable::Atom> SymbolSnapshot::symbolScopeAtoms() const
+{
+    QHash<AtomTable::Atom, AtomTable::Atom> scopes;
+    scopes.reserve(totalSymbolCount);
+
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        it.value()->collectSymbolScopes(scopes);
+    }
+    return scopes;
+}
+
+QStringList SymbolSnapshot::symbolNamesOfType(sym_list::sym_type_e symbolType) const
+{
+    std::call_once(derivedOnce, [this]() { buildDerivedIndexes(); });
+    return namesByType.value(symbolType);
+}
+
+const QSet<AtomTable::Atom>& SymbolSnapshot::uniqueSymbolAtoms() const
+{
+    std::call_once(derivedOnce, [this]() { buildDerivedIndexes(); });
+    return uniqueNames;
+}
+
+const SymbolNameIndex& SymbolSnapshot::nameIndex() const
+{
+    std::call_once(indexOnce, [this]() {
+        QVector<std::shared_ptr<const SymbolNameTrie>> tries;
+        tries.reserve(shards.size());
+        for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+            std::shared_ptr<const SymbolNameTrie> trie = it.value()->nameTrie();
+            if (trie && !trie->isEmpty()) {
+                tries.append(std::move(trie));
+            }
+        }
+        names = SymbolNameIndex(tries);
+    });
+    return names;
+}
+
+void SymbolSnapshot::buildDerivedIndexes() const
+{
+    // 为每种符号类型汇总各分片的名称原子，按整数去重后才物化为字符串
+    QHash<sym_list::sym_type_e, QSet<AtomTable::Atom>> atomsByType;
+    for (auto shardIt = shards.constBegin(); shardIt != shards.constEnd(); ++shardIt) {
+        const SymbolShard& shard = *shardIt.value();
+        for (sym_list::sym_type_e symbolType : shard.types()) {
+            QSet<AtomTable::Atom>& typeNames = atomsByType[symbolType];
+            for (AtomTable::Atom name : shard.nameAtomsOfType(symbolType)) {
+                typeNames.insert(name);
+                uniqueNames.insert(name);
+            }
+        }
+    }
+
+    // 物化并排序
+    const AtomTable* atoms = AtomTable::getInstance();
+    for (auto it = atomsByType.constBegin(); it != atomsByType.constEnd(); ++it) {
+        QStringList& names = namesByType[it.key()];
+        names.reserve(it.value().size());
+        for (AtomTable::Atom name : it.value()) {
+            names.append(atoms->string(name));
+        }
+        names.sort();
+    }
+}
+
+CommentMask SymbolSnapshot::commentMask(const QString& fileName) const
+{
+    auto it = shards.constFind(fileName);
+    return it != shards.constEnd() ? it.value()->commentMask() : CommentMask();
+}
+
+LineOffsetTable SymbolSnapshot::lineOffsets(const QString& fileName) const
+{
+    auto it = shards.constFind(fileName);
+    return it != shards.constEnd() ? it.value()->lineOffsets() : LineOffsetTable();
+}
+
+ScopeTree SymbolSnapshot::scopeTree(const QString& fileName) const
+{
+    auto it = shards.constFind(fileName);
+    return it != shards.constEnd() ? it.value()->scopeTree() : ScopeTree();
+}
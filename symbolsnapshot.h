@@ -0,0 +1,171 @@
+#ifndef SYMBOLSNAPSHOT_H
+#define SYMBOLSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <memory>
+#include <mutex>
+
+#include "syminfo.h"
+#include "atomtable.h"
+#include "symbolshard.h"
+#include "symbolnameindex.h"
+#include "snapshottables.h"
+
+// 🚀 符号数据库的只读快照
+// sym_list 每次发布分片(分析完成、删除文件、压缩)时构建一个新快照并原子替换；
+// 读者通过 sym_list::getSnapshot() O(1) 取得引用计数的快照，之后的查询始终看到同一个一致版本，
+// 即使后台分析同时发布了新版本。快照本身及其引用的分片都不可修改，可在任意线程读取。
+class SymbolSnapshot
+{
+public:
+    typedef QHash<QString, std::shared_ptr<const SymbolShard>> ShardMap;
+
+    SymbolSnapshot();
+    SymbolSnapshot(const ShardMap& shards, const SymbolOwnerTable& symbolIdOwners,
+                   const ScopeTypeFileTable& scopeTypeFiles, int symbolCount, quint64 version);
+
+    quint64 version() const { return snapshotVersion; }
+    int symbolCount() const { return totalSymbolCount; }
+    QStringList fileNames() const { return shards.keys(); }
+    std::shared_ptr<const SymbolShard> fileShard(const QString& fileName) const;
+
+    // 查询
+    QList<sym_list::SymbolInfo> symbolsInFile(const QString& fileName) const;
+    QList<sym_list::SymbolInfo> symbolsNamed(const QString& symbolName) const;
+    QList<sym_list::SymbolInfo> symbolsOfType(sym_list::sym_type_e symbolType) const;
+    QList<sym_list::SymbolInfo> symbolsOfTypeInScope(sym_list::sym_type_e symbolType, const QString& scope) const;
+    QList<sym_list::SymbolInfo> allSymbols() const;
+    int countOfType(sym_list::sym_type_e symbolType) const;
+
+    // 🚀 NEW: 零拷贝查询。沿索引遍历各分片，对每个符号调用 visit(const SymbolRef&)，
+    // 不复制 SymbolInfo、不分配结果列表；SymbolRef 只在回调内有效
+    template <typename Visitor> void forEachSymbol(Visitor&& visit) const;
+    template <typename Visitor> void forEachInFile(const QString& fileName, Visitor&& visit) const;
+    template <typename Visitor> void forEachNamed(const QString& symbolName, Visitor&& visit) const;
+    template <typename Visitor> void forEachOfType(sym_list::sym_type_e symbolType, Visitor&& visit) const;
+    template <typename Visitor> void forEachOfTypeInScope(sym_list::sym_type_e symbolType, const QString& scope,
+                                                          Visitor&& visit) const;
+    template <typename Predicate, typename Visitor> void forEach(Predicate&& accept, Visitor&& visit) const;
+
+    // 第一个满足 accept 的同名符号，没有时 symbolId 为 -1
+    template <typename Predicate> sym_list::SymbolInfo firstNamed(const QString& symbolName, Predicate&& accept) const;
+
+    sym_list::SymbolInfo symbolById(int symbolId) const;   // 不存在时 symbolId 为 -1
+    bool containsSymbol(int symbolId) const;
+    int findSymbolIdByName(const QString& symbolName) const;
+    QHash<AtomTable::Atom, AtomTable::Atom> symbolScopeAtoms() const;
+
+    // 派生索引：首次访问时建立一次，之后只读
+    QStringList symbolNamesOfType(sym_list::sym_type_e symbolType) const;
+    const QSet<AtomTable::Atom>& uniqueSymbolAtoms() const;
+    // 🚀 NEW: 全部名称的前缀索引(带类型/作用域掩码)，补全前缀查询直接取有序结果。
+    // 由各分片已建好的前缀树组成，首次访问时只收集引用
+    const SymbolNameIndex& nameIndex() const;
+
+    // 每个文件的分析附带数据
+    CommentMask commentMask(const QString& fileName) const;
+    LineOffsetTable lineOffsets(const QString& fileName) const;
+    ScopeTree scopeTree(const QString& fileName) const;
+
+private:
+    ShardMap shards;
+    SymbolOwnerTable owners;                // symbolId -> 所属文件(可能含已失效的旧ID)
+    ScopeTypeFileTable scopeTypeFiles;      // (作用域, 类型) -> 含有该组合的文件
+    int totalSymbolCount = 0;
+    quint64 snapshotVersion = 0;
+
+    mutable std::once_flag derivedOnce;
+    mutable QHash<sym_list::sym_type_e, QStringList> namesByType;
+    mutable QSet<AtomTable::Atom> uniqueNames;
+    mutable std::once_flag indexOnce;
+    mutable SymbolNameIndex names;
+
+    void buildDerivedIndexes() const;
+};
+
+template <typename Visitor>
+void SymbolSnapshot::forEachSymbol(Visitor&& visit) const
+{
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        it.value()->forEachSymbol(visit);
+    }
+}
+
+template <typename Visitor>
+void SymbolSnapshot::forEachInFile(const QString& fileName, Visitor&& visit) const
+{
+    auto it = shards.constFind(fileName);
+    if (it != shards.constEnd()) {
+        it.value()->forEachSymbol(visit);
+    }
+}
+
+template <typename Visitor>
+void SymbolSnapshot::forEachNamed(const QString& symbolName, Visitor&& visit) const
+{
+    // 未登记的标识符直接返回，不必遍历分片
+    const AtomTable::Atom name = AtomTable::find(symbolName);
+    if (name == AtomTable::NoAtom) {
+        return;
+    }
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        it.value()->forEachNamed(name, visit);
+    }
+}
+
+template <typename Visitor>
+void SymbolSnapshot::forEachOfType(sym_list::sym_type_e symbolType, Visitor&& visit) const
+{
+    for (auto it = shards.constBegin(); it != shards.constEnd(); ++it) {
+        it.value()->forEachOfType(symbolType, visit);
+    }
+}
+
+template <typename Visitor>
+void SymbolSnapshot::forEachOfTypeInScope(sym_list::sym_type_e symbolType, const QString& scope,
+                                          Visitor&& visit) const
+{
+    // 作用域名从未登记过，不可能有符号属于它
+    const AtomTable::Atom scopeAtom = AtomTable::find(scope);
+    if (scopeAtom == AtomTable::NoAtom) {
+        return;
+    }
+    // 组合索引给出含有该 (作用域, 类型) 的文件，其余分片不必访问
+    const QStringList files = scopeTypeFiles.files(SymbolShard::scopeTypeKey(scopeAtom, symbolType));
+    for (const QString& fileName : files) {
+        auto it = shards.constFind(fileName);
+        if (it != shards.constEnd()) {
+            it.value()->forEachOfTypeInScope(symbolType, scopeAtom, visit);
+        }
+    }
+}
+
+template <typename Predicate, typename Visitor>
+void SymbolSnapshot::forEach(Predicate&& accept, Visitor&& visit) const
+{
+    forEachSymbol([&](const SymbolRef& symbol) {
+        if (accept(symbol)) {
+            visit(symbol);
+        }
+    });
+}
+
+template <typename Predicate>
+sym_list::SymbolInfo SymbolSnapshot::firstNamed(const QString& symbolName, Predicate&& accept) const
+{
+    sym_list::SymbolInfo found;
+    found.symbolId = -1;
+
+    forEachNamed(symbolName, [&](const SymbolRef& symbol) {
+        if (found.symbolId == -1 && accept(symbol)) {
+            found = symbol.toSymbolInfo();
+        }
+    });
+    return found;
+}
+
+#endif // SYMBOLSNAPSHOT_H
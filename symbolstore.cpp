@@ -0,0 +1,171 @@
+#include "symbolstore.h"
+
+#include <algorithm>
+
+const SymbolStore::Handle SymbolStore::InvalidHandle;
+
+void SymbolStore::reserve(int count)
+{
+    types.reserve(count);
+    nameAtoms.reserve(count);
+    fileAtoms.reserve(count);
+    scopeAtoms.reserve(count);
+    startLines.reserve(count);
+    lineSpans.reserve(count);
+    startColumns.reserve(count);
+    endColumns.reserve(count);
+    positions.reserve(count);
+    lengths.reserve(count);
+    symbolIds.reserve(count);
+    scopeLevels.reserve(count);
+    generations.reserve(count);
+    alive.reserve(count);
+}
+
+void SymbolStore::clear()
+{
+    resizeColumns(0);
+    generations.clear();
+    alive.clear();
+    freeSlots.clear();
+    live = 0;
+}
+
+void SymbolStore::resizeColumns(int count)
+{
+    types.resize(count);
+    nameAtoms.resize(count);
+    fileAtoms.resize(count);
+    scopeAtoms.resize(count);
+    startLines.resize(count);
+    lineSpans.resize(count);
+    startColumns.resize(count);
+    endColumns.resize(count);
+    positions.resize(count);
+    lengths.resize(count);
+    symbolIds.resize(count);
+    scopeLevels.resize(count);
+}
+
+SymbolStore::Handle SymbolStore::insert(const sym_list::SymbolInfo& symbol)
+{
+    int slot;
+    if (!freeSlots.isEmpty()) {
+        slot = freeSlots.last();
+        freeSlots.removeLast();
+    } else {
+        slot = types.size();
+        resizeColumns(slot + 1);
+        generations.append(0);
+        alive.append(0);
+    }
+
+    writeSlot(slot, symbol);
+    alive[slot] = 1;
+    ++live;
+
+    return makeHandle(slot, generations.at(slot));
+}
+
+void SymbolStore::writeSlot(int slot, const sym_list::SymbolInfo& symbol)
+{
+    types[slot] = static_cast<quint8>(symbol.symbolType);
+    AtomTable* atoms = AtomTable::getInstance();
+    nameAtoms[slot] = atoms->intern(symbol.symbolName);
+    fileAtoms[slot] = atoms->intern(symbol.fileName);
+    scopeAtoms[slot] = atoms->intern(symbol.moduleScope);
+
+    startLines[slot] = static_cast<quint32>(qMax(0, symbol.startLine));
+    lineSpans[slot] = saturate16(symbol.endLine - symbol.startLine);
+    startColumns[slot] = saturate16(symbol.startColumn);
+    endColumns[slot] = saturate16(symbol.endColumn);
+
+    positions[slot] = symbol.position;
+    lengths[slot] = symbol.length;
+    symbolIds[slot] = symbol.symbolId;
+    scopeLevels[slot] = static_cast<quint8>(qBound(0, symbol.scopeLevel, 255));
+}
+
+void SymbolStore::remove(Handle handle)
+{
+    if (!isValid(handle)) {
+        return;
+    }
+
+    const int slot = slotOf(handle);
+    alive[slot] = 0;
+    ++generations[slot];    // 旧句柄从此失效
+    freeSlots.append(slot);
+    --live;
+}
+
+bool SymbolStore::isValid(Handle handle) const
+{
+    const int slot = slotOf(handle);
+    return slot >= 0 && slot < alive.size() && alive.at(slot) != 0 &&
+           generations.at(slot) == generationOf(handle);
+}
+
+void SymbolStore::shrinkToFit()
+{
+    int count = types.size();
+    while (count > 0 && alive.at(count - 1) == 0) {
+        --count;
+    }
+    if (count == types.size()) {
+        return;
+    }
+
+    freeSlots.erase(std::remove_if(freeSlots.begin(), freeSlots.end(),
+                                   [count](int slot) { return slot >= count; }),
+                    freeSlots.end());
+    resizeColumns(count);
+    generations.resize(count);
+    alive.resize(count);
+}
+
+sym_list::SymbolInfo SymbolStore::at(Handle handle) const
+{
+    const int slot = slotOf(handle);
+
+    const AtomTable* atoms = AtomTable::getInstance();
+
+    sym_list::SymbolInfo symbol;
+    symbol.fileName = atoms->string(fileAtoms.at(slot));
+    symbol.symbolName = atoms->string(nameAtoms.at(slot));
+    symbol.symbolType = static_cast<sym_list::sym_type_e>(types.at(slot));
+    symbol.startLine = static_cast<int>(startLines.at(slot));
+    symbol.startColumn = startColumns.at(slot);
+    symbol.endLine = symbol.startLine + lineSpans.at(slot);
+    symbol.endColumn = endColumns.at(slot);
+    symbol.position = positions.at(slot);
+    symbol.length = lengths.at(slot);
+    symbol.symbolId = symbolIds.at(slot);
+    symbol.moduleScope = atoms->string(scopeAtoms.at(slot));
+    symbol.scopeLevel = scopeLevels.at(slot);
+    return symbol;
+}
+
+void SymbolStore::setScope(Handle handle, AtomTable::Atom scope, int scopeLevel)
+{
+    const int slot = slotOf(handle);
+    scopeAtoms[slot] = scope;
+    scopeLevels[slot] = static_cast<quint8>(qBound(0, scopeLevel, 255));
+}
+
+// 增量重解析时平移编辑点之后的符号；列偏移只用于与编辑终点同一行的符号
+void SymbolStore::shiftCoordinates(Handle handle, int positionDelta, int lineDelta, int columnDelta)
+{
+    const int slot = slotOf(handle);
+    positions[slot] += positionDelta;
+    startLines[slot] = static_cast<quint32>(qMax(0, static_cast<int>(startLines.at(slot)) + lineDelta));
+    if (columnDelta != 0) {
+        startColumns[slot] = saturate16(startColumns.at(slot) + columnDelta);
+        endColumns[slot] = saturate16(endColumns.at(slot) + columnDelta);
+    }
+}
+
+quint16 SymbolStore::saturate16(int value)
+{
+    return static_cast<quint16>(qBound(0, value, 0xFFFF));
+}
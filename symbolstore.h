@@ -0,0 +1,121 @@
+#ifndef SYMBOLSTORE_H
+#define SYMBOLSTORE_H
+
+#include <QString>
+#include <QVector>
+
+#include "syminfo.h"
+#include "atomtable.h"
+
+// 🚀 列式(struct-of-arrays)符号存储
+// 每个字段一列，名称/文件/作用域字符串只存全局原子表(AtomTable)中的32位原子；
+// 行列号压缩存放。SymbolInfo 只在需要时按行物化，类型/作用域过滤直接扫描整型列。
+//
+// 🚀 槽位表(slot map)：删除只留下墓碑并把槽位代数+1，槽位放入空闲链表等待复用，
+// 其他行不会移动。外部索引持有 Handle(槽位 + 代数)，代数不一致即为失效句柄。
+class SymbolStore
+{
+public:
+    typedef sym_list::SymbolHandle Handle;
+    static const Handle InvalidHandle = ~Handle(0);
+
+    int slotCount() const { return types.size(); }
+    int liveCount() const { return live; }
+    bool isEmpty() const { return live == 0; }
+    void reserve(int count);
+    void clear();
+
+    Handle insert(const sym_list::SymbolInfo& symbol);   // 优先复用空闲槽位
+    void remove(Handle handle);                          // O(1)，留下墓碑
+    bool isValid(Handle handle) const;
+
+    bool isLiveSlot(int slot) const { return alive.at(slot) != 0; }
+    Handle handleAt(int slot) const { return makeHandle(slot, generations.at(slot)); }
+
+    // 回收末尾的空槽位；调用方需保证不再持有这些槽位的旧句柄
+    void shrinkToFit();
+
+    sym_list::SymbolInfo at(Handle handle) const;
+
+    // 列访问(句柄须有效)
+    sym_list::sym_type_e type(Handle handle) const { return static_cast<sym_list::sym_type_e>(types.at(slotOf(handle))); }
+    AtomTable::Atom nameAtom(Handle handle) const { return nameAtoms.at(slotOf(handle)); }
+    AtomTable::Atom fileAtom(Handle handle) const { return fileAtoms.at(slotOf(handle)); }
+    AtomTable::Atom scopeAtom(Handle handle) const { return scopeAtoms.at(slotOf(handle)); }
+    int symbolId(Handle handle) const { return symbolIds.at(slotOf(handle)); }
+    int startLine(Handle handle) const { return static_cast<int>(startLines.at(slotOf(handle))); }
+    int position(Handle handle) const { return positions.at(slotOf(handle)); }
+
+    QString name(Handle handle) const { return AtomTable::text(nameAtom(handle)); }
+    QString fileName(Handle handle) const { return AtomTable::text(fileAtom(handle)); }
+    QString scope(Handle handle) const { return AtomTable::text(scopeAtom(handle)); }
+
+    void setScope(Handle handle, AtomTable::Atom scope, int scopeLevel);
+    void shiftCoordinates(Handle handle, int positionDelta, int lineDelta, int columnDelta);
+
+    static int slotOf(Handle handle) { return static_cast<int>(handle & 0xFFFFFFFFu); }
+    static quint32 generationOf(Handle handle) { return static_cast<quint32>(handle >> 32); }
+    static Handle makeHandle(int slot, quint32 generation) { return (Handle(generation) << 32) | quint32(slot); }
+
+private:
+    QVector<quint8> types;
+    QVector<AtomTable::Atom> nameAtoms;
+    QVector<AtomTable::Atom> fileAtoms;
+    QVector<AtomTable::Atom> scopeAtoms;
+
+    // 压缩坐标：起始行32位；结束行以相对起始行的跨度存16位；列号16位(超出时饱和)
+    QVector<quint32> startLines;
+    QVector<quint16> lineSpans;
+    QVector<quint16> startColumns;
+    QVector<quint16> endColumns;
+
+    QVector<qint32> positions;
+    QVector<qint32> lengths;
+    QVector<qint32> symbolIds;
+    QVector<quint8> scopeLevels;
+
+    // 槽位状态
+    QVector<quint32> generations;
+    QVector<quint8> alive;
+    QVector<int> freeSlots;
+    int live = 0;
+
+    void writeSlot(int slot, const sym_list::SymbolInfo& symbol);
+    void resizeColumns(int count);
+
+    static quint16 saturate16(int value);
+};
+
+// 🚀 符号行的只读视图：存储 + 句柄，按需读取单列，不物化 SymbolInfo。
+// 只在 forEach 回调内有效，不得保存；回调期间调用方持有的快照保证存储不被释放
+class SymbolRef
+{
+public:
+    SymbolRef(const SymbolStore& store, SymbolStore::Handle handle) : rowStore(&store), rowHandle(handle) {}
+
+    SymbolStore::Handle handle() const { return rowHandle; }
+    sym_list::sym_type_e type() const { return rowStore->type(rowHandle); }
+    AtomTable::Atom nameAtom() const { return rowStore->nameAtom(rowHandle); }
+    AtomTable::Atom fileAtom() const { return rowStore->fileAtom(rowHandle); }
+    AtomTable::Atom scopeAtom() const { return rowStore->scopeAtom(rowHandle); }
+    int symbolId() const { return rowStore->symbolId(rowHandle); }
+    int startLine() const { return rowStore->startLine(rowHandle); }
+    int position() const { return rowStore->position(rowHandle); }
+
+    bool nameStartsWith(const QString& prefix, Qt::CaseSensitivity cs = Qt::CaseSensitive) const
+    {
+        return prefix.isEmpty() || AtomTable::getInstance()->startsWith(nameAtom(), prefix, cs);
+    }
+
+    // 需要字符串或完整信息时才物化
+    QString name() const { return rowStore->name(rowHandle); }
+    QString moduleScope() const { return rowStore->scope(rowHandle); }
+    QString fileName() const { return rowStore->fileName(rowHandle); }
+    sym_list::SymbolInfo toSymbolInfo() const { return rowStore->at(rowHandle); }
+
+private:
+    const SymbolStore* rowStore;
+    SymbolStore::Handle rowHandle;
+};
+
+#endif // SYMBOLSTORE_H
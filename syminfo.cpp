@@ -2,9 +2,14 @@
 #include "mycodeeditor.h"
 #include "completionmanager.h"
 #include "symbolrelationshipengine.h"
+#include "svdeclarationparser.h"
+#include "symbolshard.h"
+#include "symbolsnapshot.h"
 
 #include <QDebug>
-#include <QRegExp>
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QRegularExpression>
 #include <algorithm>
 #include <memory>
 
@@ -12,13 +17,11 @@ std::unique_ptr<sym_list> sym_list::instance = nullptr;
 
 sym_list::sym_list()
 {
-    symbolDatabase.reserve(1000);
     commentRegions.reserve(100);
 
-    symbolTypeIndex.reserve(50);
-    symbolNameIndex.reserve(500);
-    fileNameIndex.reserve(50);
-    symbolIdToIndex.reserve(1000);
+    fileShards.reserve(50);
+
+    currentSnapshot = std::make_shared<const SymbolSnapshot>();
 }
 
 sym_list::~sym_list()
@@ -34,74 +37,55 @@ sym_list* sym_list::getInstance()
     return instance.get();
 }
 
-int sym_list::allocateSymbolId()
+// 一次预留连续的 count 个ID，返回第一个
+int sym_list::reserveSymbolIds(int count)
 {
-    return nextSymbolId++;
+    return nextSymbolId.fetch_add(count);
 }
 
 
-void sym_list::addSymbol(const SymbolInfo& symbol)
+// 🚀 一个文件的符号整批写入分片：ID一次预留，存储与索引按总数预留容量；
+// 不在这里失效补全缓存，由分片发布时(notifySymbolsChanged)统一处理
+void sym_list::addSymbols(SymbolShard& shard, const QList<SymbolInfo>& symbols)
 {
-    // 🚀 分配全局唯一ID
-    SymbolInfo newSymbol = symbol;
-    if (newSymbol.symbolId <= 0) {
-        newSymbol.symbolId = allocateSymbolId();
-    }
-
-    symbolDatabase.append(newSymbol);
-    int newIndex = symbolDatabase.size() - 1;
-
-    // 🚀 建立ID到索引的映射
-    symbolIdToIndex[newSymbol.symbolId] = newIndex;
-
-    addToIndexes(newIndex);
-    updateLineBasedSymbols(newSymbol);
-
-    // 🚀 NEW: 通知关系引擎有新符号添加
-    if (relationshipEngine) {
-        // 延迟构建关系，等所有符号添加完成后批量处理
-        // 这里只是标记需要重建关系
+    int missingIds = 0;
+    for (const SymbolInfo& symbol : symbols) {
+        if (symbol.symbolId <= 0) {
+            ++missingIds;
+        }
     }
+    int symbolId = missingIds > 0 ? reserveSymbolIds(missingIds) : 0;
 
-    // Mark cache as dirty
-    indexesDirty = true;
-
+    QList<SymbolInfo> prepared;
+    prepared.reserve(symbols.size());
+    for (SymbolInfo symbol : symbols) {
+        // 🚀 分配全局唯一ID
+        if (symbol.symbolId <= 0) {
+            symbol.symbolId = symbolId++;
+        }
 
+        // 🔧 FIX: 确保模块作用域正确设置(写入索引的就是这一行，不再额外追加一份副本)
+        if (symbol.moduleScope.isEmpty() &&
+            (symbol.symbolType == sym_reg ||
+             symbol.symbolType == sym_wire ||
+             symbol.symbolType == sym_logic)) {
+            symbol.moduleScope = getCurrentModuleScope(shard, symbol.startLine);
+        }
 
-    // 🔧 FIX: 确保模块作用域正确设置
-    SymbolInfo fixedSymbol = symbol;
-    if (fixedSymbol.moduleScope.isEmpty() &&
-        (fixedSymbol.symbolType == sym_reg ||
-         fixedSymbol.symbolType == sym_wire ||
-         fixedSymbol.symbolType == sym_logic)) {
-        fixedSymbol.moduleScope = getCurrentModuleScope(fixedSymbol.fileName, fixedSymbol.startLine);
+        prepared.append(symbol);
     }
 
-    symbolDatabase.append(fixedSymbol);
-
-    // 失效相关缓存
-    CompletionManager::getInstance()->invalidateCommandModeCache();
-
+    shard.addSymbols(prepared);
 }
 
 sym_list::SymbolInfo sym_list::getSymbolById(int symbolId) const
 {
-    if (symbolIdToIndex.contains(symbolId)) {
-        int index = symbolIdToIndex[symbolId];
-        if (index < symbolDatabase.size()) {
-            return symbolDatabase[index];
-        }
-    }
-
-    // 返回空符号
-    SymbolInfo emptySymbol;
-    emptySymbol.symbolId = -1;
-    return emptySymbol;
+    return getSnapshot()->symbolById(symbolId);
 }
 
 bool sym_list::hasSymbol(int symbolId) const
 {
-    return symbolIdToIndex.contains(symbolId);
+    return getSnapshot()->containsSymbol(symbolId);
 }
 
 SymbolRelationshipEngine* sym_list::getRelationshipEngine() const
@@ -114,7 +98,7 @@ void sym_list::setRelationshipEngine(SymbolRelationshipEngine* engine)
     relationshipEngine = engine;
 
     // 如果已有符号数据，重建所有关系
-    if (engine && !symbolDatabase.isEmpty()) {
+    if (engine && !fileShards.isEmpty()) {
         rebuildAllRelationships();
     }
 }
@@ -126,463 +110,466 @@ void sym_list::rebuildAllRelationships()
     // 清除现有关系
     relationshipEngine->clearAllRelationships();
 
-    // 按文件分组重建关系
-    QHash<QString, QList<SymbolInfo>> symbolsByFile;
-    for (const SymbolInfo& symbol : symbolDatabase) {
-        symbolsByFile[symbol.fileName].append(symbol);
-    }
-
-    for (auto it = symbolsByFile.begin(); it != symbolsByFile.end(); ++it) {
-        buildSymbolRelationships(it.key());
+    // 按文件分片重建关系：在分片副本上写入模块作用域后替换，整批只发布一次快照
+    const QStringList fileNames = fileShards.keys();
+    beginBatch();
+    for (const QString& fileName : fileNames) {
+        replaceShard(copyShard(fileName));
     }
+    commitBatch();
 }
 
-void sym_list::buildSymbolRelationships(const QString& fileName)
+// 🚀 发布分片：模块包含关系先写入新分片，再整体替换旧分片，最后通知关系引擎
+void sym_list::replaceShard(std::shared_ptr<SymbolShard> shard)
 {
-    if (!relationshipEngine) return;
+    const QString fileName = shard->fileName();
 
-    QList<SymbolInfo> fileSymbols = findSymbolsByFileName(fileName);
-    if (fileSymbols.isEmpty()) return;
+    installShard(std::move(shard));
 
-    // 🚀 1. 构建模块包含关系
-    analyzeModuleContainment(fileName);
+    // 批量修改期间快照与文件关系留到 commitBatch 统一处理
+    if (batchDepth > 0) {
+        batchSnapshotPending = true;
+        if (!batchChangedFiles.contains(fileName)) {
+            batchChangedFiles.append(fileName);
+        }
+        return;
+    }
 
-    // 🚀 2. 分析变量引用关系 (基础实现)
-    // 这里可以后续扩展为更复杂的代码解析
+    publishSnapshot();
 
-    // 🚀 3. 通知关系引擎重建该文件的关系
-    relationshipEngine->buildFileRelationships(fileName);
+    if (relationshipEngine) {
+        relationshipEngine->buildFileRelationships(fileName);
+    }
 }
 
-QList<sym_list::SymbolInfo> sym_list::findSymbolsByType(sym_type_e symbolType)
+void sym_list::beginBatch()
 {
-    QList<SymbolInfo> result;
+    ++batchDepth;
+}
 
-    if (symbolTypeIndex.contains(symbolType)) {
-        const QList<int>& indices = symbolTypeIndex[symbolType];
-        result.reserve(indices.size());
+void sym_list::commitBatch()
+{
+    if (batchDepth == 0 || --batchDepth > 0) {
+        return;
+    }
 
-        for (int index : indices) {
-            if (index < symbolDatabase.size()) {
-                result.append(symbolDatabase[index]);
+    flushBatchSnapshot();
+
+    const QStringList changedFiles = batchChangedFiles;
+    batchChangedFiles.clear();
+    if (relationshipEngine) {
+        for (const QString& fileName : changedFiles) {
+            if (fileShards.contains(fileName)) {
+                relationshipEngine->buildFileRelationships(fileName);
             }
         }
     }
 
-    return result;
+    // 整批只失效一次补全缓存，取批内请求的最强一级
+    const CacheRefresh refresh = pendingCacheRefresh;
+    pendingCacheRefresh = NoCacheRefresh;
+    notifySymbolsChanged(refresh);
 }
 
-void sym_list::analyzeModuleContainment(const QString& fileName)
+bool sym_list::isInBatch() const
 {
-    if (!relationshipEngine) return;
+    return batchDepth > 0;
+}
 
-    QList<SymbolInfo> fileSymbols = findSymbolsByFileName(fileName);
+// 批内已替换的分片立即发布。解析依赖已发布快照中的类型，批内后解析的文件应与逐个分析时看到相同的类型
+void sym_list::flushBatchSnapshot()
+{
+    if (batchSnapshotPending) {
+        batchSnapshotPending = false;
+        publishSnapshot();
+    }
+}
 
-    // 查找所有模块
-    QList<SymbolInfo> modules;
-    for (const SymbolInfo& symbol : fileSymbols) {
-        if (symbol.symbolType == sym_module) {
-            modules.append(symbol);
-        }
+void sym_list::notifySymbolsChanged(CacheRefresh refresh)
+{
+    if (batchDepth > 0) {
+        pendingCacheRefresh = qMax(pendingCacheRefresh, refresh);
+        return;
     }
 
-    // 为每个模块找到它包含的符号
-    for (const SymbolInfo& module : modules) {
-        for (const SymbolInfo& symbol : fileSymbols) {
-            if (symbol.symbolId != module.symbolId &&
-                isSymbolInModule(symbol, module)) {
-
-                // 🚀 建立包含关系
-                relationshipEngine->addRelationship(
-                    module.symbolId,
-                    symbol.symbolId,
-                    SymbolRelationshipEngine::CONTAINS
-                );
-
-                // 🚀 更新符号的模块作用域信息 - 这是关键！
-                int symbolIndex = symbolIdToIndex[symbol.symbolId];
-                if (symbolIndex < symbolDatabase.size()) {
-                    symbolDatabase[symbolIndex].moduleScope = module.symbolName;
-                    symbolDatabase[symbolIndex].scopeLevel = 1;
-                }
-            }
-        }
+    switch (refresh) {
+    case InvalidateCaches:
+        CompletionManager::getInstance()->invalidateSymbolCaches();
+        break;
+    case ForceRefreshCaches:
+        CompletionManager::getInstance()->forceRefreshSymbolCaches();
+        break;
+    case NoCacheRefresh:
+        break;
     }
 }
 
-QList<sym_list::SymbolInfo> sym_list::findSymbolsByName(const QString& symbolName)
+// 替换写入方分片表中的分片，不发布快照
+void sym_list::installShard(std::shared_ptr<SymbolShard> shard)
 {
-    QList<SymbolInfo> result;
+    const QString fileName = shard->fileName();
 
-    if (symbolNameIndex.contains(symbolName)) {
-        const QList<int>& indices = symbolNameIndex[symbolName];
-        result.reserve(indices.size());
+    if (relationshipEngine) {
+        relationshipEngine->invalidateFileRelationships(fileName);
+        analyzeModuleContainment(*shard);
+    }
+    shard->buildScopeMembers();
+    shard->buildNameTrie();
 
-        for (int index : indices) {
-            if (index < symbolDatabase.size()) {
-                result.append(symbolDatabase[index]);
-            }
-        }
+    auto oldIt = fileShards.constFind(fileName);
+    if (oldIt != fileShards.constEnd()) {
+        totalSymbolCount -= oldIt.value()->symbolCount();
+        staleOwnerEntries += oldIt.value()->symbolCount();
+        unindexShardScopes(*oldIt.value());
     }
 
-    return result;
+    const AtomTable::Atom fileAtom = AtomTable::atomOf(fileName);
+    for (int symbolId : shard->symbolIds()) {
+        symbolIdOwners.assign(symbolId, fileAtom);
+    }
+    totalSymbolCount += shard->symbolCount();
+    indexShardScopes(*shard);
+
+    fileShards.insert(fileName, std::shared_ptr<const SymbolShard>(std::move(shard)));
+    fileRevisions.insert(fileName, ++revisionCounter);
 }
 
-// NEW: 🚀 超高性能的符号名称列表获取
-QStringList sym_list::getSymbolNamesByType(sym_type_e symbolType)
+// 分片的组合键登记到文件列表；分片内作用域改变后残留的旧键只会多访问一个分片，不影响结果
+void sym_list::indexShardScopes(const SymbolShard& shard)
 {
-    updateCachedData();
-
-    if (cachedSymbolNamesByType.contains(symbolType)) {
-        return cachedSymbolNamesByType[symbolType];
+    for (SymbolShard::ScopeTypeKey key : shard.scopeTypeKeys()) {
+        scopeTypeFiles.add(key, shard.fileName());
     }
+}
 
-    return QStringList(); // 空列表
+void sym_list::unindexShardScopes(const SymbolShard& shard)
+{
+    for (SymbolShard::ScopeTypeKey key : shard.scopeTypeKeys()) {
+        scopeTypeFiles.remove(key, shard.fileName());
+    }
 }
 
-QSet<QString> sym_list::getUniqueSymbolNames()
+// 以当前分析文本的注释掩码/行偏移表建立一个空分片
+std::shared_ptr<SymbolShard> sym_list::createShard(const QString& fileName) const
 {
-    updateCachedData();
-    return cachedUniqueNames;
+    auto shard = std::make_shared<SymbolShard>(fileName);
+    shard->setCommentMask(currentCommentMask);
+    shard->setLineOffsets(currentLineOffsets);
+    shard->setScopeTree(currentScopeTree);
+    shard->setStatementBoundaries(currentStatementBoundaries);
+    return shard;
 }
 
-int sym_list::getSymbolCountByType(sym_type_e symbolType)
+// 已发布分片的可修改副本(隐式共享，修改时才真正复制)
+std::shared_ptr<SymbolShard> sym_list::copyShard(const QString& fileName) const
 {
-    if (symbolTypeIndex.contains(symbolType)) {
-        return symbolTypeIndex[symbolType].size();
+    auto it = fileShards.constFind(fileName);
+    if (it == fileShards.constEnd()) {
+        return std::make_shared<SymbolShard>(fileName);
     }
-    return 0;
+    return std::make_shared<SymbolShard>(*it.value());
 }
 
-QList<sym_list::SymbolInfo> sym_list::findSymbolsByFileName(const QString& fileName)
+std::shared_ptr<const SymbolShard> sym_list::getFileShard(const QString& fileName) const
 {
-    QList<SymbolInfo> result;
+    return getSnapshot()->fileShard(fileName);
+}
 
-    if (fileNameIndex.contains(fileName)) {
-        const QList<int>& indices = fileNameIndex[fileName];
-        result.reserve(indices.size());
+// 🚀 NEW: O(1) 取得当前发布的只读快照
+std::shared_ptr<const SymbolSnapshot> sym_list::getSnapshot() const
+{
+    return std::atomic_load(&currentSnapshot);
+}
 
-        for (int index : indices) {
-            if (index < symbolDatabase.size()) {
-                result.append(symbolDatabase[index]);
-            }
-        }
-    }
+// 🚀 NEW: 以当前分片表构建下一个快照并原子替换；旧快照在最后一个读者释放后销毁
+void sym_list::publishSnapshot()
+{
+    std::shared_ptr<const SymbolSnapshot> next =
+        std::make_shared<const SymbolSnapshot>(fileShards, symbolIdOwners, scopeTypeFiles,
+                                              totalSymbolCount, ++snapshotVersion);
+    std::atomic_store(&currentSnapshot, next);
+}
 
-    return result;
+QList<sym_list::SymbolInfo> sym_list::findSymbolsByType(sym_type_e symbolType)
+{
+    return getSnapshot()->symbolsOfType(symbolType);
 }
 
-QList<sym_list::SymbolInfo> sym_list::getAllSymbols()
+// 🚀 NEW: 类型 + 作用域过滤，经 (作用域, 类型) 组合索引只访问该模块的符号
+QList<sym_list::SymbolInfo> sym_list::findSymbolsByTypeInScope(sym_type_e symbolType, const QString& moduleScope)
 {
-    return symbolDatabase;
+    return getSnapshot()->symbolsOfTypeInScope(symbolType, moduleScope);
 }
 
-void sym_list::clearSymbolsForFile(const QString& fileName)
+int sym_list::getSymbolCount() const
 {
-    int beforeCount = symbolDatabase.size();
+    return getSnapshot()->symbolCount();
+}
 
-    // 🚀 NEW: 通知关系引擎失效该文件的关系
-    if (relationshipEngine) {
-        relationshipEngine->invalidateFileRelationships(fileName);
-    }
+void sym_list::analyzeModuleContainment(SymbolShard& shard)
+{
+    if (!relationshipEngine) return;
 
-    // NEW: 使用索引进行高效删除
-    if (fileNameIndex.contains(fileName)) {
-        QList<int> indicesToRemove = fileNameIndex[fileName];
+    // 模块区间起点(module 关键字位置) -> 模块符号
+    QHash<int, SymbolInfo> modulesByPosition;
+    for (const SymbolInfo& module : shard.symbolsOfType(sym_module)) {
+        modulesByPosition.insert(module.position, module);
+    }
+    if (modulesByPosition.isEmpty()) {
+        return;
+    }
 
-        // 🚀 NEW: 从symbolId映射中移除
-        for (int index : indicesToRemove) {
-            if (index < symbolDatabase.size()) {
-                int symbolId = symbolDatabase[index].symbolId;
-                symbolIdToIndex.remove(symbolId);
-            }
+    // 🚀 每个符号按行在作用域树中二分查找最内层模块，不再是 模块数 x 符号数 的两重循环
+    const ScopeTree& spans = shard.scopeTree();
+    QHash<int, AtomTable::Atom> moduleAtoms;
+    for (const SymbolInfo& symbol : shard.symbols()) {
+        const int spanIndex = spans.moduleSpanAtLine(symbol.startLine);
+        if (spanIndex < 0) {
+            continue;
         }
 
-        // 按降序排列索引，从后往前删除
-        std::sort(indicesToRemove.begin(), indicesToRemove.end(), std::greater<int>());
-
-        for (int index : indicesToRemove) {
-            if (index < symbolDatabase.size()) {
-                // 从所有索引中移除
-                removeFromIndexes(index);
-                symbolDatabase.removeAt(index);
-            }
+        auto moduleIt = modulesByPosition.constFind(spans.at(spanIndex).startPosition);
+        if (moduleIt == modulesByPosition.constEnd() || moduleIt.value().symbolId == symbol.symbolId) {
+            continue;
         }
-
-        // 重建索引（因为数组索引发生了变化）
-        rebuildAllIndexes();
+        const SymbolInfo& module = moduleIt.value();
+
+        // 🚀 建立包含关系
+        relationshipEngine->addRelationship(
+            module.symbolId,
+            symbol.symbolId,
+            SymbolRelationshipEngine::CONTAINS
+        );
+
+        // 🚀 更新符号的模块作用域信息 - 这是关键！
+        auto atomIt = moduleAtoms.find(module.symbolId);
+        if (atomIt == moduleAtoms.end()) {
+            atomIt = moduleAtoms.insert(module.symbolId, AtomTable::atomOf(module.symbolName));
+        }
+        shard.setSymbolScope(symbol.symbolId, atomIt.value(), 1);
     }
+}
 
-    int afterCount = symbolDatabase.size();
-
-    // UPDATED: Invalidate all symbol caches when symbols are removed
-    if (beforeCount != afterCount) {
-        CompletionManager::getInstance()->invalidateSymbolCaches();
-        invalidateCache();
-    }
+QList<sym_list::SymbolInfo> sym_list::findSymbolsByName(const QString& symbolName)
+{
+    return getSnapshot()->symbolsNamed(symbolName);
 }
 
-void sym_list::rebuildAllIndexes()
+int sym_list::findSymbolIdByName(const QString& symbolName) const
 {
-    // 清空所有索引
-    symbolTypeIndex.clear();
-    symbolNameIndex.clear();
-    fileNameIndex.clear();
-    symbolIdToIndex.clear(); // 🚀 NEW: 清空ID映射
+    return getSnapshot()->findSymbolIdByName(symbolName);
+}
 
-    // 重建索引
-    for (int i = 0; i < symbolDatabase.size(); ++i) {
-        addToIndexes(i);
-        // 🚀 NEW: 重建ID映射
-        symbolIdToIndex[symbolDatabase[i].symbolId] = i;
-    }
+QHash<AtomTable::Atom, AtomTable::Atom> sym_list::getSymbolScopeAtoms() const
+{
+    return getSnapshot()->symbolScopeAtoms();
+}
 
-    invalidateCache();
+// NEW: 🚀 超高性能的符号名称列表获取
+QStringList sym_list::getSymbolNamesByType(sym_type_e symbolType)
+{
+    return getSnapshot()->symbolNamesOfType(symbolType);
 }
 
-// NEW: 🚀 添加到索引
-void sym_list::addToIndexes(int symbolIndex)
+QSet<QString> sym_list::getUniqueSymbolNames()
 {
-    if (symbolIndex >= symbolDatabase.size()) return;
+    // 快照由调用方持有，派生索引在物化期间不会被释放
+    const std::shared_ptr<const SymbolSnapshot> snapshot = getSnapshot();
+    const QSet<AtomTable::Atom>& uniqueNames = snapshot->uniqueSymbolAtoms();
 
-    const SymbolInfo& symbol = symbolDatabase[symbolIndex];
+    const AtomTable* atoms = AtomTable::getInstance();
+    QSet<QString> names;
+    names.reserve(uniqueNames.size());
+    for (AtomTable::Atom name : uniqueNames) {
+        names.insert(atoms->string(name));
+    }
+    return names;
+}
 
-    // 类型索引
-    symbolTypeIndex[symbol.symbolType].append(symbolIndex);
+QSet<AtomTable::Atom> sym_list::getUniqueSymbolAtoms()
+{
+    return getSnapshot()->uniqueSymbolAtoms();
+}
 
-    // 名称索引
-    symbolNameIndex[symbol.symbolName].append(symbolIndex);
+int sym_list::getSymbolCountByType(sym_type_e symbolType)
+{
+    return getSnapshot()->countOfType(symbolType);
+}
 
-    // 文件名索引
-    fileNameIndex[symbol.fileName].append(symbolIndex);
+QList<sym_list::SymbolInfo> sym_list::findSymbolsByFileName(const QString& fileName)
+{
+    return getSnapshot()->symbolsInFile(fileName);
 }
 
-// NEW: 🚀 从索引中移除
-void sym_list::removeFromIndexes(int symbolIndex)
+QList<sym_list::SymbolInfo> sym_list::getAllSymbols()
 {
-    if (symbolIndex >= symbolDatabase.size()) return;
+    // 物化全部符号，开销与符号总数成正比；按类型/名称/作用域过滤请用对应的查询接口
+    return getSnapshot()->allSymbols();
+}
 
-    const SymbolInfo& symbol = symbolDatabase[symbolIndex];
+void sym_list::clearSymbolsForFile(const QString& fileName)
+{
+    // 🚀 NEW: 通知关系引擎失效该文件的关系
+    if (relationshipEngine) {
+        relationshipEngine->invalidateFileRelationships(fileName);
+    }
 
-    // 从类型索引中移除
-    if (symbolTypeIndex.contains(symbol.symbolType)) {
-        symbolTypeIndex[symbol.symbolType].removeAll(symbolIndex);
-        if (symbolTypeIndex[symbol.symbolType].isEmpty()) {
-            symbolTypeIndex.remove(symbol.symbolType);
-        }
+    // 🚀 整个分片一次移除，O(1)；旧符号ID在压缩时清理
+    auto it = fileShards.find(fileName);
+    if (it == fileShards.end()) {
+        return;
     }
 
-    // 从名称索引中移除
-    if (symbolNameIndex.contains(symbol.symbolName)) {
-        symbolNameIndex[symbol.symbolName].removeAll(symbolIndex);
-        if (symbolNameIndex[symbol.symbolName].isEmpty()) {
-            symbolNameIndex.remove(symbol.symbolName);
-        }
+    const int removedCount = it.value()->symbolCount();
+    totalSymbolCount -= removedCount;
+    staleOwnerEntries += removedCount;
+    unindexShardScopes(*it.value());
+    fileShards.erase(it);
+    fileRevisions.remove(fileName);
+    fileKnownTypeFingerprints.remove(fileName);
+    dropLineFingerprints(fileName);
+
+    if (batchDepth > 0) {
+        batchSnapshotPending = true;
+    } else {
+        publishSnapshot();
     }
 
-    // 从文件名索引中移除
-    if (fileNameIndex.contains(symbol.fileName)) {
-        fileNameIndex[symbol.fileName].removeAll(symbolIndex);
-        if (fileNameIndex[symbol.fileName].isEmpty()) {
-            fileNameIndex.remove(symbol.fileName);
-        }
+    // UPDATED: Invalidate all symbol caches when symbols are removed
+    if (removedCount > 0) {
+        notifySymbolsChanged(InvalidateCaches);
     }
 }
 
-// NEW: 🚀 使缓存失效
-void sym_list::invalidateCache()
+bool sym_list::needsCompaction() const
 {
-    cachedSymbolNamesByType.clear();
-    cachedUniqueNames.clear();
-    indexesDirty = true;
+    // 失效的ID映射超过存活符号数的四分之一，或某个分片积累了较多墓碑时才值得清理
+    if (staleOwnerEntries > qMax(256, totalSymbolCount / 4)) {
+        return true;
+    }
+    for (auto it = fileShards.constBegin(); it != fileShards.constEnd(); ++it) {
+        if (it.value()->needsCompaction()) {
+            return true;
+        }
+    }
+    return false;
 }
 
-// NEW: 🚀 更新缓存数据
-void sym_list::updateCachedData() const
+void sym_list::compactStorage()
 {
-    if (!indexesDirty) return;
-
-    // 清空缓存
-    cachedSymbolNamesByType.clear();
-    cachedUniqueNames.clear();
-
-    // 为每种符号类型构建名称列表
-    for (auto it = symbolTypeIndex.begin(); it != symbolTypeIndex.end(); ++it) {
-        sym_type_e symbolType = it.key();
-        const QList<int>& indices = it.value();
-
-        QStringList names;
-        names.reserve(indices.size());
+    bool changed = false;
 
-        for (int index : indices) {
-            if (index < symbolDatabase.size()) {
-                const QString& name = symbolDatabase[index].symbolName;
-                names.append(name);
-                cachedUniqueNames.insert(name);
+    // 按存活分片重建ID表，只含失效ID的页随之释放
+    if (staleOwnerEntries > 0) {
+        symbolIdOwners.clear();
+        for (auto it = fileShards.constBegin(); it != fileShards.constEnd(); ++it) {
+            const AtomTable::Atom fileAtom = AtomTable::atomOf(it.key());
+            for (int symbolId : it.value()->symbolIds()) {
+                symbolIdOwners.assign(symbolId, fileAtom);
             }
         }
-
-        // 排序并去重
-        names.removeDuplicates();
-        names.sort();
-
-        cachedSymbolNamesByType[symbolType] = names;
+        staleOwnerEntries = 0;
+        changed = true;
+    }
+
+    // 墓碑较多的分片压缩后替换，符号ID与关系不变；仍持有旧快照的读者不受影响
+    for (auto it = fileShards.begin(); it != fileShards.end(); ++it) {
+        if (it.value()->needsCompaction()) {
+            auto shard = std::make_shared<SymbolShard>(*it.value());
+            shard->compact();
+            unindexShardScopes(*it.value());
+            indexShardScopes(*shard);
+            it.value() = std::move(shard);
+            changed = true;
+        }
     }
 
-    indexesDirty = false;
+    if (changed) {
+        publishSnapshot();
+    }
 }
 
 bool sym_list::isPositionInComment(int position)
 {
-    // Binary search since commentRegions is sorted
-    auto it = std::lower_bound(commentRegions.begin(), commentRegions.end(), position,
-        [](const CommentRegion& region, int pos) {
-            return region.endPos <= pos;
-        });
-
-    return it != commentRegions.end() && position >= it->startPos;
+    // 🚀 位掩码查询，O(1)
+    return currentCommentMask.isComment(position);
 }
 
-void sym_list::getModuleName(const QString &text)
+bool sym_list::isPositionInComment(const QString &fileName, int position) const
 {
-    QRegExp moduleName("\\bmodule\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> matches = findMatchesOutsideComments(text, moduleName);
-
-    for (const RegexMatch &match : qAsConst(matches)) {
-        // Reuse the regex to get capture group
-        if (moduleName.indexIn(text, match.position) != -1) {
-            const QString moduleNameCaptured = moduleName.cap(1);
-
-            // Create symbol info and add to database
-            SymbolInfo moduleSymbol;
-            moduleSymbol.fileName = currentFileName;
-            moduleSymbol.symbolName = moduleNameCaptured;
-            moduleSymbol.symbolType = sym_module;
-            moduleSymbol.position = match.position;
-            moduleSymbol.length = match.length;
-
-            int captureGroupPos = moduleName.pos(1);
-            calculateLineColumn(text, captureGroupPos, moduleSymbol.startLine, moduleSymbol.startColumn);
-
-            moduleSymbol.endLine = moduleSymbol.startLine;
-            moduleSymbol.endColumn = moduleSymbol.startColumn + moduleNameCaptured.length();
-
-            addSymbol(moduleSymbol);
-        }
+    if (fileName == currentFileName) {
+        return currentCommentMask.isComment(position);
     }
+    return getSnapshot()->commentMask(fileName).isComment(position);
 }
 
-void sym_list::buildCommentRegions(const QString &text)
+bool sym_list::isPositionInString(int position) const
 {
-    commentRegions.clear();
-    findSingleLineComments(text);
-    findMultiLineComments(text);
-
-    // Sort once at the end for binary search optimization
-    std::sort(commentRegions.begin(), commentRegions.end(),
-              [](const CommentRegion &a, const CommentRegion &b) {
-                  return a.startPos < b.startPos;
-              });
-}
-
-void sym_list::findSingleLineComments(const QString &text)
-{
-    const QStringList lines = text.split('\n');
-    int currentPos = 0;
-
-    for (int lineNum = 0; lineNum < lines.size(); lineNum++) {
-        const QString &line = lines[lineNum];
-
-        int commentPos = line.indexOf("//");
-        if (commentPos != -1 && !isPositionInMultiLineComment(currentPos + commentPos)) {
-            CommentRegion region;
-            region.startPos = currentPos + commentPos;
-            region.endPos = currentPos + line.length();
-            region.startLine = lineNum;
-            region.startColumn = commentPos;
-            region.endLine = lineNum;
-            region.endColumn = line.length();
-            commentRegions.append(region);
-        }
-
-        currentPos += line.length() + 1;
-    }
+    return currentCommentMask.isString(position);
 }
 
-void sym_list::findMultiLineComments(const QString &text)
+CommentMask sym_list::getCommentMask(const QString &fileName) const
 {
-    static const QRegExp multiLineStart("\\/\\*");
-    static const QRegExp multiLineEnd("\\*\\/");
+    return getSnapshot()->commentMask(fileName);
+}
 
-    int pos = 0;
-    while ((pos = multiLineStart.indexIn(text, pos)) != -1) {
-        int endPos = multiLineEnd.indexIn(text, pos + 2);
+void sym_list::buildCommentRegions(const QString &text)
+{
+    // 🚀 单遍状态机同时标记 // 、/* */ 与字符串，取代按行split + 两次QRegExp扫描
+    currentCommentMask.build(text);
 
+    // 兼容旧接口：按位置顺序导出注释区域(不含字符串)
+    commentRegions.clear();
+    for (const CommentMask::Region &maskRegion : currentCommentMask.regions()) {
+        if (maskRegion.kind == CommentMask::StringLiteral) {
+            continue;
+        }
         CommentRegion region;
-        region.startPos = pos;
-        region.endPos = (endPos != -1) ? endPos + 2 : text.length();
-
-        calculateLineColumn(text, region.startPos, region.startLine, region.startColumn);
-        calculateLineColumn(text, region.endPos, region.endLine, region.endColumn);
-
+        region.startPos = maskRegion.startPos;
+        region.endPos = maskRegion.endPos;
+        calculateLineColumn(region.startPos, region.startLine, region.startColumn);
+        calculateLineColumn(region.endPos, region.endLine, region.endColumn);
         commentRegions.append(region);
-        pos = region.endPos;
     }
 }
 
-void sym_list::calculateLineColumn(const QString &text, int position, int &line, int &column)
+void sym_list::calculateLineColumn(int position, int &line, int &column)
 {
-    line = 0;
-    column = 0;
-    const int maxPos = qMin(position, text.length());
+    // 🚀 行首偏移表二分查找，O(log n)
+    currentLineOffsets.lineColumn(position, line, column);
+}
 
-    for (int i = 0; i < maxPos; i++) {
-        if (text[i] == '\n') {
-            line++;
-            column = 0;
-        } else {
-            column++;
-        }
-    }
+void sym_list::buildLineOffsets(const QString &text)
+{
+    currentLineOffsets.build(text);
 }
-/*
-bool sym_list::isMatchInComment(int matchStart, int matchLength)
+
+LineOffsetTable sym_list::getLineOffsets(const QString &fileName) const
 {
-    const int matchEnd = matchStart + matchLength;
+    return getSnapshot()->lineOffsets(fileName);
+}
 
-    // Use binary search since commentRegions is sorted
-    auto it = std::lower_bound(commentRegions.begin(), commentRegions.end(), matchStart,
-        [](const CommentRegion& region, int pos) {
-            return region.endPos <= pos;
-        });
+ScopeTree sym_list::getScopeTree(const QString &fileName) const
+{
+    return getSnapshot()->scopeTree(fileName);
+}
 
-    // Check if any overlapping regions exist
-    for (auto iter = it; iter != commentRegions.end() && iter->startPos < matchEnd; ++iter) {
-        if (!(matchEnd <= iter->startPos || matchStart >= iter->endPos)) {
-            return true;
-        }
+QList<sym_list::SymbolInfo> sym_list::findVisibleSymbols(const QString &fileName, int position) const
+{
+    QList<SymbolInfo> result;
+    std::shared_ptr<const SymbolShard> shard = getSnapshot()->fileShard(fileName);
+    if (shard) {
+        shard->forEachVisibleAt(position, [&result](const SymbolRef& symbol) {
+            result.append(symbol.toSymbolInfo());
+        });
     }
-    return false;
-}*/
+    return result;
+}
 
 bool sym_list::isMatchInComment(int matchStart, int matchLength)
 {
-    const int matchEnd = matchStart + matchLength;
-
-    // Use binary search since commentRegions is sorted
-    auto it = std::lower_bound(commentRegions.begin(), commentRegions.end(), matchStart,
-        [](const CommentRegion& region, int pos) {
-            return region.endPos <= pos;
-        });
-
-    // Check if any overlapping regions exist
-    for (auto iter = it; iter != commentRegions.end() && iter->startPos < matchEnd; ++iter) {
-        // 简单清晰的重叠检测：匹配项与注释区域有重叠
-        if (matchStart < iter->endPos && matchEnd > iter->startPos) {
-            return true;
-        }
-    }
-    return false;
+    // 字符串中的文本同样不参与符号提取
+    return currentCommentMask.overlapsCommentOrString(matchStart, matchLength);
 }
 
 bool sym_list::isPositionInMultiLineComment(int pos)
@@ -595,29 +582,35 @@ QList<sym_list::CommentRegion> sym_list::getCommentRegions() const
     return commentRegions;
 }
 
-QList<sym_list::RegexMatch> sym_list::findMatchesOutsideComments(const QString &text, const QRegExp &pattern)
+QList<sym_list::RegexMatch> sym_list::findMatchesOutsideComments(const QString &text, const QRegularExpression &pattern)
 {
     QList<RegexMatch> validMatches;
     validMatches.reserve(50); // Reasonable estimate
 
-    QRegExp regExp(pattern);
-    int pos = 0;
+    // 传入的文本不是当前分析的文本时，临时建立行偏移表
+    LineOffsetTable localOffsets;
+    const LineOffsetTable *offsets = &currentLineOffsets;
+    if (currentLineOffsets.length() != text.length()) {
+        localOffsets.build(text);
+        offsets = &localOffsets;
+    }
 
-    while ((pos = regExp.indexIn(text, pos)) != -1) {
-        const int matchStart = pos;
-        const int matchLength = regExp.matchedLength();
+    // 🚀 模式由调用方预编译，这里不再复制
+    QRegularExpressionMatchIterator it = pattern.globalMatch(text);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch regexMatch = it.next();
+        const int matchStart = regexMatch.capturedStart();
+        const int matchLength = regexMatch.capturedLength();
 
         if (!isMatchInComment(matchStart, matchLength)) {
             RegexMatch match;
             match.position = matchStart;
             match.length = matchLength;
-            match.captured = regExp.cap(0);
+            match.captured = regexMatch.captured(0);
 
-            calculateLineColumn(text, matchStart, match.lineNumber, match.columnNumber);
+            offsets->lineColumn(matchStart, match.lineNumber, match.columnNumber);
             validMatches.append(match);
         }
-
-        pos += matchLength;
     }
 
     return validMatches;
@@ -629,168 +622,54 @@ void sym_list::setCodeEditor(MyCodeEditor* codeEditor)
         return;
     }
 
-    currentFileName = codeEditor->getFileName();
-
-    // Clear existing symbols for this file before analysis
-    clearSymbolsForFile(currentFileName);
-
-    const QString text = codeEditor->document()->toPlainText();
-
-    // Build comment regions first
-    buildCommentRegions(text);
-
-    // Extract all symbol types
-    getModuleName(text);
-    getVariableDeclarations(text);
-    getTasksAndFunctions(text);
-
-    // 🚀 NEW: 构建符号关系
-    buildSymbolRelationships(currentFileName);
-
-    // UPDATED: Force refresh all caches to ensure normal mode completion works
-    CompletionManager::getInstance()->forceRefreshSymbolCaches();
-}
-
-void sym_list::getVariableDeclarations(const QString &text)
-{
-    int symbolsFound = 0;
-
-    // Extract reg declarations
-    QRegExp regPattern("\\breg\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> regMatches = findMatchesOutsideComments(text, regPattern);
-
-    for (const RegexMatch &match : qAsConst(regMatches)) {
-        if (regPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = regPattern.cap(1);
-            symbol.symbolType = sym_reg;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, regPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
-
-    // Extract wire declarations
-    QRegExp wirePattern("\\bwire\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> wireMatches = findMatchesOutsideComments(text, wirePattern);
-
-    for (const RegexMatch &match : qAsConst(wireMatches)) {
-        if (wirePattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = wirePattern.cap(1);
-            symbol.symbolType = sym_wire;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, wirePattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
-
-    // Extract logic declarations
-    QRegExp logicPattern("\\blogic\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> logicMatches = findMatchesOutsideComments(text, logicPattern);
-
-    for (const RegexMatch &match : qAsConst(logicMatches)) {
-        if (logicPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = logicPattern.cap(1);
-            symbol.symbolType = sym_logic;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, logicPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
-
-    getAdditionalSymbols(text);
+    analyzeText(codeEditor->getFileName(), codeEditor->document()->toPlainText());
+    codeEditor->markSymbolsAnalyzed(fileRevision(codeEditor->getFileName()));
 }
 
-void sym_list::getAdditionalSymbols(const QString &text)
+void sym_list::setCodeEditorIncremental(MyCodeEditor* codeEditor)
 {
-    // 分析interface声明
-    analyzeInterfaces(text);
-
-    // 分析struct/enum/typedef声明
-    analyzeDataTypes(text);
-
-    // 分析预处理器指令
-    analyzePreprocessorDirectives(text);
+    if (!codeEditor) return;
 
-    // 分析always块和assign语句
-    //analyzeAlwaysAndAssign(text);
+    const QString fileName = codeEditor->getFileName();
 
-    // 分析参数声明
-    analyzeParameters(text);
+    // 🚀 编辑器上次分析后分片没有被其他途径替换时，只处理累积的编辑区间，不取整个缓冲区
+    const quint64 revision = fileRevision(fileName);
+    if (revision != 0 && codeEditor->analyzedRevision() == revision) {
+        const EditDelta& delta = codeEditor->pendingEdit();
+        if (delta.isEmpty() || applyEditDelta(fileName, codeEditor->document(), delta)) {
+            codeEditor->markSymbolsAnalyzed(fileRevision(fileName));
+            return;
+        }
+    }
 
-    // 分析约束相关
-    analyzeConstraints(text);
+    analyzeTextIncremental(fileName, codeEditor->document()->toPlainText());
+    codeEditor->markSymbolsAnalyzed(fileRevision(fileName));
 }
 
-void sym_list::getTasksAndFunctions(const QString &text)
+// 🚀 NEW: 直接分析文本，不需要编辑器控件或QTextDocument
+void sym_list::analyzeText(const QString& fileName, const QString& text)
 {
-    int symbolsFound = 0;
+    currentFileName = fileName;
 
-    // Extract task declarations
-    QRegExp taskPattern("\\btask\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> taskMatches = findMatchesOutsideComments(text, taskPattern);
+    // Build line offsets and comment regions first
+    buildLineOffsets(text);
+    buildCommentRegions(text);
 
-    for (const RegexMatch &match : qAsConst(taskMatches)) {
-        if (taskPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = taskPattern.cap(1);
-            symbol.symbolType = sym_task;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, taskPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
+    // 🚀 单遍词法/声明解析提取所有符号类型，写入新分片后整体替换旧分片
+    const QList<SymbolInfo> symbols = parseDeclarations(text);
+    std::shared_ptr<SymbolShard> shard = createShard(currentFileName);
+    addSymbols(*shard, symbols);
 
-    // Extract function declarations
-    QRegExp functionPattern("\\bfunction\\s+(?:\\w+\\s+)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> functionMatches = findMatchesOutsideComments(text, functionPattern);
-
-    for (const RegexMatch &match : qAsConst(functionMatches)) {
-        if (functionPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = functionPattern.cap(1);
-            symbol.symbolType = sym_function;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, functionPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
+    // 🚀 NEW: 发布分片并构建符号关系
+    replaceShard(shard);
 
+    // UPDATED: Force refresh all caches to ensure normal mode completion works
+    notifySymbolsChanged(ForceRefreshCaches);
 }
 
-void sym_list::setCodeEditorIncremental(MyCodeEditor* codeEditor)
+void sym_list::analyzeTextIncremental(const QString& fileName, const QString& content)
 {
-    if (!codeEditor) return;
-
-    currentFileName = codeEditor->getFileName();
-    QString content = codeEditor->document()->toPlainText();
+    currentFileName = fileName;
 
     if (!needsAnalysis(currentFileName, content)) {
         return;
@@ -801,1005 +680,640 @@ void sym_list::setCodeEditorIncremental(MyCodeEditor* codeEditor)
     // FIXED: 更清晰的分支逻辑
     bool isFirstTime = !fileStates.contains(currentFileName) || state.needsFullAnalysis;
 
-    if (isFirstTime) {
-        clearSymbolsForFile(currentFileName);
-        buildCommentRegions(content);
-        getModuleName(content);
-        getVariableDeclarations(content);
-        getTasksAndFunctions(content);
+    // 🚀 行指纹diff：未变化的行上的符号只平移到新行号，变化的行(扩展到语句边界)才重新解析
+    const LineFingerprintTable fingerprints(content);
+    const bool updated = !isFirstTime && applyLineDiff(currentFileName, content, fingerprints);
 
-        // 🚀 NEW: 构建符号关系
-        buildSymbolRelationships(currentFileName);
+    if (!updated) {
+        buildLineOffsets(content);
+        buildCommentRegions(content);
 
-        state.needsFullAnalysis = false;
+        const QList<SymbolInfo> symbols = parseDeclarations(content);
+        std::shared_ptr<SymbolShard> shard = createShard(currentFileName);
+        addSymbols(*shard, symbols);
 
-        // FIXED: 第一次分析后立即缓存内容
-        previousFileContents[currentFileName] = content;
-    } else {
-        QList<int> changedLines = detectChangedLines(currentFileName, content);
-        if (!changedLines.isEmpty()) {
-            analyzeSpecificLines(currentFileName, content, changedLines);
-
-            // 🚀 NEW: 增量更新关系
-            buildSymbolRelationships(currentFileName);
-        }
+        // 🚀 NEW: 发布分片并构建符号关系
+        replaceShard(shard);
     }
 
+    state.needsFullAnalysis = false;
+    storeLineFingerprints(currentFileName, fingerprints);
     state.contentHash = calculateContentHash(content);
     state.lastModified = QDateTime::currentDateTime();
 
-    QList<SymbolInfo> fileSymbols = findSymbolsByFileName(currentFileName);
-
-    CompletionManager::getInstance()->invalidateSymbolCaches();
+    notifySymbolsChanged(InvalidateCaches);
 }
 
-QString sym_list::calculateContentHash(const QString& content)
+void sym_list::EditDelta::merge(int position, int charsRemoved, int charsAdded)
 {
-    return QString::number(qHash(content));
+    if (isEmpty()) {
+        start = position;
+        oldEnd = position + charsRemoved;
+        newEnd = position + charsAdded;
+        return;
+    }
+
+    // 当前文本中 currentEnd 之后的部分对应旧文本的 currentEnd + (oldEnd - newEnd)
+    const int currentEnd = qMax(newEnd, position + charsRemoved);
+    oldEnd = currentEnd + (oldEnd - newEnd);
+    newEnd = currentEnd - charsRemoved + charsAdded;
+    start = qMin(start, position);
 }
 
-bool sym_list::needsAnalysis(const QString& fileName, const QString& content)
+quint64 sym_list::fileRevision(const QString& fileName) const
 {
-    if (!fileStates.contains(fileName)) return true;
-
-    QString newHash = calculateContentHash(content);
-    return newHash != fileStates[fileName].contentHash;
+    return fileRevisions.value(fileName, 0);
 }
 
-void sym_list::updateLineBasedSymbols(const SymbolInfo& symbol)
+quint64 sym_list::knownTypesFingerprint() const
 {
-    lineBasedSymbols[symbol.fileName][symbol.startLine].append(symbol);
+    return knownTypes().fingerprint();
 }
 
-QList<int> sym_list::detectChangedLines(const QString& fileName, const QString& newContent)
+quint64 sym_list::fileKnownTypesFingerprint(const QString& fileName) const
 {
-    QList<int> changedLines;
-
-    if (!previousFileContents.contains(fileName)) {
-        previousFileContents[fileName] = newContent;
+    return fileKnownTypeFingerprints.value(fileName, 0);
+}
 
-        // 第一次分析时，返回空列表，让完整分析处理
-        return changedLines; // 返回空列表，触发完整分析
+bool sym_list::applyEditDelta(const QString& fileName, const QTextDocument* document, const EditDelta& delta)
+{
+    auto shardIt = fileShards.constFind(fileName);
+    if (!document || delta.isEmpty() || shardIt == fileShards.constEnd()) {
+        return false;
     }
 
-    QString oldContent = previousFileContents[fileName];
-    QStringList oldLines = oldContent.split('\n');
-    QStringList newLines = newContent.split('\n');
-
-    int maxLines = qMax(oldLines.size(), newLines.size());
-    int actualChanges = 0;
-
-    for (int i = 0; i < maxLines; ++i) {
-        QString oldLine = (i < oldLines.size()) ? oldLines[i] : QString();
-        QString newLine = (i < newLines.size()) ? newLines[i] : QString();
+    EditRegion region;
+    if (!planEdit(*shardIt.value(), delta, document->characterCount() - 1, region)) {
+        return false;
+    }
 
-        if (oldLine.trimmed() != newLine.trimmed()) {
-            changedLines.append(i);
-            actualChanges++;
+    // 只取区间覆盖的文本块
+    QString fragment;
+    fragment.reserve(region.newRegionEnd - region.lineStart + 1);
+    for (QTextBlock block = document->findBlock(region.lineStart);
+         block.isValid() && block.position() < region.newRegionEnd; block = block.next()) {
+        fragment += block.text();
+        fragment += QLatin1Char('\n');
+    }
+    fragment.truncate(region.newRegionEnd - region.lineStart);
 
-            // 检查声明关键字，标记相邻行
-            static QStringList declarationKeywords = {"module", "reg", "wire", "logic", "task", "function"};
-            for (const QString &keyword : declarationKeywords) {
-                if (newLine.contains(QRegExp("\\b" + keyword + "\\b"))) {
-                    if (i > 0 && !changedLines.contains(i - 1)) {
-                        changedLines.append(i - 1);
-                    }
-                    if (i < maxLines - 1 && !changedLines.contains(i + 1)) {
-                        changedLines.append(i + 1);
-                    }
-                    break;
-                }
-            }
-        }
+    std::shared_ptr<SymbolShard> shard = copyShard(fileName);
+    if (!spliceEdit(*shard, region, fragment)) {
+        return false;
     }
 
-    // 更新缓存内容
-    previousFileContents[fileName] = newContent;
+    currentFileName = fileName;
+    currentLineOffsets = shard->lineOffsets();
+    currentCommentMask = shard->commentMask();
+    currentScopeTree = shard->scopeTree();
+    currentStatementBoundaries = shard->statementBoundaries();
 
-    // 去重并排序
-    changedLines = changedLines.toSet().toList();
-    std::sort(changedLines.begin(), changedLines.end());
+    replaceShard(shard);
 
-    return changedLines;
+    // 不保留行指纹也不对整个缓冲区求哈希；之后若走整文本路径则整文件解析
+    FileState& state = fileStates[fileName];
+    state.contentHash.clear();
+    state.lastModified = QDateTime::currentDateTime();
+    state.needsFullAnalysis = true;
+    dropLineFingerprints(fileName);
+
+    notifySymbolsChanged(InvalidateCaches);
+    return true;
 }
 
-void sym_list::analyzeSpecificLines(const QString& fileName, const QString& content, const QList<int>& lines)
+bool sym_list::planEdit(const SymbolShard& shard, const EditDelta& delta, int newLength, EditRegion& region) const
 {
-    if (lines.isEmpty()) {
-        return;
-    }
-
-    // 清除旧符号
-    clearSymbolsForLines(fileName, lines);
-
-    // 重建注释区域
-    buildCommentRegions(content);
+    const LineOffsetTable& oldOffsets = shard.lineOffsets();
+    const int oldLength = oldOffsets.length();
 
-    QStringList contentLines = content.split('\n');
-    int newSymbolsFound = 0;
-
-    for (int lineNum : lines) {
-        if (lineNum >= contentLines.size()) {
-            continue;
-        }
+    // 分片必须正好对应编辑前的文本
+    region.lengthChange = delta.lengthChange();
+    if (delta.isEmpty() || delta.oldEnd > oldLength || oldLength + region.lengthChange != newLength) {
+        return false;
+    }
 
-        QString lineText = contentLines[lineNum];
-        QString trimmedLine = lineText.trimmed();
+    // 扩展到语句边界(旧坐标)；边界处的 ; 自身不能落在被修改的区间内
+    const QVector<int>& boundaries = shard.statementBoundaries();
+    auto upper = std::upper_bound(boundaries.constBegin(), boundaries.constEnd(), delta.start);
+    auto after = std::lower_bound(upper, boundaries.constEnd(), delta.oldEnd + 1);
+    region.regionStart = (upper == boundaries.constBegin()) ? 0 : *(upper - 1);
+    region.reachesEnd = (after == boundaries.constEnd());
+    region.oldRegionEnd = region.reachesEnd ? oldLength : *after;
+    region.newRegionEnd = region.oldRegionEnd + region.lengthChange;
 
-        if (trimmedLine.isEmpty()) {
+    // 区间内有 module/endmodule 时模块结构可能改变；其余作用域由 spliceEdit 拼接
+    const ScopeTree& spans = shard.scopeTree();
+    for (int i = 0; i < spans.size(); ++i) {
+        const ScopeTree::Span& span = spans.at(i);
+        if (!span.isModule()) {
             continue;
         }
-
-        // 计算行在文件中的起始位置
-        int lineStartPos = 0;
-        for (int i = 0; i < lineNum; ++i) {
-            lineStartPos += contentLines[i].length() + 1; // +1 for '\n'
-        }
-
-        int symbolsBeforeLine = symbolDatabase.size();
-
-        // 分析各种符号类型
-        analyzeModulesInLine(lineText, lineStartPos, lineNum);
-        analyzeVariablesInLine(lineText, lineStartPos, lineNum);
-        analyzeTasksFunctionsInLine(lineText, lineStartPos, lineNum);
-
-        int symbolsAfterLine = symbolDatabase.size();
-        int symbolsFoundInLine = symbolsAfterLine - symbolsBeforeLine;
-        newSymbolsFound += symbolsFoundInLine;
-
-        if (symbolsFoundInLine > 0) {
-        } else {
+        if ((span.startPosition >= region.regionStart && span.startPosition < region.oldRegionEnd) ||
+            (span.isClosed() && span.endPosition > region.regionStart && span.endPosition <= region.oldRegionEnd)) {
+            return false;
         }
     }
+
+    region.firstLine = oldOffsets.lineForPosition(region.regionStart);
+    region.lineStart = oldOffsets.lineStart(region.firstLine);
+    return true;
 }
 
-void sym_list::analyzeTasksFunctionsInLine(const QString& lineText, int lineStartPos, int lineNum)
+bool sym_list::spliceEdit(SymbolShard& shard, const EditRegion& region, QString fragment)
 {
-    // 分析 task 声明
-    QRegExp taskPattern("\\btask\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    int tasksBefore = symbolDatabase.size();
-    analyzeTaskFunctionPattern(lineText, lineStartPos, lineNum, taskPattern, sym_task);
-    int tasksAfter = symbolDatabase.size();
-    int tasksFound = tasksAfter - tasksBefore;
-
-    // 分析 function 声明
-    QRegExp functionPattern("\\bfunction\\s+(?:\\w+\\s+)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    int functionsBefore = symbolDatabase.size();
-    analyzeTaskFunctionPattern(lineText, lineStartPos, lineNum, functionPattern, sym_function);
-    int functionsAfter = symbolDatabase.size();
-    int functionsFound = functionsAfter - functionsBefore;
+    // fragment 为新文本 [lineStart, newRegionEnd)；起点之前的同行字符以空格占位，使列号与全文解析一致
+    if (fragment.size() != region.newRegionEnd - region.lineStart) {
+        return false;
+    }
+    for (int i = region.lineStart; i < region.regionStart; ++i) {
+        fragment[i - region.lineStart] = QLatin1Char(' ');
+    }
 
-    if (tasksFound > 0 || functionsFound > 0) {
-    } else {
+    // 区间外的符号是按上次解析时的已知类型识别的，类型集合变化后只能整文件解析
+    flushBatchSnapshot();
+    const KnownTypes types = knownTypes();
+    auto typesIt = fileKnownTypeFingerprints.constFind(shard.fileName());
+    if (typesIt == fileKnownTypeFingerprints.constEnd() || typesIt.value() != types.fingerprint()) {
+        return false;
     }
-}
 
-void sym_list::clearSymbolsForLines(const QString& fileName, const QList<int>& lines)
-{
-    int removedCount = 0;
+    // 从区间起点所在的模块开始解析片段
+    const ScopeTree& oldScopes = shard.scopeTree();
+    SVDeclarationParser parser(shard.fileName(), fragment);
+    parser.setKnownStructTypes(types.structTypes);
+    parser.setKnownEnumTypes(types.enumTypes);
+    parser.setEnclosingModules(oldScopes.modulesAtPosition(region.regionStart));
 
-    // 从行级映射中清除
-    if (lineBasedSymbols.contains(fileName)) {
-        for (int lineNum : lines) {
-            if (lineBasedSymbols[fileName].contains(lineNum)) {
-                removedCount += lineBasedSymbols[fileName][lineNum].size();
-                lineBasedSymbols[fileName].remove(lineNum);
-            }
-        }
+    const QList<SymbolInfo> parsed = parser.parse();
+    if (parser.sawModuleBoundary()) {
+        return false;
     }
 
-    // 🚀 使用索引优化的删除方法
-    QList<int> indicesToRemove;
-
-    if (fileNameIndex.contains(fileName)) {
-        const QList<int>& fileIndices = fileNameIndex[fileName];
+    // 片段必须恰好在主循环的 ; 处结束，全文解析才会在同一位置回到相同状态
+    const QVector<int>& fragmentBoundaries = parser.statementBoundaries();
+    if (!region.reachesEnd && (fragmentBoundaries.isEmpty() || fragmentBoundaries.last() != fragment.size())) {
+        return false;
+    }
 
-        for (int index : fileIndices) {
-            if (index < symbolDatabase.size()) {
-                const SymbolInfo& symbol = symbolDatabase[index];
-                if (lines.contains(symbol.startLine)) {
-                    indicesToRemove.append(index);
-                }
+    // 区间内 struct/enum 类型定义的增删会改变全局已知类型，交给整文件解析
+    QHash<QString, int> oldTypeNames;
+    QHash<QString, int> newTypeNames;
+    for (sym_type_e typeKind : {sym_enum, sym_packed_struct, sym_unpacked_struct}) {
+        for (const SymbolInfo &symbol : shard.symbolsOfType(typeKind)) {
+            if (symbol.position >= region.regionStart && symbol.position < region.oldRegionEnd) {
+                oldTypeNames.insert(symbol.symbolName, symbol.symbolType);
             }
         }
     }
-
-    // 按降序删除以避免索引混乱
-    std::sort(indicesToRemove.begin(), indicesToRemove.end(), std::greater<int>());
-
-    for (int index : indicesToRemove) {
-        if (index < symbolDatabase.size()) {
-            removeFromIndexes(index);
-            symbolDatabase.removeAt(index);
+    for (const SymbolInfo &symbol : parsed) {
+        if (symbol.symbolType == sym_enum || symbol.symbolType == sym_packed_struct ||
+            symbol.symbolType == sym_unpacked_struct) {
+            newTypeNames.insert(symbol.symbolName, symbol.symbolType);
         }
     }
-
-    // 重建索引
-    if (!indicesToRemove.isEmpty()) {
-        rebuildAllIndexes();
+    if (oldTypeNames != newTypeNames) {
+        return false;
     }
-}
 
-void sym_list::analyzeModulesInLine(const QString& lineText, int lineStartPos, int lineNum)
-{
-    QRegExp modulePattern("\\bmodule\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
+    // 拼接行偏移/注释掩码/作用域树/语句边界，只处理区间文本
+    const LineOffsetTable& oldOffsets = shard.lineOffsets();
+    const QString inserted = fragment.mid(region.regionStart - region.lineStart);
+    const int removedLength = region.oldRegionEnd - region.regionStart;
 
-    int pos = 0;
-    while ((pos = modulePattern.indexIn(lineText, pos)) != -1) {
-        int absolutePos = lineStartPos + pos;
+    LineOffsetTable offsets = oldOffsets;
+    offsets.replace(region.regionStart, removedLength, inserted);
+    const int lineDelta = offsets.lineCount() - oldOffsets.lineCount();
 
-        if (!isMatchInComment(absolutePos, modulePattern.matchedLength())) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = modulePattern.cap(1);
-            symbol.symbolType = sym_module;
-            symbol.startLine = lineNum;
-            symbol.startColumn = pos;
-            symbol.endLine = lineNum;
-            symbol.endColumn = pos + symbol.symbolName.length();
-            symbol.position = absolutePos;
-            symbol.length = modulePattern.matchedLength();
+    CommentMask mask = shard.commentMask();
+    mask.replace(region.regionStart, removedLength, CommentMask(inserted));
 
-            addSymbol(symbol);
-        }
+    ScopeTree scopes = oldScopes;
+    scopes.splice(region.regionStart, region.oldRegionEnd, region.lengthChange, lineDelta,
+                  parser.scopeTree(), region.lineStart, region.firstLine);
 
-        pos += modulePattern.matchedLength();
+    const QVector<int>& boundaries = shard.statementBoundaries();
+    QVector<int> newBoundaries;
+    newBoundaries.reserve(boundaries.size() + fragmentBoundaries.size());
+    for (int boundary : boundaries) {
+        if (boundary <= region.regionStart) {
+            newBoundaries.append(boundary);
+        }
     }
-}
-
-void sym_list::analyzeVariablesInLine(const QString& lineText, int lineStartPos, int lineNum)
-{
-    // reg 变量
-    QRegExp regPattern("\\breg\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    analyzeVariablePattern(lineText, lineStartPos, lineNum, regPattern, sym_reg);
-
-    // wire 变量
-    QRegExp wirePattern("\\bwire\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    analyzeVariablePattern(lineText, lineStartPos, lineNum, wirePattern, sym_wire);
-
-    // logic 变量
-    QRegExp logicPattern("\\blogic\\s+(?:\\[[^\\]]*\\]\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    analyzeVariablePattern(lineText, lineStartPos, lineNum, logicPattern, sym_logic);
-}
-
-// 新增：获取指定位置的模块作用域
-QString sym_list::getCurrentModuleScope(const QString& fileName, int lineNumber) {
-    // 查找包含该行的模块
-    QList<SymbolInfo> modules = findSymbolsByType(sym_module);
-    for (const SymbolInfo& moduleSymbol : modules) {
-        if (moduleSymbol.fileName == fileName) {
-            // 查找模块的结束位置
-            int moduleEndLine = findEndModuleLine(fileName, moduleSymbol);
-            if (lineNumber > moduleSymbol.startLine && lineNumber < moduleEndLine) {
-                return moduleSymbol.symbolName;
-            }
+    for (int boundary : fragmentBoundaries) {
+        newBoundaries.append(boundary + region.lineStart);
+    }
+    for (int boundary : boundaries) {
+        if (boundary > region.oldRegionEnd) {
+            newBoundaries.append(boundary + region.lengthChange);
         }
     }
-    return QString(); // 不在任何模块内
-}
-
-void sym_list::analyzeVariablePattern(const QString& lineText, int lineStartPos, int lineNum,
-                                     const QRegExp& pattern, sym_type_e symbolType)
-{
-    QRegExp regExp(pattern);
-    int pos = 0;
 
-    while ((pos = regExp.indexIn(lineText, pos)) != -1) {
-        int absolutePos = lineStartPos + pos;
+    // 与区间终点同一行、位于其后的符号，列号随终点列号变化
+    const int columnLine = oldOffsets.lineForPosition(region.oldRegionEnd);
+    const int oldEndColumn = region.oldRegionEnd - oldOffsets.lineStart(columnLine);
+    const int newEndColumn = region.newRegionEnd - offsets.lineStart(offsets.lineForPosition(region.newRegionEnd));
 
-        if (!isMatchInComment(absolutePos, regExp.matchedLength())) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = regExp.cap(1);
-            symbol.symbolType = symbolType;
-            symbol.startLine = lineNum;
-            symbol.startColumn = regExp.pos(1) - lineStartPos + lineStartPos;
-            symbol.endLine = lineNum;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            symbol.position = absolutePos;
-            symbol.length = regExp.matchedLength();
+    // 删除区间内的旧符号，之后的符号平移，再加入片段解析出的符号
+    shard.removeSymbolsInRange(region.regionStart, region.oldRegionEnd);
+    shard.shiftSymbols(region.oldRegionEnd, region.lengthChange, lineDelta, columnLine, newEndColumn - oldEndColumn);
+    shard.setLineOffsets(offsets);
+    shard.setCommentMask(mask);
+    shard.setScopeTree(scopes);
+    shard.setStatementBoundaries(newBoundaries);
 
-            symbol.moduleScope = getCurrentModuleScope(symbol.fileName, symbol.startLine);
-            addSymbol(symbol);
-        }
-
-        pos += regExp.matchedLength();
+    QList<SymbolInfo> shifted;
+    shifted.reserve(parsed.size());
+    for (SymbolInfo symbol : parsed) {
+        symbol.position += region.lineStart;
+        symbol.startLine += region.firstLine;
+        symbol.endLine += region.firstLine;
+        shifted.append(symbol);
     }
+    addSymbols(shard, shifted);
+    return true;
 }
 
-int sym_list::findEndModuleLine(const QString &fileName, const SymbolInfo &moduleSymbol)
+bool sym_list::applyLineDiff(const QString& fileName, const QString& content, const LineFingerprintTable& fingerprints)
 {
-    if (moduleSymbol.symbolType != sym_module) {
-        return -1;
+    auto shardIt = fileShards.constFind(fileName);
+    auto fingerprintIt = fileLineFingerprints.constFind(fileName);
+    if (shardIt == fileShards.constEnd() || fingerprintIt == fileLineFingerprints.constEnd()) {
+        return false;
     }
 
-    // Check if the file content is already cached
-    QString content;
-    if (previousFileContents.contains(fileName)) {
-        content = previousFileContents[fileName];
-    } else {
-        QFile file(fileName);
-        if (!file.open(QIODevice::ReadOnly | QFile::Text)) {
-            return -1; // Cannot open file
-        }
-        content = file.readAll();
-        file.close();
-        previousFileContents[fileName] = content;
+    const LineOffsetTable oldOffsets = shardIt.value()->lineOffsets();
+    const LineFingerprintTable& oldFingerprints = fingerprintIt.value().table;
+    if (oldFingerprints.lineCount() != oldOffsets.lineCount()) {
+        return false;
     }
 
-    QStringList lines = content.split('\n');
-    int moduleDepth = 0;
+    QVector<LineFingerprintTable::Hunk> hunks;
+    if (!LineFingerprintTable::diff(oldFingerprints, fingerprints, hunks)) {
+        return false;
+    }
 
-    for (int i = moduleSymbol.startLine; i < lines.size(); ++i) {
-        const QString &line = lines[i];
-        if (line.contains(QRegExp("\\bmodule\\b")) && !isMatchInComment(content.indexOf(line), line.length())) {
-            moduleDepth++;
+    // 行块 -> 字符区间。最后一行没有换行符，触及文件末尾的块向前多带一行，使两边区间的起点相同
+    const LineOffsetTable newOffsets(content);
+    struct CharRange { int oldStart; int oldEnd; int newStart; int newEnd; };
+    QVector<CharRange> ranges;
+    ranges.reserve(hunks.size());
+    for (LineFingerprintTable::Hunk hunk : qAsConst(hunks)) {
+        const bool atEnd = hunk.oldStart + hunk.oldCount == oldOffsets.lineCount();
+        if (atEnd && hunk.oldStart > 0 && hunk.newStart > 0) {
+            hunk.oldStart--;
+            hunk.oldCount++;
+            hunk.newStart--;
+            hunk.newCount++;
         }
-        if (line.contains(QRegExp("\\bendmodule\\b")) && !isMatchInComment(content.indexOf(line), line.length())) {
-            moduleDepth--;
-            if (moduleDepth == 0) {
-                qDebug()<<"endmodule line"<<i;
-                return i;
+
+        CharRange range;
+        range.oldStart = hunk.oldStart < oldOffsets.lineCount() ? oldOffsets.lineStart(hunk.oldStart) : oldOffsets.length();
+        range.newStart = hunk.newStart < newOffsets.lineCount() ? newOffsets.lineStart(hunk.newStart) : newOffsets.length();
+        range.oldEnd = atEnd ? oldOffsets.length() : oldOffsets.lineStart(hunk.oldStart + hunk.oldCount);
+        range.newEnd = atEnd ? newOffsets.length() : newOffsets.lineStart(hunk.newStart + hunk.newCount);
+        ranges.append(range);
+    }
+
+    // 按顺序逐块拼接。处理第 i 块时之前的块已按新文本替换，因此中间状态的坐标在块之前与新文本一致；
+    // 扩展后的区间若伸进下一块的范围，就把两块合并处理，保证从新文本读取的片段不含尚未处理的改动
+    std::shared_ptr<SymbolShard> shard = copyShard(fileName);
+    int shift = 0;              // 已处理的块造成的长度变化
+    int i = 0;
+    while (i < ranges.size()) {
+        EditDelta delta;
+        delta.start = ranges.at(i).newStart;
+        delta.oldEnd = ranges.at(i).oldEnd + shift;
+        delta.newEnd = ranges.at(i).newEnd;
+
+        EditRegion region;
+        int last = i;
+        for (;;) {
+            if (!planEdit(*shard, delta, shard->lineOffsets().length() + delta.lengthChange(), region)) {
+                return false;
+            }
+            if (last + 1 >= ranges.size() || region.newRegionEnd <= ranges.at(last + 1).newStart) {
+                break;
             }
+            ++last;
+            delta.oldEnd = ranges.at(last).oldEnd + shift;
+            delta.newEnd = ranges.at(last).newEnd;
         }
+
+        if (!spliceEdit(*shard, region,
+                        content.mid(region.lineStart, region.newRegionEnd - region.lineStart))) {
+            return false;
+        }
+
+        shift += region.lengthChange;
+        i = last + 1;
     }
 
-    return -1; // endmodule not found
+    currentLineOffsets = shard->lineOffsets();
+    currentCommentMask = shard->commentMask();
+    currentScopeTree = shard->scopeTree();
+    currentStatementBoundaries = shard->statementBoundaries();
+
+    replaceShard(shard);
+    return true;
 }
 
-void sym_list::analyzeTaskFunctionPattern(const QString& lineText, int lineStartPos, int lineNum,
-                                         const QRegExp& pattern, sym_type_e symbolType)
+QString sym_list::calculateContentHash(const QString& content)
 {
-    QRegExp regExp(pattern);
-    int pos = 0;
-
-    while ((pos = regExp.indexIn(lineText, pos)) != -1) {
-        int absolutePos = lineStartPos + pos;
+    return QString::number(qHash(content));
+}
 
-        if (!isMatchInComment(absolutePos, regExp.matchedLength())) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = regExp.cap(1);
-            symbol.symbolType = symbolType;
-            symbol.startLine = lineNum;
+bool sym_list::needsAnalysis(const QString& fileName, const QString& content) const
+{
+    auto it = fileStates.constFind(fileName);
+    if (it == fileStates.constEnd()) return true;
 
-            // 计算捕获组在行中的位置
-            int capturePos = regExp.pos(1);
-            symbol.startColumn = capturePos;
-            symbol.endLine = lineNum;
-            symbol.endColumn = capturePos + symbol.symbolName.length();
-            symbol.position = lineStartPos + capturePos;
-            symbol.length = symbol.symbolName.length();
+    QString newHash = calculateContentHash(content);
+    return newHash != it.value().contentHash;
+}
 
-            addSymbol(symbol);
-        }
+QString sym_list::analyzedContentHash(const QString& fileName) const
+{
+    return fileStates.value(fileName).contentHash;
+}
 
-        pos += regExp.matchedLength();
-    }
+void sym_list::setAnalysisCacheBudget(qint64 bytes)
+{
+    analysisCacheBudgetBytes = qMax<qint64>(0, bytes);
+    trimAnalysisCache();
 }
 
-bool isSymbolInModule(const sym_list::SymbolInfo& symbol, const sym_list::SymbolInfo& module)
+qint64 sym_list::analysisCacheBudget() const
 {
-    // 简单实现：检查符号是否在模块的行范围内
-    // 更复杂的实现需要解析模块的endmodule位置
-    return symbol.fileName == module.fileName &&
-           symbol.startLine > module.startLine;
+    return analysisCacheBudgetBytes;
 }
 
-QString getModuleNameContainingSymbol(const sym_list::SymbolInfo& symbol,
-                                     const QList<sym_list::SymbolInfo>& allSymbols)
+qint64 sym_list::analysisCacheUsage() const
 {
-    for (const sym_list::SymbolInfo& moduleSymbol : allSymbols) {
-        if (moduleSymbol.symbolType == sym_list::sym_module &&
-            isSymbolInModule(symbol, moduleSymbol)) {
-            return moduleSymbol.symbolName;
-        }
-    }
-    return QString(); // 没有找到包含的模块
+    return analysisCacheBytes;
 }
 
+int sym_list::analysisCacheFileCount() const
+{
+    return fileLineFingerprints.size();
+}
 
-// 🚀 Interface 分析
-void sym_list::analyzeInterfaces(const QString &text)
+qint64 sym_list::cacheEntrySize(const QString& fileName, const LineFingerprintTable& fingerprints)
 {
-    int symbolsFound = 0;
+    // 文件名键与表头按固定开销估算
+    return fingerprints.memoryUsage() + fileName.size() * qint64(sizeof(QChar)) + 64;
+}
 
-    // Interface 声明: interface interfaceName;
-    QRegExp interfacePattern("\\binterface\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*[;(]");
-    QList<RegexMatch> interfaceMatches = findMatchesOutsideComments(text, interfacePattern);
+void sym_list::storeLineFingerprints(const QString& fileName, const LineFingerprintTable& fingerprints)
+{
+    dropLineFingerprints(fileName);
 
-    for (const RegexMatch &match : qAsConst(interfaceMatches)) {
-        if (interfacePattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = interfacePattern.cap(1);
-            symbol.symbolType = sym_interface;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, interfacePattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
+    CachedFingerprints& entry = fileLineFingerprints[fileName];
+    entry.table = fingerprints;
+    entry.bytes = cacheEntrySize(fileName, fingerprints);
+    entry.lastUse = ++fingerprintUseCounter;
+    analysisCacheBytes += entry.bytes;
 
-    // Modport 声明: modport portName(input sig1, output sig2);
-    QRegExp modportPattern("\\bmodport\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*\\(");
-    QList<RegexMatch> modportMatches = findMatchesOutsideComments(text, modportPattern);
-
-    for (const RegexMatch &match : qAsConst(modportMatches)) {
-        if (modportPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = modportPattern.cap(1);
-            symbol.symbolType = sym_interface_modport;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, modportPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
+    trimAnalysisCache();
 }
 
-// 🚀 数据类型分析 (struct, enum, typedef)
-void sym_list::analyzeDataTypes(const QString &text)
+void sym_list::dropLineFingerprints(const QString& fileName)
 {
-    int symbolsFound = 0;
+    auto it = fileLineFingerprints.find(fileName);
+    if (it == fileLineFingerprints.end()) {
+        return;
+    }
 
-    // Packed struct: typedef struct packed { ... } structName;
-    QRegExp packedStructPattern("\\btypedef\\s+struct\\s+packed\\s*\\{([^}]+)\\}\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> packedStructMatches = findMatchesOutsideComments(text, packedStructPattern);
+    analysisCacheBytes -= it.value().bytes;
+    fileLineFingerprints.erase(it);
+}
 
-    for (const RegexMatch &match : qAsConst(packedStructMatches)) {
-        if (packedStructPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = packedStructPattern.cap(1);
-            symbol.symbolType = sym_packed_struct;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, packedStructPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+void sym_list::trimAnalysisCache()
+{
+    if (analysisCacheBytes <= analysisCacheBudgetBytes) {
+        return;
     }
 
-    // Unpacked struct: typedef struct { ... } structName;
-    QRegExp unpackedStructPattern("typedef\\s+struct\\s*\\{[^}]*\\}\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> unpackedStructMatches = findMatchesOutsideComments(text, unpackedStructPattern);
-
-    for (const RegexMatch &match : qAsConst(unpackedStructMatches)) {
-        if (unpackedStructPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = unpackedStructPattern.cap(1);
-            symbol.symbolType = sym_unpacked_struct;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, unpackedStructPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+    // 按最近使用顺序淘汰到预算的3/4，避免每分析一个文件就触发一次排序
+    QVector<QPair<quint64, QString>> entries;
+    entries.reserve(fileLineFingerprints.size());
+    for (auto it = fileLineFingerprints.constBegin(); it != fileLineFingerprints.constEnd(); ++it) {
+        entries.append(qMakePair(it.value().lastUse, it.key()));
     }
+    std::sort(entries.begin(), entries.end());
 
-    // Enum: typedef enum { ... } enumName;
-    QRegExp enumPattern("typedef\\s+enum\\s*(?:\\{[^}]*\\})?\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> enumMatches = findMatchesOutsideComments(text, enumPattern);
-
-    for (const RegexMatch &match : qAsConst(enumMatches)) {
-        if (enumPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = enumPattern.cap(1);
-            symbol.symbolType = sym_enum;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, enumPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
+    const qint64 target = analysisCacheBudgetBytes / 4 * 3;
+    for (const auto& entry : qAsConst(entries)) {
+        if (analysisCacheBytes <= target) {
+            break;
         }
-    }
 
-    // Typedef: typedef existingType newTypeName;
-    QRegExp typedefPattern("\\btypedef\\s+(?:(?:struct|enum|union)\\s+)?[a-zA-Z_][a-zA-Z0-9_\\[\\]:]*\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*;");
-    QList<RegexMatch> typedefMatches = findMatchesOutsideComments(text, typedefPattern);
-
-    for (const RegexMatch &match : qAsConst(typedefMatches)) {
-        if (typedefPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = typedefPattern.cap(1);
-            symbol.symbolType = sym_typedef;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, typedefPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
+        // 被淘汰的文件在下次变化时整文件重新解析
+        dropLineFingerprints(entry.second);
+        auto stateIt = fileStates.find(entry.second);
+        if (stateIt != fileStates.end()) {
+            stateIt.value().needsFullAnalysis = true;
         }
     }
 }
 
-// 🚀 预处理器指令分析
-void sym_list::analyzePreprocessorDirectives(const QString &text)
+quint64 sym_list::KnownTypes::fingerprint() const
 {
-    int symbolsFound = 0;
-
-    // `define 宏定义: `define MACRO_NAME value
-    QRegExp definePattern("`define\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> defineMatches = findMatchesOutsideComments(text, definePattern);
-
-    for (const RegexMatch &match : qAsConst(defineMatches)) {
-        if (definePattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = definePattern.cap(1);
-            symbol.symbolType = sym_def_define;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, definePattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
+    // 每个类型名各自做 FNV-1a 后求和，与哈希表的遍历顺序无关
+    auto hashName = [](const QString& name, ushort kind) {
+        quint64 hash = Q_UINT64_C(14695981039346656037);
+        hash = (hash ^ kind) * Q_UINT64_C(1099511628211);
+        for (const QChar ch : name) {
+            hash = (hash ^ ch.unicode()) * Q_UINT64_C(1099511628211);
         }
-    }
+        return hash;
+    };
 
-    // `ifdef 条件编译
-    QRegExp ifdefPattern("`ifdef\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> ifdefMatches = findMatchesOutsideComments(text, ifdefPattern);
-
-    for (const RegexMatch &match : qAsConst(ifdefMatches)) {
-        if (ifdefPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = ifdefPattern.cap(1);
-            symbol.symbolType = sym_def_ifdef;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, ifdefPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+    quint64 sum = quint64(structTypes.size()) << 32 | quint64(enumTypes.size());
+    for (auto it = structTypes.constBegin(); it != structTypes.constEnd(); ++it) {
+        sum += hashName(it.key(), it.value() ? 1 : 2);
     }
-
-    // `ifndef 条件编译
-    QRegExp ifndefPattern("`ifndef\\s+([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> ifndefMatches = findMatchesOutsideComments(text, ifndefPattern);
-
-    for (const RegexMatch &match : qAsConst(ifndefMatches)) {
-        if (ifndefPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = ifndefPattern.cap(1);
-            symbol.symbolType = sym_def_ifndef;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, ifndefPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+    for (const QString& name : enumTypes) {
+        sum += hashName(name, 3);
     }
+    return sum;
 }
 
-// 🚀 Always块和Assign语句分析
-void sym_list::analyzeAlwaysAndAssign(const QString &text)
-{
-    int symbolsFound = 0;
-
-    // always_ff 块
-    QRegExp alwaysFFPattern("\\balways_ff\\s*@\\s*\\([^)]*\\)");
-    QList<RegexMatch> alwaysFFMatches = findMatchesOutsideComments(text, alwaysFFPattern);
-
-    for (const RegexMatch &match : qAsConst(alwaysFFMatches)) {
-        SymbolInfo symbol;
-        symbol.fileName = currentFileName;
-        symbol.symbolName = QString("always_ff_%1").arg(symbol.startLine);
-        symbol.symbolType = sym_always_ff;
-        symbol.position = match.position;
-        symbol.length = match.length;
-        calculateLineColumn(text, match.position, symbol.startLine, symbol.startColumn);
-        symbol.endLine = symbol.startLine;
-        symbol.endColumn = symbol.startColumn + match.length;
-        addSymbol(symbol);
-        symbolsFound++;
-    }
-
-    // always_comb 块
-    QRegExp alwaysCombPattern("\\balways_comb\\b");
-    QList<RegexMatch> alwaysCombMatches = findMatchesOutsideComments(text, alwaysCombPattern);
-
-    for (const RegexMatch &match : qAsConst(alwaysCombMatches)) {
-        SymbolInfo symbol;
-        symbol.fileName = currentFileName;
-        symbol.symbolName = QString("always_comb_%1").arg(symbol.startLine);
-        symbol.symbolType = sym_always_comb;
-        symbol.position = match.position;
-        symbol.length = match.length;
-        calculateLineColumn(text, match.position, symbol.startLine, symbol.startColumn);
-        symbol.endLine = symbol.startLine;
-        symbol.endColumn = symbol.startColumn + match.length;
-        addSymbol(symbol);
-        symbolsFound++;
-    }
-
-    // always 块 (通用)
-    QRegExp alwaysPattern("\\balways\\s*@\\s*\\([^)]*\\)");
-    QList<RegexMatch> alwaysMatches = findMatchesOutsideComments(text, alwaysPattern);
-
-    for (const RegexMatch &match : qAsConst(alwaysMatches)) {
-        SymbolInfo symbol;
-        symbol.fileName = currentFileName;
-        symbol.symbolName = QString("always_%1").arg(symbol.startLine);
-        symbol.symbolType = sym_always;
-        symbol.position = match.position;
-        symbol.length = match.length;
-        calculateLineColumn(text, match.position, symbol.startLine, symbol.startColumn);
-        symbol.endLine = symbol.startLine;
-        symbol.endColumn = symbol.startColumn + match.length;
-        addSymbol(symbol);
-        symbolsFound++;
-    }
-
-    // assign 语句
-    QRegExp assignPattern("\\bassign\\s+([a-zA-Z_][a-zA-Z0-9_\\[\\]]*)\\s*=");
-    QList<RegexMatch> assignMatches = findMatchesOutsideComments(text, assignPattern);
-
-    for (const RegexMatch &match : qAsConst(assignMatches)) {
-        if (assignPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = assignPattern.cap(1);
-            symbol.symbolType = sym_assign;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, assignPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+sym_list::KnownTypes sym_list::knownTypes() const
+{
+    // 其他文件中定义的struct/enum类型，用于识别 "type_t var;" 形式的变量
+    KnownTypes types;
+    const std::shared_ptr<const SymbolSnapshot> snapshot = getSnapshot();
+    for (const QString &name : snapshot->symbolNamesOfType(sym_packed_struct)) {
+        types.structTypes.insert(name, true);
+    }
+    for (const QString &name : snapshot->symbolNamesOfType(sym_unpacked_struct)) {
+        types.structTypes.insert(name, false);
     }
+    types.enumTypes = snapshot->symbolNamesOfType(sym_enum).toSet();
+    return types;
 }
 
-// 🚀 参数分析
-void sym_list::analyzeParameters(const QString &text)
+QList<sym_list::SymbolInfo> sym_list::parseDeclarations(const QString &text)
 {
-    int symbolsFound = 0;
+    SVDeclarationParser parser(currentFileName, text);
 
-    // parameter 声明
-    QRegExp parameterPattern("\\bparameter\\s+(?:[a-zA-Z_][a-zA-Z0-9_]*\\s*=\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> parameterMatches = findMatchesOutsideComments(text, parameterPattern);
+    flushBatchSnapshot();
+    const KnownTypes types = knownTypes();
+    parser.setKnownStructTypes(types.structTypes);
+    parser.setKnownEnumTypes(types.enumTypes);
+    fileKnownTypeFingerprints.insert(currentFileName, types.fingerprint());
 
-    for (const RegexMatch &match : qAsConst(parameterMatches)) {
-        if (parameterPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = parameterPattern.cap(1);
-            symbol.symbolType = sym_parameter;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, parameterPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
-    }
+    const QList<SymbolInfo> symbols = parser.parse();
+    currentScopeTree = parser.scopeTree();
+    currentStatementBoundaries = parser.statementBoundaries();
+    return symbols;
+}
 
-    // localparam 声明
-    QRegExp localparamPattern("\\blocalparam\\s+(?:[a-zA-Z_][a-zA-Z0-9_]*\\s*=\\s*)?([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> localparamMatches = findMatchesOutsideComments(text, localparamPattern);
-
-    for (const RegexMatch &match : qAsConst(localparamMatches)) {
-        if (localparamPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = localparamPattern.cap(1);
-            symbol.symbolType = sym_localparam;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, localparamPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+sym_list::ParseContext sym_list::parseContext() const
+{
+    ParseContext context;
+
+    const KnownTypes types = knownTypes();
+    context.structTypes = types.structTypes;
+    context.enumTypes = types.enumTypes;
+    context.knownTypesFingerprint = types.fingerprint();
+
+    for (auto it = fileStates.constBegin(); it != fileStates.constEnd(); ++it) {
+        context.contentHashes.insert(it.key(), it.value().contentHash);
     }
+    context.fileRevisions = fileRevisions;
+    return context;
 }
 
-// 🚀 约束分析 (Xilinx等)
-void sym_list::analyzeConstraints(const QString &text)
+// 🚀 线程安全：只读 context、写入新分片；符号ID按文件整段原子预留，字符串进入线程安全的原子表
+sym_list::ParsedFile sym_list::parseFileText(const QString& fileName, const QString& content,
+                                             const ParseContext& context)
 {
-    int symbolsFound = 0;
+    ParsedFile result;
+    result.fileName = fileName;
+    result.contentHash = calculateContentHash(content);
+    result.knownTypesFingerprint = context.knownTypesFingerprint;
 
-    // Xilinx 约束: (* KEEP = "TRUE" *) 等
-    QRegExp xilinxConstraintPattern("\\(\\*\\s*([A-Z_]+)\\s*=");
-    QList<RegexMatch> constraintMatches = findMatchesOutsideComments(text, xilinxConstraintPattern);
-
-    for (const RegexMatch &match : qAsConst(constraintMatches)) {
-        if (xilinxConstraintPattern.indexIn(text, match.position) != -1) {
-            SymbolInfo symbol;
-            symbol.fileName = currentFileName;
-            symbol.symbolName = xilinxConstraintPattern.cap(1);
-            symbol.symbolType = sym_xilinx_constraint;
-            symbol.position = match.position;
-            symbol.length = match.length;
-            calculateLineColumn(text, xilinxConstraintPattern.pos(1), symbol.startLine, symbol.startColumn);
-            symbol.endLine = symbol.startLine;
-            symbol.endColumn = symbol.startColumn + symbol.symbolName.length();
-            addSymbol(symbol);
-            symbolsFound++;
-        }
+    if (context.contentHashes.value(fileName) == result.contentHash) {
+        return result;
     }
+    result.lineFingerprints.build(content);
+
+    SVDeclarationParser parser(fileName, content);
+    parser.setKnownStructTypes(context.structTypes);
+    parser.setKnownEnumTypes(context.enumTypes);
+    const QList<SymbolInfo> symbols = parser.parse();
+
+    result.shard = buildShard(fileName, symbols, CommentMask(content), LineOffsetTable(content),
+                              parser.scopeTree(), parser.statementBoundaries());
+    return result;
 }
 
-void sym_list::analyzeEnumsAndStructs(const QString &text)
-{
-    int symbolsFound = 0;
-
-    // ===== 枚举类型分析 =====
-
-    // 1. 基本枚举: enum { VALUE1, VALUE2 } var_name;
-    QRegExp basicEnumPattern("\\benum\\s*\\{([^}]+)\\}\\s*([a-zA-Z_][a-zA-Z0-9_,\\s]*)");
-    QList<RegexMatch> basicEnumMatches = findMatchesOutsideComments(text, basicEnumPattern);
-
-    for (const RegexMatch &match : qAsConst(basicEnumMatches)) {
-        if (basicEnumPattern.indexIn(text, match.position) != -1) {
-            QString enumValues = basicEnumPattern.cap(1);
-            QString variables = basicEnumPattern.cap(2);
-
-            // 解析枚举值
-            QStringList valueList = enumValues.split(',', QString::SkipEmptyParts);
-            for (const QString &value : valueList) {
-                QString cleanValue = value.trimmed();
-                // 移除赋值部分 (例如 VALUE1 = 1)
-                int assignPos = cleanValue.indexOf('=');
-                if (assignPos >= 0) {
-                    cleanValue = cleanValue.left(assignPos).trimmed();
-                }
-
-                if (!cleanValue.isEmpty()) {
-                    SymbolInfo enumValueSymbol;
-                    enumValueSymbol.fileName = currentFileName;
-                    enumValueSymbol.symbolName = cleanValue;
-                    enumValueSymbol.symbolType = sym_enum_value;
-                    enumValueSymbol.position = match.position;
-                    enumValueSymbol.length = cleanValue.length();
-                    calculateLineColumn(text, match.position, enumValueSymbol.startLine, enumValueSymbol.startColumn);
-                    enumValueSymbol.endLine = enumValueSymbol.startLine;
-                    enumValueSymbol.endColumn = enumValueSymbol.startColumn + cleanValue.length();
-                    addSymbol(enumValueSymbol);
-                    symbolsFound++;
-                }
-            }
+// 🚀 线程安全：由解析结果或磁盘缓存中的符号建立新分片，为整个文件一次性预留符号ID
+std::shared_ptr<SymbolShard> sym_list::buildShard(const QString& fileName, const QList<SymbolInfo>& symbols,
+                                                  const CommentMask& commentMask,
+                                                  const LineOffsetTable& lineOffsets,
+                                                  const ScopeTree& scopeTree,
+                                                  const QVector<int>& statementBoundaries)
+{
+    auto shard = std::make_shared<SymbolShard>(fileName);
+    shard->setCommentMask(commentMask);
+    shard->setLineOffsets(lineOffsets);
+    shard->setScopeTree(scopeTree);
+    shard->setStatementBoundaries(statementBoundaries);
 
-            // 解析枚举变量
-            QStringList varList = variables.split(',', QString::SkipEmptyParts);
-            for (const QString &var : varList) {
-                QString cleanVar = var.trimmed().remove(';');
-                if (!cleanVar.isEmpty()) {
-                    SymbolInfo enumVarSymbol;
-                    enumVarSymbol.fileName = currentFileName;
-                    enumVarSymbol.symbolName = cleanVar;
-                    enumVarSymbol.symbolType = sym_enum_var;
-                    enumVarSymbol.position = match.position;
-                    enumVarSymbol.length = cleanVar.length();
-                    calculateLineColumn(text, match.position, enumVarSymbol.startLine, enumVarSymbol.startColumn);
-                    enumVarSymbol.endLine = enumVarSymbol.startLine;
-                    enumVarSymbol.endColumn = enumVarSymbol.startColumn + cleanVar.length();
-                    addSymbol(enumVarSymbol);
-                    symbolsFound++;
-                }
-            }
-        }
+    shard->reserve(symbols.size());
+    int symbolId = reserveSymbolIds(symbols.size());
+    for (SymbolInfo symbol : symbols) {
+        symbol.fileName = fileName;
+        symbol.symbolId = symbolId++;
+        shard->addSymbol(symbol);
     }
+    return shard;
+}
 
-    // 2. Typedef枚举: typedef enum { VALUE1, VALUE2 } enum_name_t;
-    QRegExp typedefEnumPattern("\\btypedef\\s+enum\\s*\\{([^}]+)\\}\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> typedefEnumMatches = findMatchesOutsideComments(text, typedefEnumPattern);
-
-    for (const RegexMatch &match : qAsConst(typedefEnumMatches)) {
-        if (typedefEnumPattern.indexIn(text, match.position) != -1) {
-            QString enumValues = typedefEnumPattern.cap(1);
-            QString typeName = typedefEnumPattern.cap(2);
-
-            // 添加枚举类型定义
-            SymbolInfo enumTypeSymbol;
-            enumTypeSymbol.fileName = currentFileName;
-            enumTypeSymbol.symbolName = typeName;
-            enumTypeSymbol.symbolType = sym_enum;
-            enumTypeSymbol.position = match.position;
-            enumTypeSymbol.length = match.length;
-            calculateLineColumn(text, typedefEnumPattern.pos(2), enumTypeSymbol.startLine, enumTypeSymbol.startColumn);
-            enumTypeSymbol.endLine = enumTypeSymbol.startLine;
-            enumTypeSymbol.endColumn = enumTypeSymbol.startColumn + typeName.length();
-            addSymbol(enumTypeSymbol);
-            symbolsFound++;
-
-            // 解析枚举值
-            QStringList valueList = enumValues.split(',', QString::SkipEmptyParts);
-            for (const QString &value : valueList) {
-                QString cleanValue = value.trimmed();
-                int assignPos = cleanValue.indexOf('=');
-                if (assignPos >= 0) {
-                    cleanValue = cleanValue.left(assignPos).trimmed();
-                }
-
-                if (!cleanValue.isEmpty()) {
-                    SymbolInfo enumValueSymbol;
-                    enumValueSymbol.fileName = currentFileName;
-                    enumValueSymbol.symbolName = cleanValue;
-                    enumValueSymbol.symbolType = sym_enum_value;
-                    enumValueSymbol.position = match.position;
-                    enumValueSymbol.length = cleanValue.length();
-                    // 关联到枚举类型
-                    enumValueSymbol.moduleScope = typeName;  // 使用moduleScope存储所属枚举类型
-                    calculateLineColumn(text, match.position, enumValueSymbol.startLine, enumValueSymbol.startColumn);
-                    enumValueSymbol.endLine = enumValueSymbol.startLine;
-                    enumValueSymbol.endColumn = enumValueSymbol.startColumn + cleanValue.length();
-                    addSymbol(enumValueSymbol);
-                    symbolsFound++;
-                }
-            }
+// 主线程：合并一批解析结果，只发布一次快照
+QStringList sym_list::mergeParsedFiles(const QList<ParsedFile>& files, const ParseContext& context)
+{
+    QStringList skippedFiles;
+    beginBatch();
+
+    for (const ParsedFile& file : files) {
+        if (!file.shard) {
+            continue;
         }
-    }
 
-    // 3. 枚举变量声明: enum_name_t variable_name;
-    QRegExp enumVarPattern("\\b([a-zA-Z_][a-zA-Z0-9_]*)\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*[;,]");
-    // 这个需要结合类型信息来判断是否为枚举变量，在后续处理中完善
-
-    // ===== 结构体分析 =====
-
-    // 1. Packed struct: typedef struct packed { members } struct_name_t;
-    QRegExp packedStructPattern("\\btypedef\\s+struct\\s+packed\\s*\\{([^}]+)\\}\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> packedStructMatches = findMatchesOutsideComments(text, packedStructPattern);
-
-    for (const RegexMatch &match : qAsConst(packedStructMatches)) {
-        if (packedStructPattern.indexIn(text, match.position) != -1) {
-            QString structMembers = packedStructPattern.cap(1);
-            QString structName = packedStructPattern.cap(2);
-
-            // 添加结构体类型定义
-            SymbolInfo structTypeSymbol;
-            structTypeSymbol.fileName = currentFileName;
-            structTypeSymbol.symbolName = structName;
-            structTypeSymbol.symbolType = sym_packed_struct;
-            structTypeSymbol.position = match.position;
-            structTypeSymbol.length = match.length;
-            calculateLineColumn(text, packedStructPattern.pos(2), structTypeSymbol.startLine, structTypeSymbol.startColumn);
-            structTypeSymbol.endLine = structTypeSymbol.startLine;
-            structTypeSymbol.endColumn = structTypeSymbol.startColumn + structName.length();
-            addSymbol(structTypeSymbol);
-            symbolsFound++;
-
-            // 解析结构体成员
-            analyzeStructMembers(structMembers, structName, match.position, text);
+        // 🔧 FIX: 工作线程解析的是磁盘内容；期间编辑器已装入更新的分片时保留后者
+        if (fileRevision(file.fileName) != context.fileRevisions.value(file.fileName, 0)) {
+            skippedFiles.append(file.fileName);
+            continue;
         }
-    }
 
-    // 2. Unpacked struct: typedef struct { members } struct_name_t;
-    QRegExp unpackedStructPattern("\\btypedef\\s+struct\\s*\\{([^}]+)\\}\\s*([a-zA-Z_][a-zA-Z0-9_]*)");
-    QList<RegexMatch> unpackedStructMatches = findMatchesOutsideComments(text, unpackedStructPattern);
-
-    for (const RegexMatch &match : qAsConst(unpackedStructMatches)) {
-        if (unpackedStructPattern.indexIn(text, match.position) != -1) {
-            QString structMembers = unpackedStructPattern.cap(1);
-            QString structName = unpackedStructPattern.cap(2);
-
-            // 添加结构体类型定义
-            SymbolInfo structTypeSymbol;
-            structTypeSymbol.fileName = currentFileName;
-            structTypeSymbol.symbolName = structName;
-            structTypeSymbol.symbolType = sym_unpacked_struct;
-            structTypeSymbol.position = match.position;
-            structTypeSymbol.length = match.length;
-            calculateLineColumn(text, unpackedStructPattern.pos(2), structTypeSymbol.startLine, structTypeSymbol.startColumn);
-            structTypeSymbol.endLine = structTypeSymbol.startLine;
-            structTypeSymbol.endColumn = structTypeSymbol.startColumn + structName.length();
-            addSymbol(structTypeSymbol);
-            symbolsFound++;
-
-            // 解析结构体成员
-            analyzeStructMembers(structMembers, structName, match.position, text);
+        replaceShard(file.shard);
+        fileKnownTypeFingerprints.insert(file.fileName, file.knownTypesFingerprint);
+
+        FileState& state = fileStates[file.fileName];
+        state.contentHash = file.contentHash;
+        state.lastModified = QDateTime::currentDateTime();
+
+        // 从磁盘缓存恢复的文件没有行指纹，下一次变化时整文件重新解析，而不是行级diff
+        if (file.lineFingerprints.isEmpty()) {
+            state.needsFullAnalysis = true;
+            dropLineFingerprints(file.fileName);
+        } else {
+            state.needsFullAnalysis = false;
+            storeLineFingerprints(file.fileName, file.lineFingerprints);
         }
     }
 
-    // 3. 结构体变量声明分析
-    analyzeStructVariables(text);
+    commitBatch();
+    return skippedFiles;
+}
 
-    qDebug() << QString("Found %1 enum/struct symbols").arg(symbolsFound);
+// 新增：获取指定位置的模块作用域(作用域树二分查找)
+QString sym_list::getCurrentModuleScope(const SymbolShard& shard, int lineNumber) {
+    return shard.scopeTree().moduleAtLine(lineNumber);
 }
 
-// 新增：分析结构体成员的辅助方法
-void sym_list::analyzeStructMembers(const QString &membersText, const QString &structName,
-                                   int basePosition, const QString &fullText)
+int sym_list::findEndModuleLine(const SymbolShard &shard, const SymbolInfo &moduleSymbol)
 {
-    // 解析结构体成员
-    QStringList lines = membersText.split(';', QString::SkipEmptyParts);
-
-    for (const QString &line : lines) {
-        QString cleanLine = line.trimmed();
-        if (cleanLine.isEmpty()) continue;
-
-        // 基本成员模式: type member_name [array_size]
-        QRegExp memberPattern("\\b([a-zA-Z_][a-zA-Z0-9_]*)\\s+([a-zA-Z_][a-zA-Z0-9_]*)(?:\\s*\\[[^\\]]*\\])?");
-
-        if (memberPattern.indexIn(cleanLine) != -1) {
-            QString memberType = memberPattern.cap(1);
-            QString memberName = memberPattern.cap(2);
+    if (moduleSymbol.symbolType != sym_module) {
+        return -1;
+    }
 
-            SymbolInfo memberSymbol;
-            memberSymbol.fileName = currentFileName;
-            memberSymbol.symbolName = memberName;
-            memberSymbol.symbolType = sym_struct_member;
-            memberSymbol.position = basePosition;
-            memberSymbol.length = memberName.length();
-            memberSymbol.moduleScope = structName;  // 使用moduleScope存储所属结构体名称
-            calculateLineColumn(fullText, basePosition, memberSymbol.startLine, memberSymbol.startColumn);
-            memberSymbol.endLine = memberSymbol.startLine;
-            memberSymbol.endColumn = memberSymbol.startColumn + memberName.length();
-            addSymbol(memberSymbol);
-        }
+    const ScopeTree &spans = shard.scopeTree();
+    const int index = spans.spanStartingAt(moduleSymbol.position);
+    if (index < 0 || !spans.at(index).isClosed()) {
+        return -1; // endmodule not found
     }
+    return spans.at(index).endLine;
 }
 
-// 新增：分析结构体变量声明
-void sym_list::analyzeStructVariables(const QString &text)
+bool isSymbolInModule(const sym_list::SymbolInfo& symbol, const sym_list::SymbolInfo& module)
 {
-    // 获取所有已知的结构体类型
-    QSet<QString> structTypes;
-    for (const SymbolInfo &symbol : getAllSymbols()) {
-        if (symbol.symbolType == sym_packed_struct || symbol.symbolType == sym_unpacked_struct) {
-            structTypes.insert(symbol.symbolName);
-        }
+    if (symbol.fileName != module.fileName) {
+        return false;
     }
 
-    // 查找结构体变量声明
-    for (const QString &structType : structTypes) {
-        QString pattern = QString("\\b%1\\s+([a-zA-Z_][a-zA-Z0-9_]*)\\s*[;,]").arg(structType);
-        QRegExp structVarPattern(pattern);
-        QList<RegexMatch> structVarMatches = findMatchesOutsideComments(text, structVarPattern);
-
-        for (const RegexMatch &match : qAsConst(structVarMatches)) {
-            if (structVarPattern.indexIn(text, match.position) != -1) {
-                QString varName = structVarPattern.cap(1);
-
-                SymbolInfo varSymbol;
-                varSymbol.fileName = currentFileName;
-                varSymbol.symbolName = varName;
-                // 根据结构体类型确定变量类型
-                bool isPacked = false;
-                for (const SymbolInfo &symbol : getAllSymbols()) {
-                    if (symbol.symbolName == structType) {
-                        isPacked = (symbol.symbolType == sym_packed_struct);
-                        break;
-                    }
-                }
-                varSymbol.symbolType = isPacked ? sym_packed_struct_var : sym_unpacked_struct_var;
-                varSymbol.position = match.position;
-                varSymbol.length = match.length;
-                varSymbol.moduleScope = structType;  // 存储结构体类型名称
-                calculateLineColumn(text, structVarPattern.pos(1), varSymbol.startLine, varSymbol.startColumn);
-                varSymbol.endLine = varSymbol.startLine;
-                varSymbol.endColumn = varSymbol.startColumn + varName.length();
-                addSymbol(varSymbol);
-            }
+    // 模块区间取自作用域树(含 endmodule 位置)；文件尚未分析时退回按行比较
+    const ScopeTree scopes = sym_list::getInstance()->getScopeTree(module.fileName);
+    const int index = scopes.spanStartingAt(module.position);
+    if (index < 0 || !scopes.at(index).isModule()) {
+        return symbol.startLine > module.startLine;
+    }
+
+    const ScopeTree::Span& span = scopes.at(index);
+    return symbol.position > span.startPosition && symbol.position < span.endPosition;
+}
+
+QString getModuleNameContainingSymbol(const sym_list::SymbolInfo& symbol,
+                                     const QList<sym_list::SymbolInfo>& allSymbols)
+{
+    for (const sym_list::SymbolInfo& moduleSymbol : allSymbols) {
+        if (moduleSymbol.symbolType == sym_list::sym_module &&
+            isSymbolInModule(symbol, moduleSymbol)) {
+            return moduleSymbol.symbolName;
         }
     }
+    return QString(); // 没有找到包含的模块
 }
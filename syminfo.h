@@ -2,15 +2,28 @@
 #define SYMINFO_H
 
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <QHash>
 #include <QSet>
 #include <memory>
+#include <atomic>
 #include <QDateTime>
 
+#include "commentmask.h"
+#include "lineoffsettable.h"
+#include "scopetree.h"
+#include "linefingerprinttable.h"
+#include "atomtable.h"
+#include "snapshottables.h"
+
 class MainWindow;
 class MyCodeEditor;
+class QTextDocument;
+class QRegularExpression;
 class SymbolRelationshipEngine;
+class SymbolShard;
+class SymbolSnapshot;
 
 class sym_list{
 public:
@@ -109,6 +122,9 @@ public:
         int scopeLevel = 0;        // 作用域层级(0=全局, 1=模块内, 2=块内等)
     };
 
+    // 🚀 符号存储中的稳定句柄：低32位为槽位，高32位为槽位代数
+    typedef quint64 SymbolHandle;
+
     struct RegexMatch {
         sym_type_e sym_type;
         int position;
@@ -127,10 +143,10 @@ public:
         int endColumn;
     };
 
-    void addSymbol(const SymbolInfo& symbol);
     QList<SymbolInfo> findSymbolsByFileName(const QString& fileName);
     QList<SymbolInfo> findSymbolsByName(const QString& symbolName);
     QList<SymbolInfo> findSymbolsByType(sym_type_e symbolType);
+    QList<SymbolInfo> findSymbolsByTypeInScope(sym_type_e symbolType, const QString& moduleScope);
     QList<SymbolInfo> getAllSymbols();
     void clearSymbolsForFile(const QString& fileName);
 
@@ -139,7 +155,56 @@ public:
 
     QStringList getSymbolNamesByType(sym_type_e symbolType);
     QSet<QString> getUniqueSymbolNames();
+    QSet<AtomTable::Atom> getUniqueSymbolAtoms();
+
+    // 🚀 NEW: 原子键查询，不物化 SymbolInfo
+    int findSymbolIdByName(const QString& symbolName) const;     // 第一个同名符号，没有时返回 -1
+    QHash<AtomTable::Atom, AtomTable::Atom> getSymbolScopeAtoms() const;   // 符号名 -> 所属作用域
     int getSymbolCountByType(sym_type_e symbolType);
+    int getSymbolCount() const;
+
+    // 🚀 NEW: 文件分片(只读)。重新分析时整体替换，持有者看到的始终是一致的旧版本
+    std::shared_ptr<const SymbolShard> getFileShard(const QString& fileName) const;
+
+    // 🚀 NEW: 当前发布的只读快照，O(1)。一次请求内的多次查询应使用同一快照以保证一致；
+    // 上面的查询接口每次调用各自取最新快照
+    std::shared_ptr<const SymbolSnapshot> getSnapshot() const;
+
+    // 🚀 NEW: 并行索引
+    // parseContext() 在主线程取得；parseFileText() 不访问可变成员，可在工作线程并发调用；
+    // 各文件结果回到主线程后由 mergeParsedFiles() 一次发布
+    struct ParseContext {
+        QHash<QString, bool> structTypes;            // 已知struct类型名 -> 是否packed
+        QSet<QString> enumTypes;
+        quint64 knownTypesFingerprint = 0;           // 上面两个类型集合的摘要
+        QHash<QString, QString> contentHashes;       // 已分析文件 -> 内容哈希，未变化的文件跳过解析
+        QHash<QString, quint64> fileRevisions;       // 取得上下文时各文件分片的版本
+    };
+    struct ParsedFile {
+        QString fileName;
+        LineFingerprintTable lineFingerprints;       // 从磁盘缓存恢复时为空(未读取源文件)
+        QString contentHash;
+        quint64 knownTypesFingerprint = 0;           // 解析时所用已知类型集合的摘要
+        std::shared_ptr<SymbolShard> shard;          // 为空表示内容未变化，无需替换
+    };
+    ParseContext parseContext() const;
+    ParsedFile parseFileText(const QString& fileName, const QString& content, const ParseContext& context);
+    std::shared_ptr<SymbolShard> buildShard(const QString& fileName, const QList<SymbolInfo>& symbols,
+                                            const CommentMask& commentMask, const LineOffsetTable& lineOffsets,
+                                            const ScopeTree& scopeTree,
+                                            const QVector<int>& statementBoundaries);
+    // 取得 context 之后分片已被替换的文件(例如编辑器分析了未保存的内容)不合并，返回这些文件
+    QStringList mergeParsedFiles(const QList<ParsedFile>& files, const ParseContext& context);
+
+    // 🚀 NEW: 批量修改。beginBatch/commitBatch 之间替换/清除的分片不逐个发布快照、不逐个失效补全缓存，
+    // commitBatch 时发布一次快照、为变化的文件建立关系，并合并为一次缓存失效。可嵌套，最外层 commit 生效
+    void beginBatch();
+    void commitBatch();
+    bool isInBatch() const;
+
+    // 🚀 NEW: 清理失效的符号ID映射并压缩墓碑较多的分片，应在空闲时调用(不在编辑热路径上)
+    bool needsCompaction() const;
+    void compactStorage();
 
     SymbolRelationshipEngine* getRelationshipEngine() const;
     void setRelationshipEngine(SymbolRelationshipEngine* engine);
@@ -147,45 +212,137 @@ public:
     QList<CommentRegion> commentRegions;
 
     bool isPositionInComment(int position);
+    bool isPositionInComment(const QString &fileName, int position) const;
+    bool isPositionInString(int position) const;
+    CommentMask getCommentMask(const QString &fileName) const;
     bool isPositionInMultiLineComment(int pos);
     QList<CommentRegion> getCommentRegions() const;
-    QList<RegexMatch> findMatchesOutsideComments(const QString &text, const QRegExp &pattern);
-    void findVariableDeclarations();
+    QList<RegexMatch> findMatchesOutsideComments(const QString &text, const QRegularExpression &pattern);
 
     void setCodeEditorIncremental(MyCodeEditor* codeEditor);
-    bool needsAnalysis(const QString& fileName, const QString& content);
 
-private:
-    // Central symbol storage
-    QList<SymbolInfo> symbolDatabase;
+    // 🚀 NEW: 以文件名 + 文本内容分析，不依赖任何控件；setCodeEditor/setCodeEditorIncremental 只是取出编辑器文本后转调
+    void analyzeText(const QString& fileName, const QString& text);
+    void analyzeTextIncremental(const QString& fileName, const QString& content);
+
+    // 🚀 NEW: 编辑器 contentsChange(position, removed, added) 累积出的编辑区间(自上次分析以来)
+    // start 之前的文本不变；旧文本 [start, oldEnd) 被替换为新文本 [start, newEnd)，之后的文本只是平移
+    struct EditDelta {
+        int start = -1;
+        int oldEnd = -1;
+        int newEnd = -1;
+
+        bool isEmpty() const { return start < 0; }
+        int lengthChange() const { return newEnd - oldEnd; }
+        void merge(int position, int charsRemoved, int charsAdded);
+        void clear() { start = oldEnd = newEnd = -1; }
+    };
+
+    // 只重新解析编辑区间扩展到语句边界后的文本块，之后的符号只平移坐标；
+    // 模块结构或类型定义变化等无法局部处理的情况返回false，由调用方整文件分析
+    bool applyEditDelta(const QString& fileName, const QTextDocument* document, const EditDelta& delta);
+
+    // 文件分片每次被替换时递增，编辑器据此判断自己的编辑区间是否仍以当前分片为基准；未分析过的文件为0
+    quint64 fileRevision(const QString& fileName) const;
+
+    // 当前已知struct/enum类型集合的摘要，以及文件分片解析时所用集合的摘要(未记录时为0)；
+    // 两者不同说明该文件中 "type_t var;" 形式的声明可能没有被识别
+    quint64 knownTypesFingerprint() const;
+    quint64 fileKnownTypesFingerprint(const QString& fileName) const;
 
-    QHash<sym_type_e, QList<int>> symbolTypeIndex;        // 类型 -> 数据库索引列表
-    QHash<QString, QList<int>> symbolNameIndex;          // 名称 -> 数据库索引列表
-    QHash<QString, QList<int>> fileNameIndex;            // 文件名 -> 数据库索引列表
-    QHash<int, int> symbolIdToIndex;                     // 🚀 NEW: symbolId -> 数据库索引映射
+    bool needsAnalysis(const QString& fileName, const QString& content) const;
+    // 当前分片所对应文本的内容哈希；局部编辑之后或未分析过时为空
+    QString analyzedContentHash(const QString& fileName) const;
+    static QString calculateContentHash(const QString& content);
 
-    mutable QHash<sym_type_e, QStringList> cachedSymbolNamesByType;
-    mutable QSet<QString> cachedUniqueNames;
-    mutable bool indexesDirty = false;
+    // 🚀 NEW: 增量分析缓存(各文件上次分析时的行指纹)的内存预算，单位字节。
+    // 超出预算时淘汰最久未分析的文件，被淘汰的文件下次变化时整文件重新解析
+    void setAnalysisCacheBudget(qint64 bytes);
+    qint64 analysisCacheBudget() const;
+    qint64 analysisCacheUsage() const;
+    int analysisCacheFileCount() const;
 
-    int nextSymbolId = 1;
-    int allocateSymbolId();
+    // 🚀 NEW: 文件的行首偏移表(最近一次分析时建立)，位置 -> 行/列 为二分查找
+    LineOffsetTable getLineOffsets(const QString &fileName) const;
+
+    // 🚀 NEW: 文件的作用域树(随声明解析一起建立)，位置/行 -> 所属模块/最内层作用域 为二分查找
+    ScopeTree getScopeTree(const QString &fileName) const;
+
+    // 🚀 NEW: position 处可见的符号：沿作用域树由内到外取各层直接声明的符号，O(log n + 深度 + 结果数)
+    QList<SymbolInfo> findVisibleSymbols(const QString &fileName, int position) const;
+
+private:
+    // 🚀 Central symbol storage: 每个文件一个只读分片(列式存储 + 本地索引 + 注释掩码 + 行偏移表)，
+    // 重新分析文件只替换该文件的分片。以下为写入方状态，读取一律经由已发布的快照
+    QHash<QString, std::shared_ptr<const SymbolShard>> fileShards;
+    SymbolOwnerTable symbolIdOwners;                     // symbolId -> 所属文件(分片替换后可能失效，压缩时重建)
+    int staleOwnerEntries = 0;
+    int totalSymbolCount = 0;
+
+    // 🚀 NEW: (作用域, 类型) 组合键 -> 含有该组合符号的文件，随分片替换增量维护；
+    // 按模块+类型查询时只访问这些分片，开销与模块大小成正比而不是与工作区大小成正比。
+    // 两张表都是分页共享的，发布快照不复制内容，之后的修改只复制被快照引用着的页
+    ScopeTypeFileTable scopeTypeFiles;
+    void indexShardScopes(const SymbolShard& shard);
+    void unindexShardScopes(const SymbolShard& shard);
+
+    // 🚀 NEW: 已发布快照，只通过 std::atomic_load/atomic_store 访问
+    std::shared_ptr<const SymbolSnapshot> currentSnapshot;
+    quint64 snapshotVersion = 0;
+    void publishSnapshot();
+
+    // 批量修改状态
+    enum CacheRefresh {
+        NoCacheRefresh,
+        InvalidateCaches,               // CompletionManager::invalidateSymbolCaches
+        ForceRefreshCaches              // CompletionManager::forceRefreshSymbolCaches
+    };
+    int batchDepth = 0;
+    bool batchSnapshotPending = false;
+    QStringList batchChangedFiles;
+    CacheRefresh pendingCacheRefresh = NoCacheRefresh;
+    void flushBatchSnapshot();
+    void notifySymbolsChanged(CacheRefresh refresh);
+
+    std::atomic<int> nextSymbolId{1};                    // 工作线程按文件整段预留ID
+    int reserveSymbolIds(int count);
 
     SymbolRelationshipEngine* relationshipEngine = nullptr;
 
     static std::unique_ptr<sym_list> instance;
 
-    void getModuleName(const QString &text);
     void buildCommentRegions(const QString &text);
-    void findSingleLineComments(const QString &text);
-    void findMultiLineComments(const QString &text);
-    void calculateLineColumn(const QString &text, int position, int &line, int &column);
+    void calculateLineColumn(int position, int &line, int &column);
+    void buildLineOffsets(const QString &text);
     bool isMatchInComment(int matchStart, int matchLength);
 
     QString currentFileName;
 
-    void getVariableDeclarations(const QString &text);
-    void getTasksAndFunctions(const QString &text);
+    LineOffsetTable currentLineOffsets;                  // 当前分析文本的行偏移表
+
+    CommentMask currentCommentMask;                      // 当前分析文本的注释/字符串掩码
+
+    ScopeTree currentScopeTree;                          // 当前分析文本的作用域树(parseDeclarations 时建立)
+    QVector<int> currentStatementBoundaries;             // 当前分析文本的语句边界(同上)
+
+    QHash<QString, quint64> fileRevisions;
+    quint64 revisionCounter = 0;
+
+    // 解析时已知的struct/enum类型；"type_t var;" 的识别依赖它们
+    struct KnownTypes {
+        QHash<QString, bool> structTypes;            // 类型名 -> 是否packed
+        QSet<QString> enumTypes;
+
+        quint64 fingerprint() const;                 // 与顺序无关的64位摘要，只用于比较类型集合是否变化
+    };
+    KnownTypes knownTypes() const;
+
+    // 各文件最近一次解析时已知类型的摘要；类型集合变化后局部重新解析的结果与整文件解析不一致。
+    // 只存摘要，不为每个文件复制一份全局类型表
+    QHash<QString, quint64> fileKnownTypeFingerprints;
+
+    // 🚀 单遍词法/声明解析 (SVDeclarationParser)，取代按符号种类的逐个正则扫描；同时更新 currentScopeTree
+    QList<SymbolInfo> parseDeclarations(const QString &text);
 
     // File state tracking
     struct FileState {
@@ -195,50 +352,50 @@ private:
     };
     QHash<QString, FileState> fileStates;
 
-    // Line-based symbol mapping
-    QHash<QString, QHash<int, QList<SymbolInfo>>> lineBasedSymbols; // fileName -> line -> symbols
-
-    QString calculateContentHash(const QString& content);
-    QList<int> detectChangedLines(const QString& fileName, const QString& newContent);
-    void clearSymbolsForLines(const QString& fileName, const QList<int>& lines);
-    void analyzeSpecificLines(const QString& fileName, const QString& content, const QList<int>& lines);
-    void updateLineBasedSymbols(const SymbolInfo& symbol);
-
-    // Cache file content for line-level comparison
-    QHash<QString, QString> previousFileContents;
-
-    // Line-level analysis helper methods
-    void analyzeModulesInLine(const QString& lineText, int lineStartPos, int lineNum);
-    void analyzeVariablesInLine(const QString& lineText, int lineStartPos, int lineNum);
-    void analyzeTasksFunctionsInLine(const QString& lineText, int lineStartPos, int lineNum);
-    void analyzeVariablePattern(const QString& lineText, int lineStartPos, int lineNum,
-                                const QRegExp& pattern, sym_type_e symbolType);
-    void analyzeTaskFunctionPattern(const QString& lineText, int lineStartPos, int lineNum,
-                                    const QRegExp& pattern, sym_type_e symbolType);
-
-    void rebuildAllIndexes();
-    void addToIndexes(int symbolIndex);
-    void removeFromIndexes(int symbolIndex);
-    void invalidateCache();
-    void updateCachedData() const;
+    // 🚀 NEW: 上次分析时每行的64位指纹，替代缓存整个文件内容做逐行下标比较；
+    // 按最近使用排序，总大小受 analysisCacheBudgetBytes 约束
+    struct CachedFingerprints {
+        LineFingerprintTable table;
+        qint64 bytes = 0;           // 存入时计入 analysisCacheBytes 的大小
+        quint64 lastUse = 0;
+    };
+    QHash<QString, CachedFingerprints> fileLineFingerprints;
+    qint64 analysisCacheBudgetBytes = 32 * 1024 * 1024;
+    qint64 analysisCacheBytes = 0;
+    quint64 fingerprintUseCounter = 0;
+
+    void storeLineFingerprints(const QString& fileName, const LineFingerprintTable& fingerprints);
+    void dropLineFingerprints(const QString& fileName);
+    void trimAnalysisCache();
+    static qint64 cacheEntrySize(const QString& fileName, const LineFingerprintTable& fingerprints);
+
+    // 🚀 NEW: 局部重新解析。编辑区间先扩展到语句边界(planEdit)，
+    // 再把区间内的新文本解析后拼接进分片，区间外的符号与各表只平移(spliceEdit)
+    struct EditRegion {
+        int regionStart = 0;        // 语句边界，旧坐标
+        int oldRegionEnd = 0;
+        int newRegionEnd = 0;
+        int lengthChange = 0;
+        int firstLine = 0;          // regionStart 所在行
+        int lineStart = 0;          // 该行行首，片段从这里读起
+        bool reachesEnd = false;    // 区间之后没有语句边界
+    };
+    bool planEdit(const SymbolShard& shard, const EditDelta& delta, int newLength, EditRegion& region) const;
+    bool spliceEdit(SymbolShard& shard, const EditRegion& region, QString fragment);
+    bool applyLineDiff(const QString& fileName, const QString& content, const LineFingerprintTable& fingerprints);
+
+    void addSymbols(SymbolShard& shard, const QList<SymbolInfo>& symbols);
+    std::shared_ptr<SymbolShard> createShard(const QString& fileName) const;
+    std::shared_ptr<SymbolShard> copyShard(const QString& fileName) const;
+    void replaceShard(std::shared_ptr<SymbolShard> shard);
+    void installShard(std::shared_ptr<SymbolShard> shard);
 
     void rebuildAllRelationships();
-    void buildSymbolRelationships(const QString& fileName);
-    void analyzeModuleContainment(const QString& fileName);
+    void analyzeModuleContainment(SymbolShard& shard);
     void analyzeVariableReferences(const QString& fileName, const QString& content);
 
-    void analyzeInterfaces(const QString &text);
-    void analyzeDataTypes(const QString &text);
-    void analyzePreprocessorDirectives(const QString &text);
-    void analyzeAlwaysAndAssign(const QString &text);
-    void analyzeParameters(const QString &text);
-    void analyzeConstraints(const QString &text);
-    void getAdditionalSymbols(const QString &text);
-    QString getCurrentModuleScope(const QString &fileName, int lineNumber);
-    int findEndModuleLine(const QString &fileName, const SymbolInfo &moduleSymbol);
-    void analyzeStructVariables(const QString &text);
-    void analyzeStructMembers(const QString &membersText, const QString &structName, int basePosition, const QString &fullText);
-    void analyzeEnumsAndStructs(const QString &text);
+    QString getCurrentModuleScope(const SymbolShard &shard, int lineNumber);
+    int findEndModuleLine(const SymbolShard &shard, const SymbolInfo &moduleSymbol);
 };
 
 // 🚀 NEW: 符号关系工具函数
@@ -0,0 +1,241 @@
+#include "textscanner.h"
+
+#include <QtAlgorithms>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTSCANNER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为 AVX2 函数单独打开指令集；MSVC 可直接使用内建函数
+#if defined(TEXTSCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TEXTSCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TEXTSCANNER_TARGET_AVX2
+#endif
+
+namespace {
+
+// 要查找的 1~3 个码元；未使用的槽位重复第一个，向量比较不用分支
+struct Needles {
+    ushort c[3];
+    int count;
+
+    Needles(ushort c1) : c{c1, c1, c1}, count(1) {}
+    Needles(ushort c1, ushort c2) : c{c1, c2, c1}, count(2) {}
+    Needles(ushort c1, ushort c2, ushort c3) : c{c1, c2, c3}, count(3) {}
+
+    bool matches(ushort unit) const
+    {
+        return unit == c[0] || unit == c[1] || unit == c[2];
+    }
+};
+
+typedef int (*FindFunction)(const ushort* data, int from, int size, const Needles& needles);
+typedef void (*CollectFunction)(const ushort* data, int size, ushort c, int base, QVector<int>& positions);
+
+int findScalar(const ushort* data, int from, int size, const Needles& needles)
+{
+    for (int i = from; i < size; ++i) {
+        if (needles.matches(data[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+void collectScalar(const ushort* data, int size, ushort c, int base, QVector<int>& positions)
+{
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == c) {
+            positions.append(base + i);
+        }
+    }
+}
+
+#ifdef TEXTSCANNER_X86
+
+// movemask_epi8 对每个匹配的16位码元给出相邻的两位，最低位序号除以2即码元下标；清掉最低两位进入下一个匹配
+inline void appendMaskPositions(quint32 mask, int offset, QVector<int>& positions)
+{
+    while (mask) {
+        positions.append(offset + int(qCountTrailingZeroBits(mask) >> 1));
+        mask &= mask - 1;
+        mask &= mask - 1;
+    }
+}
+
+inline __m128i matchSSE2(__m128i chunk, const __m128i* needles, int count)
+{
+    __m128i hits = _mm_cmpeq_epi16(chunk, needles[0]);
+    for (int n = 1; n < count; ++n) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi16(chunk, needles[n]));
+    }
+    return hits;
+}
+
+int findSSE2(const ushort* data, int from, int size, const Needles& needles)
+{
+    __m128i vectors[3];
+    for (int n = 0; n < needles.count; ++n) {
+        vectors[n] = _mm_set1_epi16(short(needles.c[n]));
+    }
+
+    int i = from;
+    for (; i + 8 <= size; i += 8) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const quint32 mask = quint32(_mm_movemask_epi8(matchSSE2(chunk, vectors, needles.count)));
+        if (mask) {
+            return i + int(qCountTrailingZeroBits(mask) >> 1);
+        }
+    }
+    return findScalar(data, i, size, needles);
+}
+
+void collectSSE2(const ushort* data, int size, ushort c, int base, QVector<int>& positions)
+{
+    const __m128i needle = _mm_set1_epi16(short(c));
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        appendMaskPositions(quint32(_mm_movemask_epi8(_mm_cmpeq_epi16(chunk, needle))), base + i, positions);
+    }
+    collectScalar(data + i, size - i, c, base + i, positions);
+}
+
+TEXTSCANNER_TARGET_AVX2
+int findAVX2(const ushort* data, int from, int size, const Needles& needles)
+{
+    __m256i vectors[3];
+    for (int n = 0; n < needles.count; ++n) {
+        vectors[n] = _mm256_set1_epi16(short(needles.c[n]));
+    }
+
+    int i = from;
+    for (; i + 16 <= size; i += 16) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_cmpeq_epi16(chunk, vectors[0]);
+        for (int n = 1; n < needles.count; ++n) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi16(chunk, vectors[n]));
+        }
+        const quint32 mask = quint32(_mm256_movemask_epi8(hits));
+        if (mask) {
+            return i + int(qCountTrailingZeroBits(mask) >> 1);
+        }
+    }
+    return findSSE2(data, i, size, needles);
+}
+
+TEXTSCANNER_TARGET_AVX2
+void collectAVX2(const ushort* data, int size, ushort c, int base, QVector<int>& positions)
+{
+    const __m256i needle = _mm256_set1_epi16(short(c));
+
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        appendMaskPositions(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi16(chunk, needle))), base + i, positions);
+    }
+    collectSSE2(data + i, size - i, c, base + i, positions);
+}
+
+bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // 还要确认操作系统会保存 YMM 寄存器
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // TEXTSCANNER_X86
+
+struct Dispatch {
+    TextScanner::Implementation implementation;
+    FindFunction find;
+    CollectFunction collect;
+};
+
+Dispatch selectImplementation()
+{
+#ifdef TEXTSCANNER_X86
+    if (cpuHasAVX2()) {
+        return { TextScanner::AVX2, findAVX2, collectAVX2 };
+    }
+    return { TextScanner::SSE2, findSSE2, collectSSE2 };
+#else
+    return { TextScanner::Scalar, findScalar, collectScalar };
+#endif
+}
+
+// 首次使用时选定，之后只读
+const Dispatch& dispatch()
+{
+    static const Dispatch selected = selectImplementation();
+    return selected;
+}
+
+inline const ushort* units(const QChar* data)
+{
+    return reinterpret_cast<const ushort*>(data);
+}
+
+} // namespace
+
+TextScanner::Implementation TextScanner::implementation()
+{
+    return dispatch().implementation;
+}
+
+int TextScanner::indexOf(const QChar* data, int from, int size, ushort c)
+{
+    if (from >= size) {
+        return size;
+    }
+    return dispatch().find(units(data), from, size, Needles(c));
+}
+
+int TextScanner::indexOfAny(const QChar* data, int from, int size, ushort c1, ushort c2)
+{
+    if (from >= size) {
+        return size;
+    }
+    return dispatch().find(units(data), from, size, Needles(c1, c2));
+}
+
+int TextScanner::indexOfAny(const QChar* data, int from, int size, ushort c1, ushort c2, ushort c3)
+{
+    if (from >= size) {
+        return size;
+    }
+    return dispatch().find(units(data), from, size, Needles(c1, c2, c3));
+}
+
+void TextScanner::appendPositions(const QChar* data, int size, ushort c, int base, QVector<int>& positions)
+{
+    if (size <= 0) {
+        return;
+    }
+    dispatch().collect(units(data), size, c, base, positions);
+}
@@ -0,0 +1,336 @@
+#include "workspaceindexer.h"
+#include "symbolshard.h"
+#include "symbolsnapshot.h"
+#include <QFile>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QMutexLocker>
+
+// 一个文件一个任务，任务本身不持有状态，结果交回索引器
+class WorkspaceIndexer::IndexTask : public QRunnable
+{
+public:
+    IndexTask(WorkspaceIndexer* indexer, const QString& filePath)
+        : indexer(indexer), filePath(filePath) {}
+
+    void run() override
+    {
+        indexer->runTask(filePath);
+    }
+
+private:
+    WorkspaceIndexer* indexer;
+    QString filePath;
+};
+
+// 缓存写入只读快照，不占用主线程
+class WorkspaceIndexer::SaveCacheTask : public QRunnable
+{
+public:
+    SaveCacheTask(const QString& cachePath, const QHash<QString, SymbolIndexCache::FileStamp>& stamps,
+                  std::shared_ptr<const SymbolSnapshot> snapshot)
+        : cachePath(cachePath), stamps(stamps), snapshot(std::move(snapshot)) {}
+
+    void run() override
+    {
+        SymbolIndexCache::save(cachePath, stamps, *snapshot);
+    }
+
+private:
+    QString cachePath;
+    QHash<QString, SymbolIndexCache::FileStamp> stamps;
+    std::shared_ptr<const SymbolSnapshot> snapshot;
+};
+
+WorkspaceIndexer::WorkspaceIndexer(QObject *parent)
+    : QObject(parent)
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+
+    // 工作线程只发信号，合并总在主线程进行
+    connect(this, &WorkspaceIndexer::resultsReady,
+            this, &WorkspaceIndexer::mergePendingResults, Qt::QueuedConnection);
+}
+
+WorkspaceIndexer::~WorkspaceIndexer()
+{
+    cancelled = true;
+    pool.clear();
+    pool.waitForDone();
+}
+
+void WorkspaceIndexer::start(const QStringList& files, const QString& cacheFilePath)
+{
+    // 🔧 FIX: 重新开始前等待上一轮的任务退出，丢弃其未合并的结果，避免两轮结果交错
+    if (running) {
+        cancelled = true;
+        pool.clear();
+        pool.waitForDone();
+
+        QMutexLocker locker(&resultMutex);
+        pendingResults.clear();
+        mergeQueued = false;
+    }
+
+    // 上一轮的缓存写入也要先完成，才能重新映射缓存文件
+    pool.waitForDone();
+
+    context = sym_list::getInstance()->parseContext();
+    cachePath = cacheFilePath;
+    cache.open(cachePath);
+    indexedStamps.clear();
+    cacheMisses = 0;
+    reparsingKnownTypes = false;
+
+    cancelled = false;
+    running = true;
+    fileCount = files.size();
+    processedCount = 0;
+
+    if (files.isEmpty()) {
+        running = false;
+        cache.close();
+        emit finished(0, 0, false);
+        return;
+    }
+
+    submitTasks(files);
+}
+
+void WorkspaceIndexer::submitTasks(const QStringList& files)
+{
+    for (const QString& filePath : files) {
+        IndexTask* task = new IndexTask(this, filePath);
+        task->setAutoDelete(true);
+        pool.start(task);
+    }
+}
+
+// 🔧 FIX: 各工作线程只能按开始时已知的类型解析，首次打开工作区时其他文件中的 typedef struct/enum 尚未登记，
+// "type_t var;" 形式的声明会被漏掉。全部合并后类型集合已经完整(typedef 本身的识别不依赖已知类型)，
+// 对解析时类型摘要与最终摘要不同的文件按最终类型再解析一轮；磁盘内容与内存不同的文件(编辑器中未保存)不动
+bool WorkspaceIndexer::startKnownTypesPass()
+{
+    const sym_list* symbols = sym_list::getInstance();
+    context = symbols->parseContext();
+
+    QStringList staleFiles;
+    for (auto it = indexedStamps.constBegin(); it != indexedStamps.constEnd(); ++it) {
+        const QString& filePath = it.key();
+        if (it.value().contentHash.isEmpty() || context.contentHashes.value(filePath) != it.value().contentHash) {
+            continue;
+        }
+        if (symbols->fileKnownTypesFingerprint(filePath) != context.knownTypesFingerprint) {
+            staleFiles.append(filePath);
+        }
+    }
+
+    if (staleFiles.isEmpty()) {
+        return false;
+    }
+
+    // 内容未变也必须重新解析
+    for (const QString& filePath : qAsConst(staleFiles)) {
+        context.contentHashes.remove(filePath);
+    }
+
+    reparsingKnownTypes = true;
+    fileCount += staleFiles.size();
+    submitTasks(staleFiles);
+    return true;
+}
+
+void WorkspaceIndexer::cancel()
+{
+    if (!running) {
+        return;
+    }
+
+    // 尚未开始的任务从队列中移除，正在运行的任务读完当前文件后丢弃结果
+    cancelled = true;
+    pool.clear();
+    pool.waitForDone();
+
+    running = false;
+    cache.close();
+    {
+        QMutexLocker locker(&resultMutex);
+        pendingResults.clear();
+        mergeQueued = false;
+    }
+    emit finished(indexedStamps.size(), indexedSymbolCount(), true);
+}
+
+// 工作线程
+void WorkspaceIndexer::runTask(const QString& filePath)
+{
+    TaskResult result;
+    result.file.fileName = filePath;
+
+    // 先取修改时间/大小再读文件：读的过程中文件被改写时，下次打开会按过期处理
+    result.stamp = SymbolIndexCache::stampOf(filePath);
+
+    if (!cancelled && result.stamp.size >= 0) {
+        QFile file(filePath);
+        if (file.open(QIODevice::ReadOnly | QFile::Text)) {
+            QTextStream in(&file);
+            const QString content = in.readAll();
+            file.close();
+
+            // 按最终类型集合补充解析时，缓存中的结果正是要替换的旧结果
+            result.cacheHit = !reparsingKnownTypes && restoreFromCache(filePath, content, result);
+
+            if (!result.cacheHit && !cancelled) {
+                result.file = sym_list::getInstance()->parseFileText(filePath, content, context);
+            }
+        }
+    }
+
+    result.stamp.contentHash = result.file.contentHash;
+    result.stamp.knownTypes = result.file.knownTypesFingerprint;
+    postResult(result);
+}
+
+bool WorkspaceIndexer::restoreFromCache(const QString& filePath, const QString& content, TaskResult& result) const
+{
+    SymbolIndexCache::FileStamp cached;
+    if (!cache.lookup(filePath, result.stamp, cached)) {
+        return false;
+    }
+
+    // 🔧 FIX: 修改时间精度内改写、或保留修改时间复制(cp -p/rsync -t/tar)且大小不变的文件，
+    // 只比修改时间/大小会一直恢复旧符号；读文件求哈希仍远比解析便宜
+    if (sym_list::calculateContentHash(content) != cached.contentHash) {
+        return false;
+    }
+
+    result.file.contentHash = cached.contentHash;
+    result.file.knownTypesFingerprint = cached.knownTypes;
+
+    // 内存中已经是同一内容(例如目录变化引起的重新扫描)，无需解码
+    if (context.contentHashes.value(filePath) == cached.contentHash) {
+        return true;
+    }
+
+    SymbolIndexCache::CachedFile cachedFile;
+    if (!cache.load(filePath, cachedFile)) {
+        result.file.contentHash.clear();
+        return false;
+    }
+
+    result.file.shard = sym_list::getInstance()->buildShard(filePath, cachedFile.symbols,
+                                                           cachedFile.commentMask,
+                                                           cachedFile.lineOffsets,
+                                                           cachedFile.scopeTree,
+                                                           cachedFile.statementBoundaries);
+    return true;
+}
+
+void WorkspaceIndexer::postResult(const TaskResult& result)
+{
+    bool notify = false;
+    {
+        QMutexLocker locker(&resultMutex);
+        pendingResults.append(result);
+        if (!mergeQueued) {
+            mergeQueued = true;
+            notify = true;
+        }
+    }
+
+    // 主线程尚未处理上一次通知时不重复投递，合并时会一并取走
+    if (notify) {
+        emit resultsReady();
+    }
+}
+
+// 主线程
+void WorkspaceIndexer::mergePendingResults()
+{
+    QList<TaskResult> batch;
+    {
+        QMutexLocker locker(&resultMutex);
+        batch.swap(pendingResults);
+        mergeQueued = false;
+    }
+
+    if (!running || batch.isEmpty()) {
+        return;
+    }
+
+    QList<sym_list::ParsedFile> parsedFiles;
+    parsedFiles.reserve(batch.size());
+    for (const TaskResult& result : qAsConst(batch)) {
+        parsedFiles.append(result.file);
+    }
+
+    const QStringList skippedFiles = sym_list::getInstance()->mergeParsedFiles(parsedFiles, context);
+
+    for (const TaskResult& result : qAsConst(batch)) {
+        if (!result.cacheHit) {
+            cacheMisses++;
+        }
+        // 内存中是编辑器的新内容，这份磁盘解析结果不写入缓存
+        if (skippedFiles.contains(result.file.fileName)) {
+            indexedStamps.remove(result.file.fileName);
+        } else {
+            indexedStamps.insert(result.file.fileName, result.stamp);
+        }
+    }
+
+    processedCount += batch.size();
+    emit progressChanged(processedCount, fileCount, QFileInfo(batch.last().file.fileName).fileName());
+
+    if (processedCount >= fileCount) {
+        if (!reparsingKnownTypes && !cancelled && startKnownTypesPass()) {
+            return;
+        }
+        running = false;
+        saveCache();
+        emit finished(indexedStamps.size(), indexedSymbolCount(), false);
+    }
+}
+
+// 本轮索引的文件在当前快照中的符号总数(第二轮替换的分片不重复计数)
+int WorkspaceIndexer::indexedSymbolCount() const
+{
+    const std::shared_ptr<const SymbolSnapshot> snapshot = sym_list::getInstance()->getSnapshot();
+    int count = 0;
+    for (auto it = indexedStamps.constBegin(); it != indexedStamps.constEnd(); ++it) {
+        if (auto shard = snapshot->fileShard(it.key())) {
+            count += shard->symbolCount();
+        }
+    }
+    return count;
+}
+
+void WorkspaceIndexer::saveCache()
+{
+    // 🔧 FIX: 打开的文件在快照中可能是编辑器未保存的内容，与磁盘的修改时间/大小不对应；
+    // 只写入内存内容哈希与磁盘内容哈希一致的分片，类型摘要取分片实际解析时的值
+    const sym_list* symbols = sym_list::getInstance();
+    QHash<QString, SymbolIndexCache::FileStamp> stamps;
+    for (auto it = indexedStamps.constBegin(); it != indexedStamps.constEnd(); ++it) {
+        const QString& filePath = it.key();
+        if (it.value().contentHash.isEmpty() || symbols->analyzedContentHash(filePath) != it.value().contentHash) {
+            continue;
+        }
+        SymbolIndexCache::FileStamp stamp = it.value();
+        stamp.knownTypes = symbols->fileKnownTypesFingerprint(filePath);
+        stamps.insert(filePath, stamp);
+    }
+
+    // 缓存里的文件集合与本轮一致且全部命中时无需重写
+    const bool upToDate = cacheMisses == 0 && cache.entryCount() == stamps.size();
+    cache.close();
+
+    if (cachePath.isEmpty() || upToDate) {
+        return;
+    }
+
+    SaveCacheTask* task = new SaveCacheTask(cachePath, stamps, symbols->getSnapshot());
+    task->setAutoDelete(true);
+    pool.start(task);
+}
@@ -0,0 +1,87 @@
+#ifndef WORKSPACEINDEXER_H
+#define WORKSPACEINDEXER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QList>
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
+
+#include "syminfo.h"
+#include "symbolindexcache.h"
+
+// 🚀 并行工作区索引
+// 每个文件一个任务：工作线程读文件并调用 sym_list::parseFileText() 生成新分片，
+// 结果放入队列后通过排队连接通知主线程；主线程按批 mergeParsedFiles()，一批只发布一次快照。
+// 开始之后分片被编辑器替换过的文件不合并，保留编辑器的结果。
+// 全部合并后，解析时已知类型与最终类型集合不一致的文件再按最终类型解析一轮。
+// 线程池大小为CPU核数；cancel() 之后尚未开始的任务直接跳过，已完成的结果照常合并。
+// 🚀 NEW: 指定缓存文件时，修改时间/大小/内容哈希与磁盘缓存一致的文件直接从缓存恢复，不重新解析；
+// 本轮有文件重新解析时，完成后在线程池上把当前快照写回缓存。
+class WorkspaceIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WorkspaceIndexer(QObject *parent = nullptr);
+    ~WorkspaceIndexer();
+
+    void start(const QStringList& files, const QString& cacheFilePath = QString());
+    void cancel();
+    bool isRunning() const { return running; }
+
+    int totalFiles() const { return fileCount; }
+    int processedFiles() const { return processedCount; }
+
+signals:
+    void progressChanged(int processedFiles, int totalFiles, const QString& currentFile);
+    void finished(int filesIndexed, int symbolsFound, bool cancelled);
+
+    // 内部使用：工作线程 -> 主线程
+    void resultsReady();
+
+private slots:
+    void mergePendingResults();
+
+private:
+    class IndexTask;
+    class SaveCacheTask;
+
+    struct TaskResult {
+        sym_list::ParsedFile file;
+        SymbolIndexCache::FileStamp stamp;
+        bool cacheHit = false;
+    };
+
+    QThreadPool pool;
+    sym_list::ParseContext context;
+
+    QMutex resultMutex;
+    QList<TaskResult> pendingResults;
+    bool mergeQueued = false;
+
+    std::atomic<bool> cancelled{false};
+    bool running = false;
+    int fileCount = 0;
+    int processedCount = 0;
+
+    // 磁盘缓存：open() 之后在工作线程中只读
+    SymbolIndexCache cache;
+    QString cachePath;
+    QHash<QString, SymbolIndexCache::FileStamp> indexedStamps;
+    int cacheMisses = 0;
+
+    // 第二轮：按最终类型集合重新解析，不使用缓存。只在线程池空闲时由主线程修改
+    bool reparsingKnownTypes = false;
+
+    void submitTasks(const QStringList& files);
+    bool startKnownTypesPass();
+    void runTask(const QString& filePath);
+    bool restoreFromCache(const QString& filePath, const QString& content, TaskResult& result) const;
+    void postResult(const TaskResult& result);
+    void saveCache();
+    int indexedSymbolCount() const;
+};
+
+#endif // WORKSPACEINDEXER_H